@@ -478,12 +478,18 @@ MLN_CORE_SOURCE = [
     "src/mbgl/text/quads.hpp",
     "src/mbgl/text/shaping.cpp",
     "src/mbgl/text/shaping.hpp",
+    "src/mbgl/text/shaping_cache.cpp",
+    "src/mbgl/text/shaping_cache.hpp",
     "src/mbgl/text/tagged_string.cpp",
     "src/mbgl/text/tagged_string.hpp",
     "src/mbgl/text/harfbuzz.cpp",
     "src/mbgl/text/harfbuzz.hpp",
+    "src/mbgl/tile/columnar_filter.cpp",
+    "src/mbgl/tile/columnar_filter.hpp",
     "src/mbgl/tile/custom_geometry_tile.cpp",
     "src/mbgl/tile/custom_geometry_tile.hpp",
+    "src/mbgl/tile/feature_decode_cache.cpp",
+    "src/mbgl/tile/feature_decode_cache.hpp",
     "src/mbgl/tile/geojson_tile.cpp",
     "src/mbgl/tile/geojson_tile.hpp",
     "src/mbgl/tile/geojson_tile_data.hpp",
@@ -493,6 +499,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/tile/geometry_tile_data.hpp",
     "src/mbgl/tile/geometry_tile_worker.cpp",
     "src/mbgl/tile/geometry_tile_worker.hpp",
+    "src/mbgl/tile/parsed_tile_cache.cpp",
+    "src/mbgl/tile/parsed_tile_cache.hpp",
     "src/mbgl/tile/raster_dem_tile.cpp",
     "src/mbgl/tile/raster_dem_tile.hpp",
     "src/mbgl/tile/raster_dem_tile_worker.cpp",
@@ -567,6 +575,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/util/mat4.hpp",
     "src/mbgl/util/math.hpp",
     "src/mbgl/util/padding.cpp",
+    "src/mbgl/util/parallel_for.cpp",
+    "src/mbgl/util/parallel_for.hpp",
     "src/mbgl/util/premultiply.cpp",
     "src/mbgl/util/quaternion.cpp",
     "src/mbgl/util/quaternion.hpp",
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/image.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr std::size_t markerCount = 20000;
+
+class AnnotationBenchmark {
+public:
+    AnnotationBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+
+        map.getStyle().loadJSON(R"STYLE({"version": 8, "sources": {}, "layers": []})STYLE");
+        map.jumpTo(CameraOptions().withCenter(LatLng{40.726989, -73.992857}).withZoom(12.0)); // Manhattan
+        map.addAnnotationImage(std::make_unique<style::Image>(
+            "default_marker", decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0f));
+
+        for (std::size_t i = 0; i < markerCount; ++i) {
+            ids.push_back(map.addAnnotation(SymbolAnnotation{randomPoint(), "default_marker"}));
+        }
+
+        frontend.render(map);
+    }
+
+    // Within a degree around the center, so most markers are in view
+    Point<double> randomPoint() {
+        std::uniform_real_distribution<double> offset(-0.5, 0.5);
+        return {-73.992857 + offset(generator), 40.726989 + offset(generator)};
+    }
+
+    util::RunLoop loop;
+    HeadlessFrontend frontend{{1000, 1000}, 1};
+    Map map{frontend,
+            MapObserver::nullObserver(),
+            MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize()),
+            ResourceOptions().withCachePath(":memory:").withAssetPath(".").withApiKey("foobar")};
+    std::vector<AnnotationID> ids;
+    std::mt19937 generator{42};
+};
+
+} // end namespace
+
+// Moves a few markers among many and renders a frame
+static void API_annotationMarkerChurn(::benchmark::State& state) {
+    AnnotationBenchmark bench;
+    std::uniform_int_distribution<std::size_t> marker(0, markerCount - 1);
+
+    while (state.KeepRunning()) {
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            bench.map.updateAnnotation(bench.ids[marker(bench.generator)],
+                                       SymbolAnnotation{bench.randomPoint(), "default_marker"});
+        }
+        bench.frontend.render(bench.map);
+    }
+}
+
+BENCHMARK(API_annotationMarkerChurn)->Arg(1)->Arg(100)->Iterations(50);
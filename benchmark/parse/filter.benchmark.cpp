@@ -5,10 +5,51 @@
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion_impl.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/columnar_filter.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
 
+#include <array>
+
 using namespace mbgl;
 
+namespace {
+
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    explicit StubGeometryTileLayer(std::size_t count) {
+        const std::array<std::string, 8> classes = {
+            "motorway", "primary", "secondary", "tertiary", "residential", "service", "path", "track"};
+        features.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            features.emplace_back(FeatureIdentifier(uint64_t(i)),
+                                  FeatureType::LineString,
+                                  GeometryCollection(),
+                                  PropertyMap{{"class", classes[i % classes.size()]}, {"rank", uint64_t(i % 10)}});
+        }
+    }
+
+    std::size_t featureCount() const override { return features.size(); }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(features[i]);
+    }
+
+    std::string getName() const override { return "roads"; }
+
+private:
+    std::vector<StubGeometryTileFeature> features;
+};
+
+constexpr const char* layerFilter = R"FILTER([
+    "all",
+    ["match", ["get", "class"], ["primary", "secondary", "residential"], true, false],
+    [">", ["get", "rank"], 3]
+])FILTER";
+constexpr std::size_t layerFeatureCount = 4096;
+
+} // namespace
+
 style::Filter parse(const char* expression) {
     style::conversion::Error error;
     return *style::conversion::convertJSON<style::Filter>(expression, error);
@@ -30,5 +71,49 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+static void Parse_EvaluateFilterLayer(benchmark::State& state) {
+    const style::Filter filter = parse(layerFilter);
+    const StubGeometryTileLayer layer(layerFeatureCount);
+    const CanonicalTileID canonical(14, 8192, 8192);
+
+    while (state.KeepRunning()) {
+        std::size_t selected = 0;
+        for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+            const auto feature = layer.getFeature(i);
+            auto context = style::expression::EvaluationContext(14.0f, feature.get());
+            selected += filter(context.withCanonicalTileID(&canonical));
+        }
+        benchmark::DoNotOptimize(selected);
+    }
+}
+
+// Includes decoding the columns, as for a source layer read by a single style layer
+static void Parse_EvaluateColumnarFilterLayer(benchmark::State& state) {
+    const auto filter = ColumnarFilter::compile(parse(layerFilter));
+    const StubGeometryTileLayer layer(layerFeatureCount);
+    const CanonicalTileID canonical(14, 8192, 8192);
+
+    while (state.KeepRunning()) {
+        FeatureColumns columns(layer);
+        benchmark::DoNotOptimize(filter->select(columns, 14.0f, canonical));
+    }
+}
+
+// Columns already decoded by another layer reading the same source layer
+static void Parse_EvaluateColumnarFilterLayerShared(benchmark::State& state) {
+    const auto filter = ColumnarFilter::compile(parse(layerFilter));
+    const StubGeometryTileLayer layer(layerFeatureCount);
+    const CanonicalTileID canonical(14, 8192, 8192);
+    FeatureColumns columns(layer);
+    filter->select(columns, 14.0f, canonical);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(filter->select(columns, 14.0f, canonical));
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterLayer);
+BENCHMARK(Parse_EvaluateColumnarFilterLayer);
+BENCHMARK(Parse_EvaluateColumnarFilterLayerShared);
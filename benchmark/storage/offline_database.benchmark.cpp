@@ -200,3 +200,29 @@ BENCHMARK_F(OfflineDatabase, ResizeDatabase)(benchmark::State& state) {
         }
     }
 }
+
+// Sustained panning: each iteration stores a new tile and reads back two recent ones, with the
+// ambient cache full so that writes evict. The argument is the write batch size.
+BENCHMARK_DEFINE_F(OfflineDatabase, PutGetMix)(benchmark::State& state) {
+    using namespace mbgl;
+
+    Log::setObserver(std::make_unique<Log::NullObserver>());
+    db.setMaximumAmbientCacheSize(50 * 1024 * 50);
+    db.setWriteBatchSize(static_cast<std::size_t>(state.range(0)));
+
+    auto tile = [](int64_t i) {
+        return Resource::tile("mapbox://PutGetMix" + util::toString(i), 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    };
+
+    int64_t i = 0;
+    while (state.KeepRunning()) {
+        db.put(tile(i), response);
+        benchmark::DoNotOptimize(db.get(tile(i / 2)));
+        benchmark::DoNotOptimize(db.get(tile(std::max<int64_t>(i - 10, 0))));
+        ++i;
+    }
+    db.flush();
+
+    Log::removeObserver();
+}
+BENCHMARK_REGISTER_F(OfflineDatabase, PutGetMix)->Arg(0)->Arg(16)->Arg(64);
@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/style/variable_anchor_offset_collection.hpp>
+#include <mbgl/text/cross_tile_symbol_index.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr uint8_t kMinZoom = 10;
+constexpr uint8_t kMaxZoom = 14;
+constexpr std::size_t kLabelCount = 20000;
+
+struct Label {
+    // World coordinates at kMaxZoom, in tile units
+    double x;
+    double y;
+    // The lowest zoom the label shows up at
+    uint8_t minZoom;
+    std::u16string key;
+};
+
+SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
+    const ShapedTextOrientations shaping{};
+    style::SymbolLayoutProperties::Evaluated layout;
+    IndexedSubfeature subfeature(0, {}, {}, 0);
+    Anchor anchor(x, y, 0, 0);
+    std::array<float, 2> offset{{0.0f, 0.0f}};
+    std::vector<AnchorOffsetPair> anchorOffsets = {{style::SymbolAnchorType::Center, offset}};
+    VariableAnchorOffsetCollection variableAnchorOffsets(std::move(anchorOffsets));
+    const auto placementType = style::SymbolPlacementType::Point;
+
+    auto sharedData = std::make_shared<SymbolInstanceSharedData>(GeometryCoordinates{},
+                                                                 shaping,
+                                                                 std::nullopt,
+                                                                 std::nullopt,
+                                                                 layout,
+                                                                 placementType,
+                                                                 offset,
+                                                                 ImageMap{},
+                                                                 0.0f,
+                                                                 SymbolContent::None,
+                                                                 false,
+                                                                 false);
+    return SymbolInstance(anchor,
+                          std::move(sharedData),
+                          shaping,
+                          std::nullopt,
+                          std::nullopt,
+                          0,
+                          0,
+                          placementType,
+                          offset,
+                          0,
+                          0,
+                          offset,
+                          subfeature,
+                          0,
+                          0,
+                          std::move(key),
+                          0.0f,
+                          0.0f,
+                          0.0f,
+                          variableAnchorOffsets,
+                          false);
+}
+
+// A city's worth of place and street names, more of them showing up the further in you zoom
+std::vector<Label> makeLabels() {
+    std::mt19937 generator(42);
+    const double worldSize = util::EXTENT * std::pow(2, kMaxZoom - kMinZoom) * 2;
+    std::uniform_real_distribution<double> coordinate(0, worldSize);
+    std::uniform_int_distribution<int> minZoom(kMinZoom, kMaxZoom);
+    std::uniform_int_distribution<int> name(0, 2000);
+
+    std::vector<Label> labels;
+    labels.reserve(kLabelCount);
+    for (std::size_t i = 0; i < kLabelCount; ++i) {
+        const auto text = "Street " + std::to_string(name(generator));
+        labels.push_back({coordinate(generator),
+                          coordinate(generator),
+                          static_cast<uint8_t>(minZoom(generator)),
+                          std::u16string(text.begin(), text.end())});
+    }
+    return labels;
+}
+
+struct PyramidTile {
+    OverscaledTileID id;
+    std::unique_ptr<SymbolBucket> bucket;
+};
+
+// Every tile of the 2x2 tiles at kMinZoom and their descendants, in the order a zoom in loads them
+std::vector<PyramidTile> makePyramid() {
+    const auto labels = makeLabels();
+    const Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+
+    std::vector<PyramidTile> tiles;
+    uint32_t bucketInstanceId = 0;
+    for (uint8_t z = kMinZoom; z <= kMaxZoom; ++z) {
+        const uint32_t dim = 2u << (z - kMinZoom);
+        const double tileSize = util::EXTENT * std::pow(2, kMaxZoom - z);
+        std::vector<std::vector<SymbolInstance>> instances(dim * dim);
+        for (const Label& label : labels) {
+            if (label.minZoom > z) {
+                continue;
+            }
+            const auto x = static_cast<uint32_t>(label.x / tileSize);
+            const auto y = static_cast<uint32_t>(label.y / tileSize);
+            const auto anchorX = static_cast<float>((label.x - x * tileSize) / tileSize * util::EXTENT);
+            const auto anchorY = static_cast<float>((label.y - y * tileSize) / tileSize * util::EXTENT);
+            instances[y * dim + x].push_back(makeSymbolInstance(anchorX, anchorY, label.key));
+        }
+
+        const uint32_t origin = (1u << z) / 2;
+        for (uint32_t i = 0; i < instances.size(); ++i) {
+            auto bucket = std::make_unique<SymbolBucket>(layout,
+                                                         std::map<std::string, Immutable<style::LayerProperties>>{},
+                                                         16.0f,
+                                                         1.0f,
+                                                         z,
+                                                         false,
+                                                         false,
+                                                         "labels",
+                                                         std::move(instances[i]),
+                                                         std::vector<SortKeyRange>{},
+                                                         1.0f,
+                                                         false,
+                                                         std::vector<style::TextWritingModeType>{},
+                                                         false);
+            bucket->bucketInstanceId = ++bucketInstanceId;
+            tiles.push_back({OverscaledTileID(z, 0, z, origin + i % dim, origin + i / dim), std::move(bucket)});
+        }
+    }
+    return tiles;
+}
+
+} // namespace
+
+// Matches the labels of every tile with the ones of their parents and children, as when zooming in from scratch
+static void CrossTileSymbolIndex_AddPyramid(benchmark::State& state) {
+    auto tiles = makePyramid();
+    std::size_t symbolCount = 0;
+    for (const auto& tile : tiles) {
+        symbolCount += tile.bucket->symbolInstances.size();
+    }
+
+    for (auto _ : state) {
+        uint32_t maxCrossTileID = 0;
+        CrossTileSymbolLayerIndex index(maxCrossTileID);
+        for (auto& tile : tiles) {
+            index.addBucket(tile.id, mat4{}, *tile.bucket);
+        }
+        benchmark::DoNotOptimize(maxCrossTileID);
+    }
+
+    state.SetItemsProcessed(state.iterations() * symbolCount);
+}
+
+BENCHMARK(CrossTileSymbolIndex_AddPyramid);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/image.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr double pixelRatio{1.0};
+constexpr Size size{1000, 1000};
+const LatLng center{40.726989, -73.992857}; // Manhattan
+
+// Labels scattered over the viewport, a dense tile's worth of places per 512 pixel tile
+FeatureCollection makeLabels(std::size_t count) {
+    std::mt19937 generator(42);
+    // The viewport spans about 0.043 degrees at zoom 15
+    std::uniform_real_distribution<double> latitude(center.latitude() - 0.017, center.latitude() + 0.017);
+    std::uniform_real_distribution<double> longitude(center.longitude() - 0.022, center.longitude() + 0.022);
+
+    FeatureCollection labels;
+    labels.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        labels.emplace_back(Point<double>{longitude(generator), latitude(generator)});
+    }
+    return labels;
+}
+
+} // namespace
+
+// Still images place every symbol again on each render, while tiles stay laid out. With
+// overlap allowed (second argument 1), labels skip the collision hit tests and the difference
+// is what testing them against each other costs.
+static void Placement_denseLabels(::benchmark::State& state) {
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+    util::RunLoop loop;
+    HeadlessFrontend frontend{size, pixelRatio};
+    Map map{frontend,
+            MapObserver::nullObserver(),
+            MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+            ResourceOptions().withCachePath("benchmark/fixtures/api/cache.db").withApiKey("foobar")};
+
+    auto& mapStyle = map.getStyle();
+    mapStyle.loadJSON(util::read_file("benchmark/fixtures/api/style.json"));
+    map.jumpTo(CameraOptions().withCenter(center).withZoom(15.0));
+    mapStyle.addImage(std::make_unique<style::Image>(
+        "test-icon", decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0f));
+
+    auto source = std::make_unique<style::GeoJSONSource>("labels");
+    source->setGeoJSON(makeLabels(static_cast<std::size_t>(state.range(0))));
+    mapStyle.addSource(std::move(source));
+
+    const bool allowOverlap = state.range(1) != 0;
+    auto layer = std::make_unique<style::SymbolLayer>("labels", "labels");
+    layer->setIconImage({"test-icon"});
+    layer->setTextField(style::expression::Formatted("Label"));
+    layer->setTextFont(std::vector<std::string>{"Noto Sans Regular"});
+    layer->setTextSize(12.0f);
+    layer->setIconAllowOverlap(allowOverlap);
+    layer->setTextAllowOverlap(allowOverlap);
+    mapStyle.addLayer(std::move(layer));
+
+    frontend.render(map);
+    for (auto _ : state) {
+        frontend.render(map);
+    }
+}
+
+BENCHMARK(Placement_denseLabels)
+    ->Args({2000, 0})
+    ->Args({2000, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(20);
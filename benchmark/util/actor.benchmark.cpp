@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr std::size_t kMessageCount = 100000;
+
+class Counter {
+public:
+    Counter(ActorRef<Counter>, std::size_t expected_, std::promise<void> done_)
+        : expected(expected_),
+          done(std::move(done_)) {}
+
+    void receive(std::size_t value) {
+        benchmark::DoNotOptimize(value);
+        if (++received == expected) {
+            done.set_value();
+        }
+    }
+
+private:
+    const std::size_t expected;
+    std::size_t received = 0;
+    std::promise<void> done;
+};
+
+} // namespace
+
+// Many threads sending to a single actor, like tile workers replying to the render thread
+static void Actor_ContendedSend(benchmark::State& state) {
+    const auto producers = static_cast<std::size_t>(state.range(0));
+    const std::size_t perProducer = kMessageCount / producers;
+    ThreadedScheduler scheduler(1);
+
+    for (auto _ : state) {
+        std::promise<void> done;
+        auto future = done.get_future();
+        Actor<Counter> counter(scheduler, perProducer * producers, std::move(done));
+        auto ref = counter.self();
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        threads.reserve(producers);
+        for (std::size_t i = 0; i < producers; ++i) {
+            threads.emplace_back([&go, ref, perProducer] {
+                while (!go) {
+                    std::this_thread::yield();
+                }
+                for (std::size_t j = 0; j < perProducer; ++j) {
+                    ref.invoke(&Counter::receive, j);
+                }
+            });
+        }
+
+        go = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        future.wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * perProducer * producers);
+}
+
+BENCHMARK(Actor_ContendedSend)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/grid_index.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<uint32_t>;
+
+// A viewport with the padding used by the collision index, and its cell size
+constexpr float kGridWidth = 1024 + 2 * 100;
+constexpr float kGridHeight = 768 + 2 * 100;
+constexpr uint32_t kCellSize = 25;
+
+struct Label {
+    std::vector<Grid::BBox> boxes;
+    std::vector<Grid::BCircle> circles;
+};
+
+// A dense labelled city: mostly point labels, and a third of line labels made of a few
+// dozen collision circles each.
+std::vector<Label> makeLabels(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> x(-50, kGridWidth + 50);
+    std::uniform_real_distribution<float> y(-50, kGridHeight + 50);
+    std::uniform_real_distribution<float> width(30, 140);
+    std::uniform_real_distribution<float> height(12, 22);
+    std::uniform_real_distribution<float> angle(0, 2 * M_PI);
+    std::uniform_int_distribution<int> circleCount(8, 30);
+
+    std::vector<Label> labels(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& label = labels[i];
+        const Grid::BBox::point_type anchor{x(generator), y(generator)};
+        if (i % 3 != 0) {
+            label.boxes.push_back({anchor, {anchor.x + width(generator), anchor.y + height(generator)}});
+        } else {
+            const float radius = height(generator) / 2;
+            const float direction = angle(generator);
+            const int circles = circleCount(generator);
+            for (int j = 0; j < circles; ++j) {
+                label.circles.push_back({{anchor.x + std::cos(direction) * radius * j,
+                                          anchor.y + std::sin(direction) * radius * j},
+                                         radius});
+            }
+        }
+    }
+    return labels;
+}
+
+const std::vector<Label>& denseLabels() {
+    static const auto labels = makeLabels(20000);
+    return labels;
+}
+
+} // namespace
+
+// Places labels the way the collision index does: hit test each against the ones placed so far, then insert
+static void GridIndex_DensePlacement(benchmark::State& state) {
+    const auto& labels = denseLabels();
+    const bool grouped = state.range(0) != 0;
+    // Labels of two sources that don't collide with each other
+    auto sameGroup = [&](uint32_t placed) {
+        return placed % 2 == 0;
+    };
+
+    std::size_t placedCount = 0;
+    for (auto _ : state) {
+        Grid grid(kGridWidth, kGridHeight, kCellSize);
+        placedCount = 0;
+        for (uint32_t i = 0; i < labels.size(); ++i) {
+            const auto& label = labels[i];
+            bool hit = false;
+            if (!label.boxes.empty()) {
+                hit = grouped ? grid.hitTest(label.boxes.front(), sameGroup) : grid.hitTest(label.boxes.front());
+            } else {
+                hit = grouped ? grid.hitTestAny(label.circles, sameGroup) : grid.hitTestAny(label.circles);
+            }
+            if (hit) {
+                continue;
+            }
+
+            for (const auto& box : label.boxes) {
+                grid.insert(uint32_t(i), box);
+            }
+            for (const auto& circle : label.circles) {
+                grid.insert(uint32_t(i), circle);
+            }
+            ++placedCount;
+        }
+        benchmark::DoNotOptimize(placedCount);
+    }
+
+    state.counters["placed"] = static_cast<double>(placedCount);
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+// Rendered feature queries against a full collision grid
+static void GridIndex_Query(benchmark::State& state) {
+    const auto& labels = denseLabels();
+    Grid grid(kGridWidth, kGridHeight, kCellSize);
+    for (uint32_t i = 0; i < labels.size(); ++i) {
+        for (const auto& box : labels[i].boxes) {
+            grid.insert(uint32_t(i), box);
+        }
+        for (const auto& circle : labels[i].circles) {
+            grid.insert(uint32_t(i), circle);
+        }
+    }
+
+    std::size_t results = 0;
+    for (auto _ : state) {
+        for (float y = 0; y < kGridHeight; y += 64) {
+            for (float x = 0; x < kGridWidth; x += 64) {
+                results += grid.query({{x, y}, {x + 32, y + 32}}).size();
+            }
+        }
+    }
+    benchmark::DoNotOptimize(results);
+}
+
+BENCHMARK(GridIndex_DensePlacement)->Arg(0)->Arg(1);
+BENCHMARK(GridIndex_Query);
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/thread_pool.hpp>
+
+#include <atomic>
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr std::size_t kTaskCount = 10000;
+
+// Roughly the size of a small parse step, enough to make the queueing overhead visible
+void busyWork(std::size_t seed) {
+    double value = static_cast<double>(seed);
+    for (int i = 0; i < 64; ++i) {
+        value = std::sqrt(value + i);
+    }
+    benchmark::DoNotOptimize(value);
+}
+
+// Schedules all tasks from outside the pool, like tiles being queued from the render thread
+void scheduleExternal(benchmark::State& state, SchedulerStrategy strategy) {
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    ThreadedScheduler pool(threads, strategy);
+    Scheduler& scheduler = pool;
+    const util::SimpleIdentity tag;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kTaskCount; ++i) {
+            scheduler.schedule(tag, [i] { busyWork(i); });
+        }
+        scheduler.waitForEmpty(tag);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+// Each task fans out into more tasks from inside the pool, like actors messaging each other
+void scheduleFanOut(benchmark::State& state, SchedulerStrategy strategy) {
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    ThreadedScheduler pool(threads, strategy);
+    Scheduler& scheduler = pool;
+    const util::SimpleIdentity tag;
+    constexpr std::size_t fanOut = 100;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < kTaskCount / fanOut; ++i) {
+            scheduler.schedule(tag, [&scheduler, tag, i] {
+                for (std::size_t j = 0; j < fanOut; ++j) {
+                    scheduler.schedule(tag, [i, j] { busyWork(i + j); });
+                }
+            });
+        }
+        scheduler.waitForEmpty(tag);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+} // namespace
+
+static void Scheduler_SharedQueue_External(benchmark::State& state) {
+    scheduleExternal(state, SchedulerStrategy::SharedQueue);
+}
+
+static void Scheduler_WorkStealing_External(benchmark::State& state) {
+    scheduleExternal(state, SchedulerStrategy::WorkStealing);
+}
+
+static void Scheduler_SharedQueue_FanOut(benchmark::State& state) {
+    scheduleFanOut(state, SchedulerStrategy::SharedQueue);
+}
+
+static void Scheduler_WorkStealing_FanOut(benchmark::State& state) {
+    scheduleFanOut(state, SchedulerStrategy::WorkStealing);
+}
+
+BENCHMARK(Scheduler_SharedQueue_External)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(Scheduler_WorkStealing_External)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(Scheduler_SharedQueue_FanOut)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(Scheduler_WorkStealing_FanOut)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
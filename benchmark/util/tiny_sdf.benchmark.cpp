@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr double kRadius = 8;
+constexpr double kCutoff = 0.25;
+// Rasterized glyphs are padded by this many pixels on each side
+constexpr uint32_t kBorder = 3;
+constexpr std::size_t kGlyphCount = 512;
+
+enum GlyphSet : int64_t {
+    Latin,
+    CJK
+};
+
+// Antialiased strokes between random points, standing in for the outlines of a font rasterized at 24px.
+// Latin glyphs are narrow and made of a few strokes, CJK ones take up the whole em square with many more.
+std::vector<AlphaImage> makeGlyphs(GlyphSet set) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint32_t> latinWidth(6, 18);
+    std::uniform_int_distribution<uint32_t> latinHeight(12, 24);
+    std::uniform_int_distribution<int> strokeCount(set == Latin ? 1 : 6, set == Latin ? 4 : 14);
+    std::uniform_real_distribution<float> thickness(0.8f, 1.8f);
+
+    std::vector<AlphaImage> glyphs;
+    glyphs.reserve(kGlyphCount);
+    for (std::size_t i = 0; i < kGlyphCount; ++i) {
+        const uint32_t width = (set == Latin ? latinWidth(generator) : 24) + 2 * kBorder;
+        const uint32_t height = (set == Latin ? latinHeight(generator) : 24) + 2 * kBorder;
+        AlphaImage glyph({width, height});
+        glyph.fill(0);
+
+        std::uniform_real_distribution<float> x(kBorder, static_cast<float>(width - kBorder));
+        std::uniform_real_distribution<float> y(kBorder, static_cast<float>(height - kBorder));
+        const int strokes = strokeCount(generator);
+        for (int s = 0; s < strokes; ++s) {
+            const float x0 = x(generator);
+            const float y0 = y(generator);
+            const float dx = x(generator) - x0;
+            const float dy = y(generator) - y0;
+            const float halfWidth = thickness(generator);
+            const float length2 = std::max(dx * dx + dy * dy, 1e-6f);
+            for (uint32_t py = 0; py < height; ++py) {
+                for (uint32_t px = 0; px < width; ++px) {
+                    const float t = std::clamp(((px - x0) * dx + (py - y0) * dy) / length2, 0.0f, 1.0f);
+                    const float distance = std::hypot(x0 + t * dx - px, y0 + t * dy - py);
+                    const float alpha = std::clamp(halfWidth + 0.5f - distance, 0.0f, 1.0f);
+                    auto& pixel = glyph.data[py * width + px];
+                    pixel = std::max(pixel, static_cast<uint8_t>(alpha * 255));
+                }
+            }
+        }
+        glyphs.push_back(std::move(glyph));
+    }
+    return glyphs;
+}
+
+const std::vector<AlphaImage>& glyphs(GlyphSet set) {
+    static const auto latin = makeGlyphs(Latin);
+    static const auto cjk = makeGlyphs(CJK);
+    return set == Latin ? latin : cjk;
+}
+
+} // namespace
+
+// One glyph at a time through the double precision transform
+static void TinySDF_Scalar(benchmark::State& state) {
+    const auto& rasters = glyphs(static_cast<GlyphSet>(state.range(0)));
+
+    for (auto _ : state) {
+        for (const auto& raster : rasters) {
+            auto sdf = util::transformRasterToSDFScalar(raster, kRadius, kCutoff);
+            benchmark::DoNotOptimize(sdf.data.get());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * rasters.size());
+}
+
+// All glyphs in one batch, the way the glyph manager transforms them
+static void TinySDF_Batch(benchmark::State& state) {
+    const auto& rasters = glyphs(static_cast<GlyphSet>(state.range(0)));
+    std::vector<AlphaImage> sdfs(rasters.size());
+    std::vector<AlphaImage*> batch;
+    for (auto& sdf : sdfs) {
+        batch.push_back(&sdf);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::size_t i = 0; i < rasters.size(); ++i) {
+            sdfs[i] = rasters[i].clone();
+        }
+        state.ResumeTiming();
+
+        util::transformRastersToSDF(batch, kRadius, kCutoff);
+        benchmark::DoNotOptimize(sdfs.front().data.get());
+    }
+
+    state.SetItemsProcessed(state.iterations() * rasters.size());
+}
+
+// Arguments: 0 for Latin glyphs, 1 for CJK ones
+BENCHMARK(TinySDF_Scalar)->Arg(Latin)->Arg(CJK);
+BENCHMARK(TinySDF_Batch)->Arg(Latin)->Arg(CJK);
@@ -4,7 +4,6 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
 
 #include <mapbox/std/weak.hpp>
 #include <mbgl/actor/scheduler.hpp>
@@ -24,6 +23,7 @@ public:
 
     Mailbox(Scheduler&);
     Mailbox(const TaggedScheduler&);
+    ~Mailbox();
 
     /// Attach the given scheduler to this mailbox and begin processing messages
     /// sent to it. The mailbox must be a "holding" mailbox, as created by the
@@ -42,6 +42,11 @@ public:
 
 private:
     void scheduleToRecieve(const std::optional<util::SimpleIdentity>& tag = std::nullopt);
+
+    static std::unique_ptr<Message> makeStub();
+    void enqueue(std::unique_ptr<Message>);
+    std::unique_ptr<Message> dequeue();
+
     enum class State : uint32_t {
         Idle = 0,
         Processing,
@@ -55,10 +60,18 @@ private:
     std::mutex pushingMutex;
 
     std::atomic<State> state{State::Idle};
-    bool closed{false};
+    std::atomic<bool> closed{false};
+
+    // Lock-free multi-producer, single-consumer queue linked through `Message::next`. Producers
+    // append at `head`, receive() takes messages from `tail`, which always points at a node that
+    // was already consumed (initially `stub`).
+    std::unique_ptr<Message> stub = makeStub();
+    std::atomic<Message*> head{stub.get()};
+    Message* tail{stub.get()};
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    // Number of queued messages, counted once a message is linked in. Only the push which
+    // makes it non-zero schedules a receive.
+    std::atomic<std::size_t> queueSize{0};
 };
 
 } // namespace mbgl
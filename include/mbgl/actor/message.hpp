@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <utility>
 
@@ -12,6 +13,12 @@ class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+private:
+    friend class Mailbox;
+
+    // Intrusive link for the mailbox queue, so that pushing a message doesn't allocate
+    std::atomic<Message*> next{nullptr};
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -75,6 +75,9 @@ public:
             tag, std::forward<TaskFn>(task), std::forward<ReplyFn>(reply), GetCurrent()->makeWeakPtr());
     }
 
+    /// Number of threads tasks run on, tasks beyond that wait for one of them to finish
+    virtual std::size_t getThreadCount() const { return 1; }
+
     /// Wait until there's nothing pending or in process
     /// Must not be called from a task provided to this scheduler.
     virtual void waitForEmpty(const util::SimpleIdentity = util::SimpleIdentity::Empty) = 0;
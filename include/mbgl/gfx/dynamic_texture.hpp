@@ -6,8 +6,12 @@
 
 #include <mapbox/shelf-pack.hpp>
 
+#include <array>
+#include <atomic>
 #include <optional>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace mbgl {
 namespace gfx {
@@ -35,6 +39,10 @@ public:
     };
 
 private:
+    TextureHandle(int32_t id_, const Rect<uint16_t>& rectangle_)
+        : id(id_),
+          rectangle(rectangle_) {}
+
     int32_t id = 0;
     Rect<uint16_t> rectangle;
     bool needsUpload = false;
@@ -42,8 +50,35 @@ private:
     friend class DynamicTexture;
 };
 
+/**
+ * @brief A texture holding many images, each packed once and shared by every tile using it.
+ *
+ * Images are reference counted by their unique ID: adding an image which is already in the
+ * texture only adds a reference to it, and removing it drops one, freeing its space once none are
+ * left. Looking up images already in the texture (see `acquireImage`) only takes a shared lock on
+ * one of several shards of the image table, so tiles sharing most of their glyphs and icons don't
+ * wait on each other. Adding new images takes an allocation lock, held while they are packed and
+ * uploaded, so that other tiles only find them once their pixels are in place.
+ */
 class DynamicTexture {
 public:
+    struct Stats {
+        /// Images in the texture, each counted once no matter how many tiles use it
+        std::size_t images = 0;
+        /// Pixels covered by the images, padding included
+        std::size_t usedArea = 0;
+        /// Pixels of the shelf slots the images were packed into. Reusing the slots of removed
+        /// images for smaller ones makes this larger than `usedArea`.
+        std::size_t slotArea = 0;
+        /// The largest `slotArea` so far. Shelves are never merged or freed, so the space of removed
+        /// images can only be used again by images which fit in their slots.
+        std::size_t allocatedArea = 0;
+        /// Pixels of the rows taken up by shelves. What's below the last shelf is the only space
+        /// images of any size can still be packed into, shelves only take images up to their height.
+        std::size_t shelfArea = 0;
+        std::size_t textureArea = 0;
+    };
+
     DynamicTexture(Context& context, Size size, TexturePixelType pixelType);
     virtual ~DynamicTexture() = default;
 
@@ -53,6 +88,10 @@ public:
 
     std::optional<TextureHandle> reserveSize(const Size& size, int32_t uniqueId);
 
+    /// Adds a reference to an image already in the texture, or returns nothing if it isn't there.
+    /// Doesn't wait on images being added.
+    std::optional<TextureHandle> acquireImage(int32_t uniqueId);
+
     template <typename Image>
     std::optional<TextureHandle> addImage(const Image& image, int32_t uniqueId = -1) {
         return addImage(image.data ? image.data.get() : nullptr, image.size, uniqueId);
@@ -63,11 +102,58 @@ public:
     virtual void uploadDeferredImages() {};
     virtual bool removeTexture(const TextureHandle& texHandle);
 
+    /// Stops adding images to the texture, so it's freed once the images already in it are removed.
+    /// They can still be referenced by `acquireImage` until then.
+    void retire() { retired = true; }
+    bool isRetired() const { return retired; }
+    /// Retires the texture if it holds no images, without images being added at the same time.
+    /// `wasRetired` tells whether it had been retired before.
+    bool retireIfEmpty(bool& wasRetired);
+
+    Stats getStats() const;
+
 protected:
     mapbox::ShelfPack shelfPack;
     Texture2DPtr texture;
-    int numTextures = 0;
+    std::atomic<int> numTextures = 0;
     std::mutex mutex;
+
+    /// Drops the pending upload of an image being freed. Called while holding the allocation lock,
+    /// so an image added again in the meantime keeps its upload.
+    virtual void discardUpload(const TextureHandle&) {}
+
+private:
+    struct ResidentImage {
+        ResidentImage(const Rect<uint16_t>& rectangle_)
+            : rectangle(rectangle_) {}
+
+        Rect<uint16_t> rectangle;
+        /// Zero while the image is being removed, until it's added again or gone
+        std::atomic<int32_t> refcount = 1;
+    };
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<int32_t, ResidentImage> images;
+    };
+    static constexpr std::size_t shardCount = 16;
+
+    Shard& shardFor(int32_t uniqueId) { return shards[static_cast<uint32_t>(uniqueId) % shardCount]; }
+
+    /// Adds a reference to a resident image. Images being removed are only brought back while
+    /// holding the allocation lock, which is what removing them waits on.
+    std::optional<TextureHandle> acquireResidentImage(int32_t uniqueId, bool revive);
+    std::optional<TextureHandle> packImage(const uint8_t* pixelData, const Size& size, int32_t uniqueId, bool upload);
+
+    std::array<Shard, shardCount> shards;
+    /// Guards `shelfPack`, held while new images are packed and uploaded, and while removed ones
+    /// are freed
+    std::mutex allocationMutex;
+    std::atomic<std::size_t> usedArea = 0;
+    std::atomic<std::size_t> slotArea = 0;
+    std::atomic<std::size_t> allocatedArea = 0;
+    /// Bottom of the last shelf
+    std::atomic<uint32_t> shelvesHeight = 0;
+    std::atomic<bool> retired = false;
 };
 
 } // namespace gfx
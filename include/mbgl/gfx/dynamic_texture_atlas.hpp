@@ -27,10 +27,25 @@ public:
 
 class DynamicTextureAtlas {
 public:
+    struct Stats {
+        std::size_t textures = 0;
+        /// Textures retired by `compact`, still in use by some tiles
+        std::size_t retiredTextures = 0;
+        /// Sums of `DynamicTexture::Stats` over all textures
+        std::size_t images = 0;
+        std::size_t usedArea = 0;
+        std::size_t slotArea = 0;
+        std::size_t allocatedArea = 0;
+        std::size_t shelfArea = 0;
+        std::size_t textureArea = 0;
+    };
+
     DynamicTextureAtlas(Context& context_)
         : context(context_) {}
     ~DynamicTextureAtlas() = default;
 
+    /// Glyphs and images already in a texture are only referenced again, without waiting on
+    /// other tiles, see `DynamicTexture::acquireImage`. May be called from any thread.
     GlyphAtlas uploadGlyphs(const GlyphMap& glyphs);
     ImageAtlas uploadIconsAndPatterns(const ImageMap& icons,
                                       const ImageMap& patterns,
@@ -38,11 +53,29 @@ public:
 
     void removeTextures(const std::vector<TextureHandle>& textureHandles, const DynamicTexturePtr& dynamicTexture);
 
+    /// Retires the most fragmented texture of each pixel type, if more than `maxFragmentation` of its
+    /// allocated area isn't used by images anymore and the other textures have room for its images.
+    /// Tiles laid out from then on use the other textures, and the retired one is freed along with the
+    /// last tile using it. Images can't be moved in place, as their positions are part of the tiles'
+    /// buckets. A `maxFragmentation` of 1 or more never retires any. Also adds the textures freed
+    /// since the last call to the context's rendering stats. Must be called on the render thread.
+    void compact(double maxFragmentation);
+
+    Stats getStats() const;
+
 private:
+    /// The texture to try after `index` others didn't fit, an existing one or a new one of `newSize`
+    DynamicTexturePtr getDynamicTexture(std::size_t index, Size& newSize, TexturePixelType pixelType);
+    DynamicTexturePtr getDummyDynamicTexture(TexturePixelType pixelType);
+
     Context& context;
     std::vector<DynamicTexturePtr> dynamicTextures;
     std::unordered_map<TexturePixelType, DynamicTexturePtr> dummyDynamicTexture;
-    std::mutex mutex;
+    /// Guards the lists of textures only, each texture guards its own images
+    mutable std::mutex mutex;
+    /// Retired textures freed since the last `compact`, textures are removed on any thread
+    std::atomic<int> compactedTextures = 0;
+    std::atomic<std::size_t> compactedBytes = 0;
 };
 
 } // namespace gfx
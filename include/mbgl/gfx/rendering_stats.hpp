@@ -39,6 +39,10 @@ struct RenderingStats {
     int numTextureUpdates = 0;
     /// Number of bytes used in texture updates
     std::size_t textureUpdateBytes = 0;
+    /// Number of glyph and icon atlas textures freed by compaction
+    int numCompactedAtlasTextures = 0;
+    /// Texture memory freed by atlas compaction
+    std::size_t atlasCompactionBytes = 0;
 
     /// Number of buffers created
     std::size_t totalBuffers = 0;
@@ -15,6 +15,85 @@ DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_FILE, thread_priority_file
 DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_NETWORK, thread_priority_network);
 DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_DATABASE, thread_priority_database);
 
+// The value for EXPERIMENTAL_PARALLEL_LAYER_PARSING, must be a bool. When true, the style layer
+// groups of a single vector tile are parsed concurrently on the worker pool.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PARALLEL_LAYER_PARSING, parallel_layer_parsing);
+
+// The value for EXPERIMENTAL_TILE_CACHE_MAX_BYTES, must be an unsigned integer. Limits the memory
+// held by the tile caches of all maps in the process combined, on top of each cache's tile count.
+// Zero or unset means no limit. Read whenever a tile cache is created.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_TILE_CACHE_MAX_BYTES, tile_cache_max_bytes);
+
+// The value for EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES, must be an unsigned integer. Sizes a cache
+// of parsed vector tile layers shared by all maps in the process, so maps using the same style and
+// sources don't parse the same tiles again. Zero or unset disables the cache. Read whenever a style
+// is loaded, changes take effect with the next one.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES, parsed_tile_cache_max_bytes);
+
+// The value for EXPERIMENTAL_PMTILES_DIRECTORY_CACHE_MAX_BYTES, must be an unsigned integer. Limits the
+// memory held by the decoded directories of all PMTiles archives. Unset means 32 MiB. Read when the
+// PMTiles file source is created.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PMTILES_DIRECTORY_CACHE_MAX_BYTES, pmtiles_directory_cache_max_bytes);
+
+// The value for EXPERIMENTAL_OFFLINE_DATABASE_COMPRESSION, must be a string, "zlib" or "zstd". The
+// codec used to compress resources stored in offline databases, zlib if unset or if the codec isn't
+// available. Databases can always be read back regardless. Read when the database is opened.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_OFFLINE_DATABASE_COMPRESSION, offline_database_compression);
+
+// The value for EXPERIMENTAL_OFFLINE_DATABASE_WRITE_BATCH_SIZE, must be an unsigned integer. When set,
+// the database file source writes ambient cache entries and access times in batches of up to this
+// many, or whatever is pending after 100 ms, each in a single transaction. Zero or unset writes every
+// entry right away. Read when the database file source is created.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_OFFLINE_DATABASE_WRITE_BATCH_SIZE, offline_database_write_batch_size);
+
+// The values for EXPERIMENTAL_HTTP_MAX_HOST_CONNECTIONS and EXPERIMENTAL_HTTP_MAX_CONCURRENT_STREAMS,
+// must be unsigned integers. Limit the connections the curl HTTP file source opens to a single host,
+// and the requests multiplexed over each HTTP/2 connection. Unset or zero uses the libcurl defaults.
+// Read when the HTTP file source is created.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_HTTP_MAX_HOST_CONNECTIONS, http_max_host_connections);
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_HTTP_MAX_CONCURRENT_STREAMS, http_max_concurrent_streams);
+
+// The value for EXPERIMENTAL_HTTP2_PRIOR_KNOWLEDGE, must be a bool. When true, the curl HTTP file source
+// speaks HTTP/2 to http:// URLs without negotiating it first, which only works with servers known to
+// support cleartext HTTP/2. https:// URLs negotiate HTTP/2 regardless. Read when a request is started.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_HTTP2_PRIOR_KNOWLEDGE, http2_prior_knowledge);
+
+// The value for EXPERIMENTAL_TILE_REQUEST_MAX_PRIORITY, must be a number. Tiles are requested in order
+// of their load priority: their distance from the center of the viewport in tiles, plus one for every
+// zoom level they are away from the ideal zoom. Network requests of tiles whose priority exceeds this
+// value are cancelled, and made again once it's back within. Only applies to continuous maps. Unset
+// means no limit. Read when a tile is created.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_TILE_REQUEST_MAX_PRIORITY, tile_request_max_priority);
+
+// The value for EXPERIMENTAL_PARALLEL_PLACEMENT, must be a bool. When true, symbol layers that can't
+// collide with each other, because they belong to different collision groups or allow overlap and
+// ignore placement, are placed concurrently on the worker pool. Read whenever labels are placed.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PARALLEL_PLACEMENT, parallel_placement);
+
+// The value for EXPERIMENTAL_INCREMENTAL_PLACEMENT, must be a bool. When true, labels are placed again
+// only where something changed since the last placement, like a tile that was loaded or a label that
+// moved into view, and everywhere else the last results are reused. Only applies to continuous maps,
+// and only while the view is panned without pitch. Takes precedence over EXPERIMENTAL_PARALLEL_PLACEMENT.
+// Read whenever labels are placed.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_INCREMENTAL_PLACEMENT, incremental_placement);
+
+// The value for EXPERIMENTAL_GLYPH_SDF_CACHE, must be a bool. When true, the SDFs of glyphs rasterized
+// from local fonts are stored in the ambient cache, and read back from there instead of rasterized again,
+// like after a restart. Only applies when there is a database. Read whenever glyphs are requested.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_GLYPH_SDF_CACHE, glyph_sdf_cache);
+
+// The value for EXPERIMENTAL_SHAPING_CACHE_SIZE, must be an unsigned integer. The number of label
+// shapings each worker thread keeps, so that labels with the same text and layout, in the same tile
+// or another one, are only shaped once. Zero or unset disables the cache. Read whenever a tile's
+// labels are laid out.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_SHAPING_CACHE_SIZE, shaping_cache_size);
+
+// The value for EXPERIMENTAL_ATLAS_COMPACTION_THRESHOLD, a number between 0 and 1. When the
+// fraction of a glyph or icon atlas texture no longer used by any tile passes this value, and the other
+// textures have room, new tiles stop using it so that it's freed once the tiles using it are gone. Freed
+// textures are reported in the rendering stats. Unset never frees textures that way. Read every frame.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_ATLAS_COMPACTION_THRESHOLD, atlas_compaction_threshold);
+
 /// Settings class provides non-persistent, in-process key-value storage.
 class Settings final {
 public:
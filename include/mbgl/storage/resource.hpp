@@ -5,11 +5,32 @@
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <optional>
 
 namespace mbgl {
 
+/// How urgently a resource is needed, e.g. a tile's distance from the center of the viewport. The
+/// requester may update it while the request is pending, and file sources order pending requests
+/// of the same `Resource::Priority` by it, lowest first. Thread-safe.
+class LoadPriority {
+public:
+    explicit LoadPriority(float value_ = 0.0f)
+        : value(value_) {}
+
+    float get() const { return value.load(std::memory_order_relaxed); }
+    void set(float);
+
+    /// Changes whenever any load priority changes, so that queues know when to reorder.
+    static uint64_t generation() { return changes.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<float> value;
+    static std::atomic<uint64_t> changes;
+};
+
 class Resource {
 public:
     enum Kind : uint8_t {
@@ -93,6 +114,9 @@ public:
     Priority priority{Priority::Regular};
     std::string url;
 
+    // Shared with the file sources the resource is passed on to. Null means 0.
+    std::shared_ptr<LoadPriority> loadPriority;
+
     // Includes auxiliary data if this is a tile request.
     std::optional<TileData> tileData;
 
@@ -16,6 +16,7 @@ public:
 
 public:
     class Error;
+    struct Timing;
     // When this object is empty, the response was successful.
     std::unique_ptr<const Error> error;
 
@@ -37,6 +38,9 @@ public:
     std::optional<Timestamp> expires;
     std::optional<std::string> etag;
 
+    // Network timing of the request, for file sources which report it.
+    std::shared_ptr<const Timing> timing;
+
     bool isFresh() const { return expires ? *expires > util::now() : !error; }
 
     // Indicates whether we are allowed to use this response according to HTTP
@@ -65,4 +69,21 @@ public:
     Error(Reason, std::string = "", std::optional<Timestamp> = std::nullopt);
 };
 
+struct Response::Timing {
+    // Time from the start of the request until each phase completed. Phases which didn't happen,
+    // e.g. because a connection was reused or the URL isn't https://, are reported as the time of
+    // the previous phase.
+    Duration nameLookup = Duration::zero();
+    Duration connect = Duration::zero();
+    Duration tlsHandshake = Duration::zero();
+    Duration firstByte = Duration::zero();
+    Duration total = Duration::zero();
+
+    // Major HTTP version of the response, 0 if unknown
+    uint8_t httpVersion = 0;
+
+    // Number of new connections opened for the request, 0 if it reused an existing connection
+    uint32_t newConnections = 0;
+};
+
 } // namespace mbgl
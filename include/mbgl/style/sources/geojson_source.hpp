@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -37,9 +38,24 @@ struct GeoJSONOptions {
 
     // Update options
     bool synchronousUpdate = false;
+    /// Tiles the features so that `GeoJSONSource::updateGeoJSON()` only re-slices the tiles it
+    /// touches. Non-clustered data is otherwise tiled by GeoJSON-VT, which can only be replaced
+    /// as a whole by an update removing all features.
+    bool incrementalUpdates = false;
 
     static Immutable<GeoJSONOptions> defaultOptions();
 };
+
+/// Changes to the features of a GeoJSON source. Features are matched by their id, so features
+/// without an id can be added but not updated or removed afterwards.
+struct GeoJSONFeatureDiff {
+    /// Removes all features before applying the other changes
+    bool removeAll = false;
+    std::vector<mapbox::feature::identifier> remove;
+    /// Added features replace the features with the same id
+    mapbox::feature::feature_collection<double> add;
+};
+
 class GeoJSONData {
 public:
     using TileFeatures = mapbox::feature::feature_collection<int16_t>;
@@ -55,6 +71,14 @@ public:
     virtual Features getChildren(std::uint32_t) = 0;
     virtual Features getLeaves(std::uint32_t, std::uint32_t limit, std::uint32_t offset) = 0;
     virtual std::uint8_t getClusterExpansionZoom(std::uint32_t) = 0;
+
+    /// Returns new data with the diff applied, sharing whatever the changed features don't touch.
+    /// Null if the data can't be updated.
+    virtual std::shared_ptr<GeoJSONData> update(const GeoJSONFeatureDiff&) { return nullptr; }
+
+    /// Whether the tile's features may differ from those in `previous`. Only tiles touched by the
+    /// changed features are affected when this data was created by `previous.update()`.
+    virtual bool isTileAffected(const CanonicalTileID&, const GeoJSONData& /* previous */) const { return true; }
 };
 
 // NOTE: Any derived class must invalidate `weakFactory` in the destructor
@@ -66,6 +90,10 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
     void setGeoJSONData(std::shared_ptr<GeoJSONData>);
+    /// Adds, replaces and removes features without re-tiling the whole source. Only the tiles
+    /// touched by the changed features are reloaded. Non-clustered sources need the
+    /// `incrementalUpdates` option unless the diff removes all features.
+    void updateGeoJSON(const GeoJSONFeatureDiff&);
 
     std::optional<std::string> getURL() const;
     const GeoJSONOptions& getOptions() const;
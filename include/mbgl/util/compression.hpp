@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 
 namespace mbgl {
 namespace util {
@@ -14,10 +16,48 @@ enum CompressionFormat {
 };
 
 bool is_compressed(const std::string&);
-std::string compress(const std::string& raw, int windowBits = CompressionFormat::ZLIB);
-std::string decompress(const std::string& raw, int windowBits = CompressionFormat::DETECT);
+std::string compress(std::string_view raw, int windowBits = CompressionFormat::ZLIB);
+std::string decompress(std::string_view raw, int windowBits = CompressionFormat::DETECT);
 
 std::uint32_t crc32(const void* raw, size_t size) noexcept;
 
+enum class CodecType : uint8_t {
+    Zlib,
+    Gzip,
+    Zstd,
+    Brotli,
+};
+
+/**
+ * @brief A compression format, looked up with `getCodec`.
+ *
+ * Zlib and gzip are always available. Zstd and brotli are available when built with
+ * `MLN_WITH_ZSTD` and `MLN_WITH_BROTLI`, or once an implementation is registered with
+ * `registerCodec`. All methods throw `std::runtime_error` on malformed data.
+ */
+class Codec {
+public:
+    virtual ~Codec() = default;
+
+    virtual CodecType type() const = 0;
+
+    /// Whether the data starts with the magic bytes of this format. Formats without any never match.
+    virtual bool matches(std::string_view) const { return false; }
+
+    virtual std::string compress(std::string_view raw) const = 0;
+
+    virtual std::string decompress(std::string_view raw) const = 0;
+};
+
+/// Null if the codec isn't available
+const Codec* getCodec(CodecType);
+
+/// The codec whose magic bytes the data starts with, null if it's not compressed or the codec
+/// isn't available
+const Codec* detectCodec(std::string_view);
+
+/// Makes a codec available, replacing any codec registered for the same type
+void registerCodec(std::shared_ptr<const Codec>);
+
 } // namespace util
 } // namespace mbgl
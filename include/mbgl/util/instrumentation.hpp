@@ -53,6 +53,10 @@ constexpr const char* tracyConstMemoryLabel = "Constant Buffer Memory";
 #define MLN_TRACE_ALLOC_CONST_BUFFER(id, size) TracyAllocN(castGpuIdToTracyPtr(id), size, tracyConstMemoryLabel)
 #define MLN_TRACE_FREE_CONST_BUFFER(id) TracyFreeN(castGpuIdToTracyPtr(id), tracyConstMemoryLabel)
 
+constexpr const char* tracyFeatureCacheMemoryLabel = "Feature Decode Cache Memory";
+#define MLN_TRACE_ALLOC_FEATURE_CACHE(id, size) TracyAllocN(id, size, tracyFeatureCacheMemoryLabel)
+#define MLN_TRACE_FREE_FEATURE_CACHE(id) TracyFreeN(id, tracyFeatureCacheMemoryLabel)
+
 // Only OpenGL is currently considered for GPU profiling
 // Metal and other APIs need to be handled separately
 #if MLN_RENDER_BACKEND_OPENGL
@@ -124,6 +128,8 @@ constexpr const char* tracyConstMemoryLabel = "Constant Buffer Memory";
 #define MLN_TRACE_FREE_INDEX_BUFFER(id) ((void)0)
 #define MLN_TRACE_ALLOC_CONST_BUFFER(id, size) ((void)0)
 #define MLN_TRACE_FREE_CONST_BUFFER(id) ((void)0)
+#define MLN_TRACE_ALLOC_FEATURE_CACHE(id, size) ((void)0)
+#define MLN_TRACE_FREE_FEATURE_CACHE(id) ((void)0)
 #define MLN_TRACE_FUNC() ((void)0)
 #define MLN_TRACE_ZONE(label) ((void)0)
 
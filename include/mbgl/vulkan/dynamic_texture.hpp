@@ -18,7 +18,6 @@ public:
 
     void uploadImage(const uint8_t* pixelData, gfx::TextureHandle& texHandle) override;
     void uploadDeferredImages() override;
-    bool removeTexture(const gfx::TextureHandle& texHandle) override;
 
 #if DYNAMIC_TEXTURE_VULKAN_MULTITHREADED_UPLOAD
     using TexturesToBlit = std::unordered_map<gfx::TextureHandle, gfx::Texture2DPtr, gfx::TextureHandle::Hasher>;
@@ -27,6 +26,9 @@ public:
         std::unordered_map<gfx::TextureHandle, UniqueBufferAllocation, gfx::TextureHandle::Hasher>;
 #endif
 
+protected:
+    void discardUpload(const gfx::TextureHandle& texHandle) override;
+
 private:
     Context& context;
 
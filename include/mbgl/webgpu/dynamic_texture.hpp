@@ -13,11 +13,13 @@ public:
 
     void uploadImage(const uint8_t* pixelData, gfx::TextureHandle& texHandle) override;
     void uploadDeferredImages() override;
-    bool removeTexture(const gfx::TextureHandle& texHandle) override;
 
     using ImagesToUpload =
         std::unordered_map<gfx::TextureHandle, std::unique_ptr<uint8_t[]>, gfx::TextureHandle::Hasher>;
 
+protected:
+    void discardUpload(const gfx::TextureHandle& texHandle) override;
+
 private:
     bool deferredCreation = false;
     ImagesToUpload imagesToUpload;
@@ -32,6 +32,8 @@ void RenderingStats::Update(jni::JNIEnv& env,
     SetField(numTextureBindings, jni::jint);
     SetField(numTextureUpdates, jni::jint);
     SetField(textureUpdateBytes, jni::jlong);
+    SetField(numCompactedAtlasTextures, jni::jint);
+    SetField(atlasCompactionBytes, jni::jlong);
     SetField(totalBuffers, jni::jlong);
     SetField(totalBufferObjs, jni::jlong);
     SetField(bufferUpdates, jni::jlong);
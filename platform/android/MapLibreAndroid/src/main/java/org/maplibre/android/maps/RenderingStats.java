@@ -23,6 +23,10 @@ public class RenderingStats {
   public int numTextureUpdates = 0;
   /// Number of bytes used in texture updates
   public long textureUpdateBytes = 0;
+  /// Number of glyph and icon atlas textures freed by compaction
+  public int numCompactedAtlasTextures = 0;
+  /// Texture memory freed by atlas compaction
+  public long atlasCompactionBytes = 0;
 
   /// Number of buffers created
   public long totalBuffers = 0;
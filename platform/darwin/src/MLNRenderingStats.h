@@ -29,6 +29,10 @@ MLN_EXPORT
 @property (readonly) int numTextureUpdates;
 /// Number of bytes used in texture updates
 @property (readonly) unsigned long textureUpdateBytes;
+/// Number of glyph and icon atlas textures freed by compaction
+@property (readonly) int numCompactedAtlasTextures;
+/// Texture memory freed by atlas compaction
+@property (readonly) unsigned long atlasCompactionBytes;
 
 /// Number of buffers created
 @property (readonly) unsigned long totalBuffers;
@@ -13,6 +13,8 @@
     _numTextureBindings = stats.numTextureBindings;
     _numTextureUpdates = stats.numTextureUpdates;
     _textureUpdateBytes = stats.textureUpdateBytes;
+    _numCompactedAtlasTextures = stats.numCompactedAtlasTextures;
+    _atlasCompactionBytes = stats.atlasCompactionBytes;
     _totalBuffers = stats.totalBuffers;
     _totalBufferObjs = stats.totalBufferObjs;
     _bufferUpdates = stats.bufferUpdates;
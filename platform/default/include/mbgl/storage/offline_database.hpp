@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <optional>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -30,6 +31,7 @@ class TileID;
 
 namespace util {
 struct IOException;
+class Codec;
 } // namespace util
 
 struct MapboxTileLimitExceededException : util::Exception {
@@ -47,9 +49,17 @@ public:
 
     std::optional<Response> get(const Resource&);
 
-    // Return value is (inserted, stored size)
+    // Return value is (inserted, stored size), or (false, 0) for writes left pending in a batch
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Groups ambient cache writes, and the access time updates of reads, into one transaction
+    // of up to `maxItems` writes. Pending writes are returned by `get` and written by `flush`,
+    // which the owner is expected to call shortly after any write; all other operations flush
+    // first. 0 writes every resource right away, which is the default.
+    void setWriteBatchSize(std::size_t maxItems);
+    void flush();
+    bool hasPendingWrites() const;
+
     // Force Mapbox GL Native to revalidate tiles stored in the ambient
     // cache with the tile server before using them, making sure they
     // are the latest version. This is more efficient than cleaning the
@@ -132,6 +142,7 @@ private:
     std::optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     std::optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
+    void updateAccessed(const Resource&, Timestamp);
 
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
@@ -155,6 +166,9 @@ private:
 
     TileServerOptions tileServerOptions;
 
+    // Compresses stored data, see `platform::EXPERIMENTAL_OFFLINE_DATABASE_COMPRESSION`
+    const util::Codec* codec;
+
     class DatabaseSizeChangeStats {
     public:
         explicit DatabaseSizeChangeStats(OfflineDatabase*);
@@ -186,6 +200,10 @@ private:
 
     bool autopack = true;
     bool readOnly = false;
+
+    std::size_t writeBatchSize = 0;
+    std::vector<std::pair<Resource, Response>> pendingPuts;
+    std::vector<Resource> pendingAccessed;
 };
 
 } // namespace mbgl
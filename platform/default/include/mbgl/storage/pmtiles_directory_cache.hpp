@@ -0,0 +1,112 @@
+#pragma once
+
+#include <mbgl/util/hash.hpp>
+
+#include <pmtiles.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+using PMTilesDirectory = std::shared_ptr<const std::vector<pmtiles::entryv3>>;
+
+struct PMTilesDirectoryKey {
+    std::string url;
+    uint64_t offset;
+    uint32_t length;
+
+    bool operator==(const PMTilesDirectoryKey&) const = default;
+};
+
+struct PMTilesDirectoryKeyHash {
+    std::size_t operator()(const PMTilesDirectoryKey& key) const {
+        return util::hash(key.url, key.offset, key.length);
+    }
+};
+
+/**
+ * Decoded directories of all archives of a PMTiles file source, least recently used evicted
+ * first once they take up more than `maxBytes`. Not thread safe.
+ */
+class PMTilesDirectoryCache {
+public:
+    explicit PMTilesDirectoryCache(std::size_t maxBytes_)
+        : maxBytes(maxBytes_) {}
+
+    PMTilesDirectory get(const PMTilesDirectoryKey& key) {
+        const auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        items.splice(items.begin(), items, it->second);
+        return it->second->directory;
+    }
+
+    bool contains(const PMTilesDirectoryKey& key) const { return index.contains(key); }
+
+    PMTilesDirectory put(const PMTilesDirectoryKey& key, std::vector<pmtiles::entryv3> entries) {
+        auto directory = std::make_shared<const std::vector<pmtiles::entryv3>>(std::move(entries));
+        const std::size_t directoryBytes = getDirectoryBytes(key.url, directory->size());
+
+        if (const auto it = index.find(key); it != index.end()) {
+            bytes -= it->second->bytes;
+            items.erase(it->second);
+            index.erase(it);
+        }
+
+        items.push_front({key, directory, directoryBytes});
+        index.emplace(key, items.begin());
+        bytes += directoryBytes;
+
+        // The directory just stored always stays, the lookup waiting for it needs it
+        while (bytes > maxBytes && items.size() > 1) {
+            bytes -= items.back().bytes;
+            index.erase(items.back().key);
+            items.pop_back();
+        }
+        return directory;
+    }
+
+    /// Drops every directory of the archive at `url`
+    void erase(const std::string& url) {
+        for (auto it = items.begin(); it != items.end();) {
+            if (it->key.url == url) {
+                bytes -= it->bytes;
+                index.erase(it->key);
+                it = items.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /// Memory taken up by a directory of `entries` entries stored under `url`
+    static std::size_t getDirectoryBytes(const std::string& url, std::size_t entries) {
+        return sizeof(Item) + url.size() + entries * sizeof(pmtiles::entryv3);
+    }
+
+    std::size_t getBytes() const { return bytes; }
+    std::size_t size() const { return items.size(); }
+
+private:
+    struct Item {
+        PMTilesDirectoryKey key;
+        PMTilesDirectory directory;
+        std::size_t bytes;
+    };
+    using Items = std::list<Item>;
+
+    const std::size_t maxBytes;
+    std::size_t bytes = 0;
+    // Most recently used first
+    Items items;
+    std::unordered_map<PMTilesDirectoryKey, Items::iterator, PMTilesDirectoryKeyHash> index;
+};
+
+} // namespace mbgl
@@ -11,16 +11,37 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 
 #include <map>
 #include <utility>
 
 namespace mbgl {
+
+namespace {
+
+// Longest time batched writes are left pending
+constexpr Duration writeBatchDelay = std::chrono::milliseconds(100);
+
+std::size_t getWriteBatchSize() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_OFFLINE_DATABASE_WRITE_BATCH_SIZE);
+    if (const auto* uintValue = value.getUint()) {
+        return static_cast<std::size_t>(*uintValue);
+    } else if (const auto* intValue = value.getInt(); intValue && *intValue > 0) {
+        return static_cast<std::size_t>(*intValue);
+    }
+    return 0;
+}
+
+} // namespace
+
 class DatabaseFileSourceThread {
 public:
     DatabaseFileSourceThread(std::shared_ptr<FileSource> onlineFileSource_, const std::string& cachePath)
         : db(std::make_unique<OfflineDatabase>(cachePath, onlineFileSource_->getResourceOptions().tileServerOptions())),
-          onlineFileSource(std::move(onlineFileSource_)) {}
+          onlineFileSource(std::move(onlineFileSource_)) {
+        db->setWriteBatchSize(getWriteBatchSize());
+    }
 
     void request(const Resource& resource, const ActorRef<FileSourceRequest>& req) {
         std::optional<Response> offlineResponse = (resource.storagePolicy != Resource::StoragePolicy::Volatile)
@@ -36,6 +57,7 @@ public:
                                                                        "Cached resource is unusable");
         }
         req.invoke(&FileSourceRequest::setResponse, *offlineResponse);
+        scheduleFlush();
     }
 
     void setDatabasePath(const std::string& path, const std::function<void()>& callback) {
@@ -47,6 +69,7 @@ public:
 
     void forward(const Resource& resource, const Response& response, const std::function<void()>& callback) {
         db->put(resource, response);
+        scheduleFlush();
         if (callback) {
             callback();
         }
@@ -58,7 +81,10 @@ public:
 
     void runPackDatabaseAutomatically(bool autopack) { db->runPackDatabaseAutomatically(autopack); }
 
-    void put(const Resource& resource, const Response& response) { db->put(resource, response); }
+    void put(const Resource& resource, const Response& response) {
+        db->put(resource, response);
+        scheduleFlush();
+    }
 
     void invalidateAmbientCache(const std::function<void(std::exception_ptr)>& callback) {
         callback(db->invalidateAmbientCache());
@@ -133,6 +159,18 @@ public:
     void reopenDatabaseReadOnly(bool readOnly) { db->reopenDatabaseReadOnly(readOnly); }
 
 private:
+    // Writes whatever the last reads and writes left pending once the batch delay has passed
+    void scheduleFlush() {
+        if (flushScheduled || !db->hasPendingWrites()) {
+            return;
+        }
+        flushScheduled = true;
+        flushTimer.start(writeBatchDelay, Duration::zero(), [this] {
+            flushScheduled = false;
+            db->flush();
+        });
+    }
+
     expected<OfflineDownload*, std::exception_ptr> getDownload(int64_t regionID) {
         if (!onlineFileSource) {
             return unexpected<std::exception_ptr>(
@@ -155,6 +193,8 @@ private:
     std::unique_ptr<OfflineDatabase> db;
     std::map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
     std::shared_ptr<FileSource> onlineFileSource;
+    util::Timer flushTimer;
+    bool flushScheduled = false;
 };
 
 class DatabaseFileSource::Impl {
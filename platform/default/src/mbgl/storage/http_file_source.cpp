@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/resource_options.hpp>
 #include <mbgl/storage/resource.hpp>
@@ -34,6 +35,60 @@ void handleError(CURLcode code) {
         throw std::runtime_error(std::string("CURL easy error: ") + curl_easy_strerror(code));
     }
 }
+
+long getLimitSetting(const char *key) {
+    const auto value = mbgl::platform::Settings::getInstance().get(key);
+    if (const auto *uintValue = value.getUint()) {
+        return static_cast<long>(*uintValue);
+    } else if (const auto *intValue = value.getInt(); intValue && *intValue > 0) {
+        return static_cast<long>(*intValue);
+    }
+    return 0;
+}
+
+bool useHTTP2PriorKnowledge() {
+    const auto value = mbgl::platform::Settings::getInstance().get(mbgl::platform::EXPERIMENTAL_HTTP2_PRIOR_KNOWLEDGE);
+    const auto *boolValue = value.getBool();
+    return boolValue && *boolValue;
+}
+
+mbgl::Duration getDuration(CURL *handle, CURLINFO info) {
+    double seconds = 0;
+    curl_easy_getinfo(handle, info, &seconds);
+    return std::chrono::duration_cast<mbgl::Duration>(std::chrono::duration<double>(seconds));
+}
+
+std::shared_ptr<const mbgl::Response::Timing> getTiming(CURL *handle) {
+    auto timing = std::make_shared<mbgl::Response::Timing>();
+    timing->nameLookup = getDuration(handle, CURLINFO_NAMELOOKUP_TIME);
+    timing->connect = getDuration(handle, CURLINFO_CONNECT_TIME);
+    // libcurl reports 0 when there was no TLS handshake, e.g. for http:// URLs
+    timing->tlsHandshake = std::max(getDuration(handle, CURLINFO_APPCONNECT_TIME), timing->connect);
+    timing->firstByte = getDuration(handle, CURLINFO_STARTTRANSFER_TIME);
+    timing->total = getDuration(handle, CURLINFO_TOTAL_TIME);
+
+    long newConnections = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &newConnections);
+    timing->newConnections = static_cast<uint32_t>(newConnections);
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (50) << 8 | (0))
+    long httpVersion = 0;
+    curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &httpVersion);
+    switch (httpVersion) {
+        case CURL_HTTP_VERSION_1_0:
+        case CURL_HTTP_VERSION_1_1:
+            timing->httpVersion = 1;
+            break;
+        case CURL_HTTP_VERSION_2_0:
+            timing->httpVersion = 2;
+            break;
+        default:
+            break;
+    }
+#endif
+
+    return timing;
+}
 } // namespace
 
 namespace mbgl {
@@ -59,9 +114,13 @@ public:
     // without having to block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state (e.g. DNS lookups
+    // and TLS sessions) between easy handles.
     CURLSH *share = nullptr;
 
+    // Whether libcurl was built with HTTP/2 support
+    bool http2 = false;
+
     // A queue that we use for storing reusable CURL easy handles to avoid
     // creating and destroying them all the time.
     std::queue<CURL *> handles;
@@ -114,13 +173,34 @@ HTTPFileSource::Impl::Impl(const ResourceOptions &resourceOptions_, const Client
         throw std::runtime_error("Could not init cURL");
     }
 
+    // All handles are used on the file source thread, so the share handle needs no locking.
     share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    http2 = (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) != 0;
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | (0))
+    // Send concurrent requests to the same host as streams of a single HTTP/2 connection,
+    // rather than paying for a TCP and TLS handshake each.
+    if (http2) {
+        handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+    }
+#endif
+    if (const long maxHostConnections = getLimitSetting(platform::EXPERIMENTAL_HTTP_MAX_HOST_CONNECTIONS)) {
+        handleError(curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxHostConnections));
+    }
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (67) << 8 | (0))
+    if (const long maxStreams = getLimitSetting(platform::EXPERIMENTAL_HTTP_MAX_CONCURRENT_STREAMS)) {
+        handleError(curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, maxStreams));
+    }
+#endif
 }
 
 HTTPFileSource::Impl::~Impl() {
@@ -306,6 +386,18 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl *context_, Resource resource_, Fil
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapLibreNative/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
 
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (49) << 8 | (0))
+    if (context->http2) {
+        // Wait for a connection being set up to the same host to tell whether it can be multiplexed,
+        // instead of opening another one right away.
+        handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+        handleError(curl_easy_setopt(handle,
+                                     CURLOPT_HTTP_VERSION,
+                                     useHTTP2PriorKnowledge() ? CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE
+                                                              : CURL_HTTP_VERSION_2TLS));
+    }
+#endif
+
     // Start requesting the information.
     handleError(curl_multi_add_handle(context->multi, handle));
 }
@@ -449,6 +541,8 @@ void HTTPRequest::handleResult(CURLcode code) {
         }
     }
 
+    response->timing = getTiming(handle);
+
     // Calling `callback` may result in deleting `this`. Copy data to temporaries first.
     auto callback_ = callback;
     auto response_ = *response;
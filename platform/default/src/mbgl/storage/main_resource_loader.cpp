@@ -179,6 +179,13 @@ public:
         return req;
     }
 
+    // Stores data generated on the client in the cache
+    void forward(const Resource& resource, const Response& response, std::function<void()> callback) {
+        if (databaseFileSource) {
+            databaseFileSource->forward(resource, response, std::move(callback));
+        }
+    }
+
     bool canRequest(const Resource& resource) const {
         return (assetFileSource && assetFileSource->canRequest(resource)) ||
                (localFileSource && localFileSource->canRequest(resource)) ||
@@ -262,6 +269,10 @@ std::unique_ptr<AsyncRequest> MainResourceLoader::request(const Resource& resour
     return impl->request(resource, std::move(callback));
 }
 
+void MainResourceLoader::forward(const Resource& resource, const Response& response, std::function<void()> callback) {
+    impl->forward(resource, response, std::move(callback));
+}
+
 bool MainResourceLoader::canRequest(const Resource& resource) const {
     return impl->canRequest(resource);
 }
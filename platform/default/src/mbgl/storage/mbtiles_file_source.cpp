@@ -35,6 +35,11 @@ bool acceptsURL(const std::string &url) {
 std::string url_to_path(const std::string &url) {
     return mbgl::util::percentDecode(url.substr(std::char_traits<char>::length(mbgl::util::MBTILES_PROTOCOL)));
 }
+
+// Tiles are read through SQLite's memory mapping of the archive rather than copied into its page
+// cache, so the pages are shared with other processes reading it. SQLite caps this at the maximum
+// it was built with.
+constexpr int64_t mmapSize = int64_t(1) << 40;
 } // namespace
 
 namespace mbgl {
@@ -209,7 +214,7 @@ public:
         for (mapbox::sqlite::Query q(stmt); q.run();) {
             std::optional<std::string> data = q.get<std::optional<std::string>>(0);
             if (data) {
-                response.data = std::make_shared<std::string>(*data);
+                response.data = std::make_shared<std::string>(std::move(*data));
                 response.noContent = false;
                 response.expires = Timestamp::max();
                 response.etag = resource.url;
@@ -263,6 +268,7 @@ private:
 
         auto ptr2 = db_cache.insert(std::pair<std::string, mapbox::sqlite::Database>(
             path, mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly)));
+        ptr2.first->second.exec("PRAGMA mmap_size = " + std::to_string(mmapSize));
         return ptr2.first->second;
     }
 
@@ -1,3 +1,4 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
@@ -13,9 +14,48 @@
 
 namespace mbgl {
 
+namespace {
+
+const util::Codec* getStorageCodec() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_OFFLINE_DATABASE_COMPRESSION);
+    if (const auto* name = value.getString(); name && *name == "zstd") {
+        if (const auto* codec = util::getCodec(util::CodecType::Zstd)) {
+            return codec;
+        }
+        Log::Warning(Event::Database, "zstd isn't available, compressing with zlib");
+    }
+    return util::getCodec(util::CodecType::Zlib);
+}
+
+// Whether both refer to the same row of the ambient cache
+bool isSameEntry(const Resource& lhs, const Resource& rhs) {
+    if (lhs.kind == Resource::Kind::Tile || rhs.kind == Resource::Kind::Tile) {
+        return lhs.kind == rhs.kind && lhs.tileData->urlTemplate == rhs.tileData->urlTemplate &&
+               lhs.tileData->pixelRatio == rhs.tileData->pixelRatio && lhs.tileData->x == rhs.tileData->x &&
+               lhs.tileData->y == rhs.tileData->y && lhs.tileData->z == rhs.tileData->z;
+    }
+    return lhs.url == rhs.url;
+}
+
+// The latest write of the entry left pending in a batch
+auto findPendingPut(std::vector<std::pair<Resource, Response>>& puts, const Resource& resource) {
+    return std::find_if(
+        puts.rbegin(), puts.rend(), [&](const auto& put) { return isSameEntry(put.first, resource); });
+}
+
+// Compressed data is only flagged as such, the codec is told by its magic bytes. Data written
+// before other codecs were supported is always zlib.
+std::string decompress(const std::string& data) {
+    const auto* codec = util::detectCodec(data);
+    return codec ? codec->decompress(data) : util::decompress(data);
+}
+
+} // namespace
+
 OfflineDatabase::OfflineDatabase(std::string path_, const TileServerOptions& options)
     : path(std::move(path_)),
-      tileServerOptions(options) {
+      tileServerOptions(options),
+      codec(getStorageCodec()) {
     try {
         initialize();
     } catch (...) {
@@ -25,6 +65,7 @@ OfflineDatabase::OfflineDatabase(std::string path_, const TileServerOptions& opt
 }
 
 OfflineDatabase::~OfflineDatabase() {
+    flush();
     cleanup();
 }
 
@@ -77,6 +118,7 @@ void OfflineDatabase::initialize() {
 }
 
 void OfflineDatabase::changePath(const std::string& path_) {
+    flush();
     Log::Info(Event::Database, "Changing the database path.");
     cleanup();
     path = path_;
@@ -249,7 +291,29 @@ std::optional<Response> OfflineDatabase::get(const Resource& resource) try {
         return std::nullopt;
     }
 
+    // A pending 304 response only refreshes the expiration of the stored entry, see `put`
+    std::optional<Response> refresh;
+    if (writeBatchSize > 0 && !readOnly) {
+        const auto pending = findPendingPut(pendingPuts, resource);
+        if (pending != pendingPuts.rend()) {
+            if (!pending->second.notModified) {
+                return pending->second;
+            }
+            refresh = pending->second;
+        }
+    }
+
     auto result = getInternal(resource);
+    if (result && refresh) {
+        result->first.expires = refresh->expires;
+        result->first.mustRevalidate = refresh->mustRevalidate;
+    }
+    if (result && writeBatchSize > 0 && !readOnly) {
+        pendingAccessed.push_back(resource);
+        if (pendingAccessed.size() >= writeBatchSize) {
+            flush();
+        }
+    }
     return result ? std::optional<Response>{result->first} : std::nullopt;
 } catch (...) {
     handleError("read resource");
@@ -277,6 +341,22 @@ std::optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) try {
     if (readOnly) return {false, 0};
 
+    if (writeBatchSize > 0) {
+        const auto pending = findPendingPut(pendingPuts, resource);
+        if (response.notModified && pending != pendingPuts.rend()) {
+            // The pending data is still current, only its expiration changes
+            pending->second.expires = response.expires;
+            pending->second.mustRevalidate = response.mustRevalidate;
+        } else if (!response.error) {
+            // 304 responses for stored entries are written as a refresh of their expiration
+            pendingPuts.emplace_back(resource, response);
+        }
+        if (pendingPuts.size() >= writeBatchSize) {
+            flush();
+        }
+        return {false, 0};
+    }
+
     if (!db) {
         initialize();
     }
@@ -308,7 +388,7 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
+        compressedData = codec->compress(*response.data);
         compressed = compressedData.size() < response.data->size();
         size = compressed ? compressedData.size() : response.data->size();
     }
@@ -348,9 +428,101 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     return {inserted, size};
 }
 
+void OfflineDatabase::setWriteBatchSize(std::size_t maxItems) {
+    writeBatchSize = maxItems;
+    if (pendingPuts.size() >= writeBatchSize || pendingAccessed.size() >= writeBatchSize) {
+        flush();
+    }
+}
+
+bool OfflineDatabase::hasPendingWrites() const {
+    return !pendingPuts.empty() || !pendingAccessed.empty();
+}
+
+void OfflineDatabase::flush() try {
+    if (!hasPendingWrites()) {
+        return;
+    }
+
+    // Writes which fail are dropped, like unbatched writes
+    const auto puts = std::move(pendingPuts);
+    const auto accessed = std::move(pendingAccessed);
+    pendingPuts.clear();
+    pendingAccessed.clear();
+
+    if (readOnly) {
+        return;
+    }
+
+    if (!db) {
+        initialize();
+    }
+
+    if (disabled()) {
+        return;
+    }
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+
+    if (!puts.empty()) {
+        // Make room for the whole batch at once, the uncompressed size being an upper bound
+        uint64_t size = 0;
+        for (const auto& put : puts) {
+            size += put.second.data ? put.second.data->size() : 0;
+        }
+
+        DatabaseSizeChangeStats stats(this);
+        if (evict(size, stats)) {
+            for (const auto& put : puts) {
+                putInternal(put.first, put.second, false);
+            }
+        } else {
+            Log::Info(Event::Database, "Unable to make space for entries");
+        }
+        updateAmbientCacheSize(stats);
+    }
+
+    const Timestamp now = util::now();
+    for (const auto& resource : accessed) {
+        updateAccessed(resource, now);
+    }
+
+    transaction.commit();
+} catch (...) {
+    handleError("write resources");
+}
+
+void OfflineDatabase::updateAccessed(const Resource& resource, Timestamp accessed) {
+    if (resource.kind == Resource::Kind::Tile) {
+        // clang-format off
+        mapbox::sqlite::Query accessedQuery{ getStatement(
+            "UPDATE tiles "
+            "SET accessed       = ?1 "
+            "WHERE url_template = ?2 "
+            "  AND pixel_ratio  = ?3 "
+            "  AND x            = ?4 "
+            "  AND y            = ?5 "
+            "  AND z            = ?6 ") };
+        // clang-format on
+
+        accessedQuery.bind(1, accessed);
+        accessedQuery.bind(2, resource.tileData->urlTemplate);
+        accessedQuery.bind(3, resource.tileData->pixelRatio);
+        accessedQuery.bind(4, resource.tileData->x);
+        accessedQuery.bind(5, resource.tileData->y);
+        accessedQuery.bind(6, resource.tileData->z);
+        accessedQuery.run();
+    } else {
+        mapbox::sqlite::Query accessedQuery{getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2")};
+        accessedQuery.bind(1, accessed);
+        accessedQuery.bind(2, resource.url);
+        accessedQuery.run();
+    }
+}
+
 std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
+    // Update accessed timestamp used for LRU eviction, unless it's batched by `get`.
+    if (!readOnly && writeBatchSize == 0) {
         try {
             mapbox::sqlite::Query accessedQuery{getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2")};
             accessedQuery.bind(1, util::now());
@@ -393,7 +565,7 @@ std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const
     if (!data) {
         response.noContent = true;
     } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+        response.data = std::make_shared<std::string>(decompress(*data));
         size = data->length();
     } else {
         response.data = std::make_shared<std::string>(*data);
@@ -501,8 +673,8 @@ bool OfflineDatabase::putResource(const Resource& resource,
 }
 
 std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
+    // Update accessed timestamp used for LRU eviction, unless it's batched by `get`.
+    if (!readOnly && writeBatchSize == 0) {
         try {
             // clang-format off
             mapbox::sqlite::Query accessedQuery{ getStatement(
@@ -567,7 +739,7 @@ std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Reso
     if (!data) {
         response.noContent = true;
     } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
+        response.data = std::make_shared<std::string>(decompress(*data));
         size = data->length();
     } else {
         response.data = std::make_shared<std::string>(*data);
@@ -708,6 +880,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 }
 
 std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
+    flush();
     checkFlags();
 
     // clang-format off
@@ -741,6 +914,10 @@ std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
 }
 
 std::exception_ptr OfflineDatabase::clearAmbientCache() try {
+    // The ambient cache is emptied anyway
+    pendingPuts.clear();
+    pendingAccessed.clear();
+
     checkFlags();
 
     // clang-format off
@@ -774,6 +951,7 @@ std::exception_ptr OfflineDatabase::clearAmbientCache() try {
 }
 
 std::exception_ptr OfflineDatabase::invalidateRegion(int64_t regionID) try {
+    flush();
     checkFlags();
 
     {
@@ -875,6 +1053,7 @@ expected<OfflineRegion, std::exception_ptr> OfflineDatabase::createRegion(const
 }
 
 expected<OfflineRegions, std::exception_ptr> OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
+    flush();
     checkFlags();
 
     try {
@@ -975,6 +1154,7 @@ expected<OfflineRegionMetadata, std::exception_ptr> OfflineDatabase::updateMetad
 }
 
 std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
+    flush();
     checkFlags();
 
     {
@@ -998,13 +1178,20 @@ std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
 }
 
 std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(const Resource& resource) try {
-    return getInternal(resource);
+    flush();
+    auto result = getInternal(resource);
+    if (result && writeBatchSize > 0 && !readOnly) {
+        // Not deferred, region downloads read resources without going through the owner
+        updateAccessed(resource, util::now());
+    }
+    return result;
 } catch (...) {
     handleError("read region resource");
     return std::nullopt;
 }
 
 std::optional<int64_t> OfflineDatabase::hasRegionResource(const Resource& resource) try {
+    flush();
     return hasInternal(resource);
 } catch (...) {
     handleError("query region resource");
@@ -1012,6 +1199,7 @@ std::optional<int64_t> OfflineDatabase::hasRegionResource(const Resource& resour
 }
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) try {
+    flush();
     checkFlags();
 
     if (!db) {
@@ -1029,6 +1217,7 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& re
 void OfflineDatabase::putRegionResources(int64_t regionID,
                                          const std::list<std::tuple<Resource, Response>>& resources,
                                          OfflineRegionStatus& status) try {
+    flush();
     checkFlags();
 
     if (!db) {
@@ -1253,21 +1442,25 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& st
     uint64_t newAmbientCacheSize = ambientCacheSize + neededFreeSize + stats.pageSize();
 
     while (newAmbientCacheSize > maximumAmbientCacheSize) {
+        // Each table is read in the order of its accessed index, stopping after the first rows
+        // not used by any region, so that only those rows are visited rather than the whole cache.
         // clang-format off
         mapbox::sqlite::Query accessedQuery{ getStatement(
             "SELECT max(accessed) "
             "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
+            "    SELECT accessed FROM ( "
+            "        SELECT accessed "
+            "        FROM resources "
+            "        WHERE NOT EXISTS (SELECT 1 FROM region_resources WHERE resource_id = resources.id) "
+            "        ORDER BY accessed ASC LIMIT ?1 "
+            "    ) "
             "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
+            "    SELECT accessed FROM ( "
+            "        SELECT accessed "
+            "        FROM tiles "
+            "        WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = tiles.id) "
+            "        ORDER BY accessed ASC LIMIT ?1 "
+            "    ) "
             "  ORDER BY accessed ASC LIMIT ?1 "
             ") "
         ) };
@@ -1281,13 +1474,8 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& st
         // clang-format off
         mapbox::sqlite::Query resourceQuery{ getStatement(
             "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
+            "WHERE accessed <= ?1 "
+            "AND NOT EXISTS (SELECT 1 FROM region_resources WHERE resource_id = resources.id) ") };
         // clang-format on
         resourceQuery.bind(1, accessed);
         resourceQuery.run();
@@ -1296,13 +1484,8 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& st
         // clang-format off
         mapbox::sqlite::Query tileQuery{ getStatement(
             "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ") };
+            "WHERE accessed <= ?1 "
+            "AND NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = tiles.id) ") };
         // clang-format on
         tileQuery.bind(1, accessed);
         tileQuery.run();
@@ -1377,6 +1560,7 @@ std::exception_ptr OfflineDatabase::initAmbientCacheSize() {
 }
 
 std::exception_ptr OfflineDatabase::setMaximumAmbientCacheSize(uint64_t size) {
+    flush();
     uint64_t previousMaximumAmbientCacheSize = maximumAmbientCacheSize;
 
     if (auto exception = initAmbientCacheSize()) {
@@ -1446,6 +1630,7 @@ bool OfflineDatabase::exceedsOfflineMapboxTileCountLimit(const Resource& resourc
 }
 
 void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resource>& resources) try {
+    flush();
     if (!db) {
         initialize();
     }
@@ -1459,6 +1644,7 @@ void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resour
 }
 
 std::exception_ptr OfflineDatabase::pack() try {
+    flush();
     if (!db) initialize();
     vacuum();
     return nullptr;
@@ -1468,6 +1654,8 @@ std::exception_ptr OfflineDatabase::pack() try {
 }
 
 std::exception_ptr OfflineDatabase::resetDatabase() try {
+    pendingPuts.clear();
+    pendingAccessed.clear();
     removeExisting();
     initialize();
     return nullptr;
@@ -1478,6 +1666,7 @@ std::exception_ptr OfflineDatabase::resetDatabase() try {
 
 void OfflineDatabase::reopenDatabaseReadOnly(bool readOnly_) {
     if (readOnly == readOnly_) return;
+    flush();
     try {
         cleanup();
         readOnly = readOnly_;
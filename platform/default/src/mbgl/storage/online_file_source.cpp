@@ -25,9 +25,10 @@
 
 #include <algorithm>
 #include <cassert>
-#include <list>
 #include <map>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -220,63 +221,72 @@ private:
         }
     }
 
-    // Using Pending Requests as an priority queue which processes
-    // file requests in a FIFO manner but prefers regular requests
-    // over offline requests with a low priority such that low priority
-    // requests do not throttle regular requests.
-    //
-    // The order of a queue is therefore:
-    //
-    // hi0 -- hi1 -- hi2 -- hi3 -- lo0 -- lo1 --lo2
-    //                              ^
-    //                              firstLowPriorityRequest
-
+    // Pending requests form a heap, ordered by priority class first so that low priority
+    // requests (e.g. for offline regions) do not throttle regular requests, then by the
+    // resource's load priority, and in FIFO order otherwise. Load priorities may change while
+    // requests are pending, e.g. as tiles move relative to the center of the viewport, so the
+    // heap is rebuilt before taking the next request whenever any of them changed.
     struct PendingRequests {
-        PendingRequests()
-            : firstLowPriorityRequest(queue.begin()) {}
+        struct Entry {
+            OnlineFileRequest* request;
+            bool low;
+            float loadPriority;
+            uint64_t sequence;
+        };
+
+        std::vector<Entry> heap;
+        uint64_t nextSequence = 0;
+        uint64_t generation = LoadPriority::generation();
+
+        // The standard heap functions put the greatest element first, so compare in reverse
+        static bool after(const Entry& a, const Entry& b) {
+            return std::tie(a.low, a.loadPriority, a.sequence) > std::tie(b.low, b.loadPriority, b.sequence);
+        }
 
-        std::list<OnlineFileRequest*> queue;
-        std::list<OnlineFileRequest*>::iterator firstLowPriorityRequest;
+        static float currentLoadPriority(const OnlineFileRequest* request) {
+            const auto& loadPriority = request->resource.loadPriority;
+            return loadPriority ? loadPriority->get() : 0.0f;
+        }
 
         void remove(const OnlineFileRequest* request) {
-            auto it = std::find(queue.begin(), queue.end(), request);
-            if (it != queue.end()) {
-                if (it == firstLowPriorityRequest) {
-                    firstLowPriorityRequest++;
-                }
-                queue.erase(it);
+            auto it = std::find_if(
+                heap.begin(), heap.end(), [&](const Entry& entry) { return entry.request == request; });
+            if (it != heap.end()) {
+                heap.erase(it);
+                std::make_heap(heap.begin(), heap.end(), after);
             }
         }
 
         void insert(OnlineFileRequest* request) {
-            if (request->resource.priority == Resource::Priority::Regular) {
-                firstLowPriorityRequest = queue.insert(firstLowPriorityRequest, request);
-                firstLowPriorityRequest++;
-            } else {
-                if (firstLowPriorityRequest == queue.end()) {
-                    firstLowPriorityRequest = queue.insert(queue.end(), request);
-                } else {
-                    queue.insert(queue.end(), request);
-                }
-            }
+            heap.push_back({.request = request,
+                            .low = request->resource.priority == Resource::Priority::Low,
+                            .loadPriority = currentLoadPriority(request),
+                            .sequence = nextSequence++});
+            std::push_heap(heap.begin(), heap.end(), after);
         }
 
         std::optional<OnlineFileRequest*> pop() {
-            if (queue.empty()) {
+            if (heap.empty()) {
                 return {};
             }
 
-            if (queue.begin() == firstLowPriorityRequest) {
-                firstLowPriorityRequest++;
+            if (const auto current = LoadPriority::generation(); current != generation) {
+                generation = current;
+                for (auto& entry : heap) {
+                    entry.loadPriority = currentLoadPriority(entry.request);
+                }
+                std::make_heap(heap.begin(), heap.end(), after);
             }
 
-            OnlineFileRequest* next = queue.front();
-            queue.pop_front();
+            std::pop_heap(heap.begin(), heap.end(), after);
+            OnlineFileRequest* next = heap.back().request;
+            heap.pop_back();
             return {next};
         }
 
         bool contains(OnlineFileRequest* request) const {
-            return (std::find(queue.begin(), queue.end(), request) != queue.end());
+            return std::any_of(
+                heap.begin(), heap.end(), [&](const Entry& entry) { return entry.request == request; });
         }
     };
 
@@ -1,9 +1,15 @@
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
 #include <map>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
 
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/file_source_manager.hpp>
 #include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/pmtiles_directory_cache.hpp>
 #include <mbgl/storage/pmtiles_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 
@@ -12,6 +18,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/chrono.hpp>
@@ -23,6 +30,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if defined(__QT__) && (defined(_WIN32) || defined(__EMSCRIPTEN__))
 #include <QtZlib/zlib.h>
 #else
@@ -34,9 +47,15 @@ namespace {
 constexpr int pmtilesHeaderOffset = 0;
 constexpr int pmtilesHeaderLength = 127;
 
-// To avoid allocating lots of memory with PMTiles directory caching,
-// set a limit so it doesn't grow unlimited
-constexpr int MAX_DIRECTORY_CACHE_ENTRIES = 100;
+// To avoid allocating lots of memory with PMTiles directory caching, the directories of all
+// archives share a budget, see `platform::EXPERIMENTAL_PMTILES_DIRECTORY_CACHE_MAX_BYTES`
+constexpr std::size_t defaultDirectoryCacheBytes = 32 * 1024 * 1024;
+
+// Leaf directories fetched ahead while tiles are requested along a range of tile IDs
+constexpr std::size_t maxDirectoryPrefetches = 4;
+
+// How often tile requests check whether a mapped archive was replaced on disk
+constexpr mbgl::Duration mappingRevalidationInterval = std::chrono::seconds(1);
 
 bool acceptsURL(const std::string& url) {
     return url.starts_with(mbgl::util::PMTILES_PROTOCOL);
@@ -45,6 +64,122 @@ bool acceptsURL(const std::string& url) {
 std::string extract_url(const std::string& url) {
     return url.substr(std::char_traits<char>::length(mbgl::util::PMTILES_PROTOCOL));
 }
+
+// Read-only mapping of a local archive. Ranges are read straight from the page cache, which is
+// shared with every other process reading the same archive, instead of being read into new
+// buffers one request at a time. Reading a mapped page past the end of a truncated file raises
+// SIGBUS, so the size of the open file is checked before every read. Once the file was modified
+// the mapping is stale, and ranges are read from the file instead until it's mapped again.
+class MappedFile {
+public:
+    // Returns null if the file can't be mapped, it's then read through the file source instead
+    static std::shared_ptr<const MappedFile> open(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return nullptr;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat buf;
+        void* data = MAP_FAILED;
+        std::size_t size = 0;
+        // Archives which don't fit the address space are read in ranges instead
+        if (fstat(fd, &buf) == 0 && S_ISREG(buf.st_mode) && buf.st_size > 0 &&
+            static_cast<uintmax_t>(buf.st_size) <= SIZE_MAX) {
+            size = static_cast<std::size_t>(buf.st_size);
+            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return nullptr;
+        }
+        return std::shared_ptr<const MappedFile>(new MappedFile(fd, static_cast<const char*>(data), size, buf));
+#endif
+    }
+
+    // Whether the file at `path` is still the one mapped, it's not when another file was moved over it
+    bool isCurrent([[maybe_unused]] const std::string& path) const {
+#ifdef _WIN32
+        return false;
+#else
+        struct stat buf;
+        return !stale && ::stat(path.c_str(), &buf) == 0 && isUnchanged(buf);
+#endif
+    }
+
+    // Whether a read found the file modified since it was mapped
+    bool isStale() const { return stale; }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        munmap(const_cast<char*>(data), size);
+        ::close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Reads from the mapping, or into `buffer` once the file was modified
+    std::optional<std::string_view> read([[maybe_unused]] uint64_t offset,
+                                         [[maybe_unused]] uint64_t length,
+                                         [[maybe_unused]] std::string& buffer) const {
+#ifdef _WIN32
+        return std::nullopt;
+#else
+        struct stat buf;
+        if (fstat(fd, &buf) != 0) {
+            return std::nullopt;
+        }
+        if (!isUnchanged(buf)) {
+            stale = true;
+        }
+        const auto fileSize = static_cast<uint64_t>(buf.st_size);
+        if (offset > fileSize || length > fileSize - offset) {
+            return std::nullopt;
+        }
+        if (!stale) {
+            return std::string_view(data + offset, static_cast<std::size_t>(length));
+        }
+
+        buffer.resize(static_cast<std::size_t>(length));
+        std::size_t done = 0;
+        while (done < buffer.size()) {
+            const auto count = ::pread(fd, buffer.data() + done, buffer.size() - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return std::nullopt;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        return std::string_view(buffer);
+#endif
+    }
+
+private:
+    MappedFile(int fd_, const char* data_, std::size_t size_, const struct stat& version_)
+        : fd(fd_),
+          data(data_),
+          size(size_),
+          version(version_) {}
+
+    bool isUnchanged(const struct stat& buf) const {
+        return buf.st_dev == version.st_dev && buf.st_ino == version.st_ino && buf.st_size == version.st_size &&
+               buf.st_mtime == version.st_mtime;
+    }
+
+    // Kept open to check and read the file the mapping belongs to
+    const int fd;
+    const char* data;
+    std::size_t size;
+    const struct stat version;
+    mutable bool stale = false;
+};
 } // namespace
 
 // temporary, remove this when it's available in `pmtiles.hpp`
@@ -55,18 +190,85 @@ const uint8_t TILETYPE_MLT = 0x6;
 namespace mbgl {
 using namespace rapidjson;
 
+namespace {
+
+using Directory = PMTilesDirectory;
+using DirectoryKey = PMTilesDirectoryKey;
+
+std::size_t getDirectoryCacheBytes() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PMTILES_DIRECTORY_CACHE_MAX_BYTES);
+    if (const auto* uintValue = value.getUint()) {
+        return static_cast<std::size_t>(*uintValue);
+    } else if (const auto* intValue = value.getInt(); intValue && *intValue >= 0) {
+        return static_cast<std::size_t>(*intValue);
+    }
+    return defaultDirectoryCacheBytes;
+}
+
+// Index of the entry covering the tile: the tile itself, a run of tiles including it, or the leaf
+// directory it may be listed in. Entries are sorted by tile ID.
+std::optional<std::size_t> findEntry(const std::vector<pmtiles::entryv3>& entries, uint64_t tileID) {
+    auto it = std::upper_bound(entries.begin(), entries.end(), tileID, [](uint64_t id, const pmtiles::entryv3& entry) {
+        return id < entry.tile_id;
+    });
+    if (it == entries.begin()) {
+        return std::nullopt;
+    }
+    --it;
+    if (it->length == 0 || (it->run_length > 0 && tileID - it->tile_id >= it->run_length)) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(it - entries.begin());
+}
+
+// Codec of a PMTiles compression type, null if the data isn't compressed or the codec isn't available
+const util::Codec* getCodec(uint8_t compression) {
+    switch (compression) {
+        case pmtiles::COMPRESSION_GZIP:
+            return util::getCodec(util::CodecType::Gzip);
+        case pmtiles::COMPRESSION_BROTLI:
+            return util::getCodec(util::CodecType::Brotli);
+        case pmtiles::COMPRESSION_ZSTD:
+            return util::getCodec(util::CodecType::Zstd);
+        default:
+            return nullptr;
+    }
+}
+
+bool isSupported(uint8_t compression) {
+    return compression == pmtiles::COMPRESSION_NONE || getCodec(compression);
+}
+
+std::string decompress(uint8_t compression, std::string_view data) {
+    const auto* codec = getCodec(compression);
+    // Some writers store zlib streams in archives marked as gzip, both are read
+    if (compression == pmtiles::COMPRESSION_GZIP) {
+        if (const auto* detected = util::detectCodec(data); detected && detected->type() == util::CodecType::Zlib) {
+            codec = detected;
+        }
+    }
+    return codec ? codec->decompress(data) : std::string(data);
+}
+
+} // namespace
+
 using AsyncCallback = std::function<void(std::unique_ptr<Response::Error>)>;
+using AsyncDirectoryCallback = std::function<void(Directory, std::unique_ptr<Response::Error>)>;
 using AsyncTileCallback = std::function<void(std::pair<uint64_t, uint32_t>, std::unique_ptr<Response::Error>)>;
+// Called with the response for a byte range and its data, which is only valid during the call
+using AsyncRangeCallback = std::function<void(const Response&, std::string_view)>;
 
 class PMTilesFileSource::Impl {
 public:
     explicit Impl(const ActorRef<Impl>&, const ResourceOptions& resourceOptions_, const ClientOptions& clientOptions_)
         : resourceOptions(resourceOptions_.clone()),
-          clientOptions(clientOptions_.clone()) {}
+          clientOptions(clientOptions_.clone()),
+          directoryCache(getDirectoryCacheBytes()) {}
 
     // Generate a tilejson resource from .pmtiles file
     void request_tilejson(AsyncRequest* req, const Resource& resource, const ActorRef<FileSourceRequest>& ref) {
         auto url = extract_url(resource.url);
+        revalidate(url, true);
 
         getMetadata(url, req, [=, this](std::unique_ptr<Response::Error> error) {
             Response response;
@@ -85,6 +287,7 @@ public:
     // Load data for specific tile
     void request_tile(AsyncRequest* req, const Resource& resource, ActorRef<FileSourceRequest> ref) {
         auto url = extract_url(resource.url);
+        revalidate(url);
 
         getHeader(url, req, [=, this](std::unique_ptr<Response::Error> error) {
             if (error) {
@@ -142,36 +345,39 @@ public:
                         return;
                     }
 
-                    Resource tileResource(Resource::Kind::Source, url);
-                    tileResource.loadingMethod = Resource::LoadingMethod::Network;
-                    tileResource.dataRange = std::make_pair(tileAddress.first,
-                                                            tileAddress.first + tileAddress.second - 1);
-
-                    tasks[req] = getFileSource()->request(tileResource, [=](const Response& tileResponse) {
-                        Response response;
-                        response.noContent = true;
+                    tasks[req] = requestRange(
+                        url,
+                        tileAddress.first,
+                        tileAddress.second,
+                        [=](const Response& tileResponse, std::string_view tileData) {
+                            Response response;
+                            response.noContent = true;
+
+                            if (tileResponse.error) {
+                                response.error = std::make_unique<Response::Error>(
+                                    tileResponse.error->reason,
+                                    std::string("Error fetching PMTiles tile: ") + tileResponse.error->message);
+                                ref.invoke(&FileSourceRequest::setResponse, response);
+                                return;
+                            }
+
+                            response.noContent = false;
+                            response.modified = tileResponse.modified;
+                            response.expires = tileResponse.expires;
+                            response.etag = tileResponse.etag;
+
+                            if (header.tile_compression != pmtiles::COMPRESSION_NONE) {
+                                response.data = std::make_shared<std::string>(
+                                    decompress(header.tile_compression, tileData));
+                            } else if (tileResponse.data) {
+                                response.data = tileResponse.data;
+                            } else {
+                                response.data = std::make_shared<std::string>(tileData);
+                            }
 
-                        if (tileResponse.error) {
-                            response.error = std::make_unique<Response::Error>(
-                                tileResponse.error->reason,
-                                std::string("Error fetching PMTiles tile: ") + tileResponse.error->message);
                             ref.invoke(&FileSourceRequest::setResponse, response);
                             return;
-                        }
-
-                        response.data = tileResponse.data;
-                        response.noContent = false;
-                        response.modified = tileResponse.modified;
-                        response.expires = tileResponse.expires;
-                        response.etag = tileResponse.etag;
-
-                        if (header.tile_compression == pmtiles::COMPRESSION_GZIP) {
-                            response.data = std::make_shared<std::string>(util::decompress(*tileResponse.data));
-                        }
-
-                        ref.invoke(&FileSourceRequest::setResponse, response);
-                        return;
-                    });
+                        });
                 });
         });
     }
@@ -205,10 +411,24 @@ private:
     std::shared_ptr<FileSource> fileSource;
     std::map<std::string, pmtiles::headerv3> header_cache;
     std::map<std::string, std::string> metadata_cache;
-    std::map<std::string, std::map<std::string, std::vector<pmtiles::entryv3>>> directory_cache;
-    std::map<std::string, std::vector<std::string>> directory_cache_control;
+    PMTilesDirectoryCache directoryCache;
+    struct Mapping {
+        // Null for archives which aren't local or can't be mapped
+        std::shared_ptr<const MappedFile> file;
+        TimePoint validated;
+    };
+    std::map<std::string, Mapping> mappedFiles;
     std::map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
 
+    // The leaf directory most recently looked up in each archive, as its parent and its index there
+    struct LeafPosition {
+        DirectoryKey parent;
+        std::size_t index;
+    };
+    std::map<std::string, LeafPosition> lastLeaf;
+    std::unordered_map<DirectoryKey, std::unique_ptr<AsyncRequest>, PMTilesDirectoryKeyHash> prefetches;
+    std::vector<DirectoryKey> finishedPrefetches;
+
     std::shared_ptr<FileSource> getFileSource() {
         if (!fileSource) {
             fileSource = FileSourceManager::get()->getFileSource(
@@ -218,19 +438,100 @@ private:
         return fileSource;
     }
 
-    void getHeader(const std::string& url, AsyncRequest* req, AsyncCallback callback) {
-        if (header_cache.contains(url)) {
-            callback(std::unique_ptr<Response::Error>());
+    static std::string getLocalPath(const std::string& url) {
+        return util::percentDecode(url.substr(std::char_traits<char>::length(util::FILE_PROTOCOL)));
+    }
+
+    std::shared_ptr<const MappedFile> getMappedFile(const std::string& url) {
+        if (!url.starts_with(util::FILE_PROTOCOL)) {
+            return nullptr;
+        }
+
+        auto it = mappedFiles.find(url);
+        if (it == mappedFiles.end()) {
+            it = mappedFiles.emplace(url, Mapping{MappedFile::open(getLocalPath(url)), Clock::now()}).first;
+        }
+        return it->second.file;
+    }
+
+    // Forgets everything read from a mapped archive once the file was replaced or modified,
+    // it's then mapped and read again. Unless `force`d, the file is checked at most once per
+    // `mappingRevalidationInterval`, modifications are also found by the reads themselves.
+    void revalidate(const std::string& url, bool force = false) {
+        const auto it = mappedFiles.find(url);
+        if (it == mappedFiles.end() || !it->second.file) {
+            return;
+        }
+        const auto now = Clock::now();
+        if (!force && !it->second.file->isStale() && now - it->second.validated < mappingRevalidationInterval) {
+            return;
+        }
+        if (it->second.file->isCurrent(getLocalPath(url))) {
+            it->second.validated = now;
+            return;
+        }
+
+        mappedFiles.erase(it);
+        header_cache.erase(url);
+        metadata_cache.erase(url);
+        lastLeaf.erase(url);
+        directoryCache.erase(url);
+    }
+
+    // Reads a range of the archive. Local archives are read from their mapping, the callback is
+    // then posted to this thread so it never runs before the returned request is stored.
+    std::unique_ptr<AsyncRequest> requestRange(const std::string& url,
+                                               uint64_t offset,
+                                               uint64_t length,
+                                               AsyncRangeCallback callback) {
+        if (auto mappedFile = getMappedFile(url)) {
+            return util::RunLoop::Get()->invokeCancellable(
+                [=, this, callback = std::move(callback), mappedFile = std::move(mappedFile)] {
+                    Response response;
+                    const auto it = mappedFiles.find(url);
+                    if (it == mappedFiles.end() || it->second.file != mappedFile) {
+                        // Replaced after this read was requested, don't mix data of both archives
+                        response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                                           "PMTiles archive changed while reading");
+                        callback(response, std::string_view());
+                        return;
+                    }
+
+                    std::string buffer;
+                    const auto data = mappedFile->read(offset, length, buffer);
+                    if (!data) {
+                        response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                                           "Range outside of the PMTiles archive");
+                    }
+                    callback(response, data.value_or(std::string_view()));
+                    // Archives modified in place are mapped again by the next request
+                    if (!data || mappedFile->isStale()) {
+                        revalidate(url, true);
+                    }
+                });
         }
 
         Resource resource(Resource::Kind::Source, url);
         resource.loadingMethod = Resource::LoadingMethod::Network;
+        resource.dataRange = std::make_pair(offset, offset + length - 1);
+
+        return getFileSource()->request(resource, [callback = std::move(callback)](const Response& response) {
+            callback(response, response.data ? std::string_view(*response.data) : std::string_view());
+        });
+    }
 
-        resource.dataRange = std::make_pair<uint64_t, uint64_t>(pmtilesHeaderOffset,
-                                                                pmtilesHeaderOffset + pmtilesHeaderLength - 1);
+    void getHeader(const std::string& url, AsyncRequest* req, AsyncCallback callback) {
+        if (header_cache.contains(url)) {
+            callback(std::unique_ptr<Response::Error>());
+            return;
+        }
 
-        tasks[req] = getFileSource()->request(
-            resource, [=, this](const Response& response) { // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+        tasks[req] = requestRange(
+            url,
+            pmtilesHeaderOffset,
+            pmtilesHeaderLength,
+            [=, this](const Response& response,
+                      std::string_view data) { // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
                 if (response.error) {
                     std::string message = std::string("Error fetching PMTiles header: ") + response.error->message;
 
@@ -250,12 +551,10 @@ private:
                 }
 
                 try {
-                    pmtiles::headerv3 header = pmtiles::deserialize_header(response.data->substr(0, 127));
+                    pmtiles::headerv3 header = pmtiles::deserialize_header(
+                        std::string(data.substr(0, pmtilesHeaderLength)));
 
-                    if ((header.internal_compression != pmtiles::COMPRESSION_NONE &&
-                         header.internal_compression != pmtiles::COMPRESSION_GZIP) ||
-                        (header.tile_compression != pmtiles::COMPRESSION_NONE &&
-                         header.tile_compression != pmtiles::COMPRESSION_GZIP)) {
+                    if (!isSupported(header.internal_compression) || !isSupported(header.tile_compression)) {
                         throw std::runtime_error("Compression method not supported");
                     }
 
@@ -272,6 +571,7 @@ private:
     void getMetadata(std::string& url, AsyncRequest* req, AsyncCallback callback) {
         if (metadata_cache.contains(url)) {
             callback(std::unique_ptr<Response::Error>());
+            return;
         }
 
         getHeader(
@@ -385,28 +685,22 @@ private:
                 };
 
                 if (header.json_metadata_bytes > 0) {
-                    Resource resource(Resource::Kind::Source, url);
-                    resource.loadingMethod = Resource::LoadingMethod::Network;
-                    resource.dataRange = std::make_pair(header.json_metadata_offset,
-                                                        header.json_metadata_offset + header.json_metadata_bytes - 1);
-
-                    tasks[req] = getFileSource()->request(resource, [=](const Response& responseMetadata) {
-                        if (responseMetadata.error) {
-                            callback(std::make_unique<Response::Error>(
-                                responseMetadata.error->reason,
-                                std::string("Error fetching PMTiles metadata: ") + responseMetadata.error->message));
-
-                            return;
-                        }
-
-                        std::string data = *responseMetadata.data;
-
-                        if (header.internal_compression == pmtiles::COMPRESSION_GZIP) {
-                            data = util::decompress(data);
-                        }
-
-                        parse_callback(data);
-                    });
+                    tasks[req] = requestRange(
+                        url,
+                        header.json_metadata_offset,
+                        header.json_metadata_bytes,
+                        [=](const Response& responseMetadata, std::string_view data) {
+                            if (responseMetadata.error) {
+                                callback(std::make_unique<Response::Error>(
+                                    responseMetadata.error->reason,
+                                    std::string("Error fetching PMTiles metadata: ") +
+                                        responseMetadata.error->message));
+
+                                return;
+                            }
+
+                            parse_callback(decompress(header.internal_compression, data));
+                        });
 
                     return;
                 }
@@ -415,89 +709,84 @@ private:
             });
     }
 
-    void storeDirectory(const std::string& url,
-                        uint64_t directoryOffset,
-                        uint64_t directoryLength,
-                        const std::string& directoryData) {
-        if (!directory_cache.contains(url)) {
-            directory_cache.emplace(url, std::map<std::string, std::vector<pmtiles::entryv3>>());
-            directory_cache_control.emplace(url, std::vector<std::string>());
-        }
+    std::unique_ptr<AsyncRequest> fetchDirectory(const DirectoryKey& key,
+                                                 const pmtiles::headerv3& header,
+                                                 AsyncDirectoryCallback callback) {
+        return requestRange(
+            key.url, key.offset, key.length, [=, this](const Response& response, std::string_view data) {
+                if (response.error) {
+                    callback(nullptr,
+                             std::make_unique<Response::Error>(
+                                 response.error->reason,
+                                 std::string("Error fetching PMTiles directory: ") + response.error->message));
 
-        std::string directory_cache_key = url + "|" + std::to_string(directoryOffset) + "|" +
-                                          std::to_string(directoryLength);
-        directory_cache.at(url).emplace(directory_cache_key, pmtiles::deserialize_directory(directoryData));
-        directory_cache_control.at(url).emplace_back(directory_cache_key);
+                    return;
+                }
 
-        if (directory_cache_control.at(url).size() > MAX_DIRECTORY_CACHE_ENTRIES) {
-            directory_cache.at(url).erase(directory_cache_control.at(url).front());
-            directory_cache_control.at(url).erase(directory_cache_control.at(url).begin());
-        }
-    }
+                try {
+                    const std::string directoryData = decompress(header.internal_compression, data);
 
-    void getDirectory(const std::string& url,
-                      AsyncRequest* req,
-                      uint64_t directoryOffset,
-                      uint32_t directoryLength,
-                      AsyncCallback callback) {
-        std::string directory_cache_key = url + "|" + std::to_string(directoryOffset) + "|" +
-                                          std::to_string(directoryLength);
-
-        if (directory_cache.contains(url) && directory_cache.at(url).contains(directory_cache_key)) {
-            if (directory_cache_control.at(url).back() != directory_cache_key) {
-                directory_cache_control.at(url).emplace_back(directory_cache_key);
-
-                for (auto it = directory_cache_control.at(url).begin(); it != directory_cache_control.at(url).end();
-                     ++it) {
-                    if (*it == directory_cache_key) {
-                        directory_cache_control.at(url).erase(it);
-                        break;
-                    }
+                    callback(directoryCache.put(key, pmtiles::deserialize_directory(directoryData)), {});
+                } catch (const std::exception& e) {
+                    callback(nullptr,
+                             std::make_unique<Response::Error>(
+                                 Response::Error::Reason::Other,
+                                 std::string(std::string("Error parsing PMTiles directory: ") + e.what())));
                 }
-            }
+            });
+    }
 
-            callback(std::unique_ptr<Response::Error>());
+    void getDirectory(const DirectoryKey& key, AsyncRequest* req, AsyncDirectoryCallback callback) {
+        if (auto directory = directoryCache.get(key)) {
+            callback(std::move(directory), {});
             return;
         }
 
-        getHeader(url, req, [=, this](std::unique_ptr<Response::Error> error) {
+        getHeader(key.url, req, [=, this](std::unique_ptr<Response::Error> error) {
             if (error) {
-                callback(std::move(error));
+                callback(nullptr, std::move(error));
                 return;
             }
 
-            pmtiles::headerv3 header = header_cache.at(url);
-
-            Resource resource(Resource::Kind::Source, url);
-            resource.loadingMethod = Resource::LoadingMethod::Network;
-            resource.dataRange = std::make_pair(directoryOffset, directoryOffset + directoryLength - 1);
+            tasks[req] = fetchDirectory(key, header_cache.at(key.url), callback);
+        });
+    }
 
-            tasks[req] = getFileSource()->request(resource, [=, this](const Response& response) {
-                if (response.error) {
-                    callback(std::make_unique<Response::Error>(
-                        response.error->reason,
-                        std::string("Error fetching PMTiles directory: ") + response.error->message));
+    // Fetches a leaf directory ahead of the tiles listed in it, without holding up any request
+    void prefetchDirectory(const DirectoryKey& key) {
+        for (const auto& finished : finishedPrefetches) {
+            prefetches.erase(finished);
+        }
+        finishedPrefetches.clear();
 
-                    return;
-                }
+        if (prefetches.size() >= maxDirectoryPrefetches || prefetches.contains(key) || directoryCache.contains(key)) {
+            return;
+        }
 
-                try {
-                    std::string directoryData = *response.data;
+        prefetches[key] = fetchDirectory(
+            key, header_cache.at(key.url), [=, this](Directory, std::unique_ptr<Response::Error>) {
+                // Failures are left to the request which needs the directory
+                finishedPrefetches.push_back(key);
+            });
+    }
 
-                    if (header.internal_compression == pmtiles::COMPRESSION_GZIP) {
-                        directoryData = util::decompress(directoryData);
-                    }
+    // Prefetches the next leaf directory when consecutive leaves of a directory are looked up in order
+    void trackLeaf(const DirectoryKey& parent, const std::vector<pmtiles::entryv3>& entries, std::size_t index) {
+        const auto it = lastLeaf.find(parent.url);
+        const bool streaming = it != lastLeaf.end() && it->second.parent == parent &&
+                               it->second.index + 1 == index;
+        lastLeaf.insert_or_assign(parent.url, LeafPosition{parent, index});
 
-                    storeDirectory(url, directoryOffset, directoryLength, directoryData);
+        // Mapped archives are read without waiting, leaves are decoded when needed
+        if (!streaming || index + 1 >= entries.size() || getMappedFile(parent.url)) {
+            return;
+        }
 
-                    callback(std::unique_ptr<Response::Error>());
-                } catch (const std::exception& e) {
-                    callback(std::make_unique<Response::Error>(
-                        Response::Error::Reason::Other,
-                        std::string(std::string("Error parsing PMTiles directory: ") + e.what())));
-                }
-            });
-        });
+        const auto& next = entries[index + 1];
+        if (next.run_length == 0 && next.length > 0) {
+            const auto& header = header_cache.at(parent.url);
+            prefetchDirectory({parent.url, header.leaf_dirs_offset + next.offset, next.length});
+        }
     }
 
     void getTileAddress(const std::string& url,
@@ -516,29 +805,32 @@ private:
             return;
         }
 
+        DirectoryKey key{url, directoryOffset, directoryLength};
+
         getDirectory(
-            url,
+            key,
             req,
-            directoryOffset,
-            directoryLength,
-            [=, this](std::unique_ptr<Response::Error> error) { // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
+            [=, this](Directory directory,
+                      std::unique_ptr<Response::Error> error) { // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
                 if (error) {
                     callback(std::make_pair(0, 0), std::move(error));
                     return;
                 }
 
                 pmtiles::headerv3 header = header_cache.at(url);
-                std::vector<pmtiles::entryv3> directory = directory_cache.at(url).at(
-                    url + "|" + std::to_string(directoryOffset) + "|" + std::to_string(directoryLength));
 
-                pmtiles::entryv3 entry = pmtiles::find_tile(directory, tileID);
+                const auto index = findEntry(*directory, tileID);
+
+                if (index) {
+                    const pmtiles::entryv3& entry = (*directory)[*index];
 
-                if (entry.length > 0) {
                     if (entry.run_length > 0) {
                         callback(std::make_pair(header.tile_data_offset + entry.offset, entry.length), {});
                         return;
                     }
 
+                    trackLeaf(key, *directory, *index);
+
                     getTileAddress(url,
                                    req,
                                    tileID,
@@ -6,9 +6,21 @@
 #include <zlib.h>
 #endif
 
+#ifdef MLN_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef MLN_WITH_BROTLI
+#include <brotli/decode.h>
+#include <brotli/encode.h>
+#endif
+
+#include <array>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 
 // Check zlib library version.
 [[maybe_unused]] const static bool zlibVersionCheck = []() {
@@ -54,7 +66,7 @@ bool is_compressed(const std::string &v) {
     return false;
 }
 
-std::string compress(const std::string &raw, int windowBits) {
+std::string compress(std::string_view raw, int windowBits) {
     z_stream deflate_stream;
     memset(&deflate_stream, 0, sizeof(deflate_stream));
 
@@ -89,7 +101,7 @@ std::string compress(const std::string &raw, int windowBits) {
     return result;
 }
 
-std::string decompress(const std::string &raw, int windowBits) {
+std::string decompress(std::string_view raw, int windowBits) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
@@ -137,5 +149,211 @@ std::uint32_t crc32(const void *raw, size_t size) noexcept {
     return static_cast<std::uint32_t>(hash);
 }
 
+namespace {
+
+constexpr std::size_t chunkSize = 16384;
+
+class ZlibCodec final : public Codec {
+public:
+    ZlibCodec(CodecType type_, int windowBits_)
+        : codecType(type_),
+          windowBits(windowBits_) {}
+
+    CodecType type() const override { return codecType; }
+
+    bool matches(std::string_view raw) const override {
+        if (raw.size() < 2) {
+            return false;
+        }
+        const auto byte0 = static_cast<uint8_t>(raw[0]);
+        const auto byte1 = static_cast<uint8_t>(raw[1]);
+        if (codecType == CodecType::Gzip) {
+            return byte0 == 0x1f && byte1 == 0x8b;
+        }
+        // zlib (rfc1950): deflate with a window of up to 32K, and a valid header checksum
+        return (byte0 & 0x0f) == 8 && (byte0 >> 4) <= 7 && ((byte0 << 8) | byte1) % 31 == 0;
+    }
+
+    std::string compress(std::string_view raw) const override { return util::compress(raw, windowBits); }
+
+    std::string decompress(std::string_view raw) const override { return util::decompress(raw, windowBits); }
+
+private:
+    const CodecType codecType;
+    const int windowBits;
+};
+
+#ifdef MLN_WITH_ZSTD
+class ZstdCodec final : public Codec {
+public:
+    CodecType type() const override { return CodecType::Zstd; }
+
+    bool matches(std::string_view raw) const override {
+        return raw.size() >= 4 && static_cast<uint8_t>(raw[0]) == 0x28 && static_cast<uint8_t>(raw[1]) == 0xb5 &&
+               static_cast<uint8_t>(raw[2]) == 0x2f && static_cast<uint8_t>(raw[3]) == 0xfd;
+    }
+
+    std::string compress(std::string_view raw) const override {
+        std::string result(ZSTD_compressBound(raw.size()), '\0');
+        const std::size_t size = ZSTD_compress(
+            result.data(), result.size(), raw.data(), raw.size(), ZSTD_CLEVEL_DEFAULT);
+        check(size);
+        result.resize(size);
+        return result;
+    }
+
+    std::string decompress(std::string_view raw) const override {
+        // Frames recording their size are decompressed straight into a buffer of that size
+        const auto contentSize = ZSTD_getFrameContentSize(raw.data(), raw.size());
+        if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR) {
+            std::string result(static_cast<std::size_t>(contentSize), '\0');
+            const std::size_t size = ZSTD_decompress(result.data(), result.size(), raw.data(), raw.size());
+            check(size);
+            result.resize(size);
+            return result;
+        }
+
+        // Frames written by streaming compressors don't record their size
+        std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+        if (!stream) {
+            throw std::runtime_error("failed to initialize zstd");
+        }
+
+        std::string result;
+        char out[chunkSize];
+        ZSTD_inBuffer input{raw.data(), raw.size(), 0};
+        std::size_t code = 1;
+        while (code != 0) {
+            ZSTD_outBuffer output{out, sizeof(out), 0};
+            code = ZSTD_decompressStream(stream.get(), &output, &input);
+            check(code);
+            result.append(out, output.pos);
+            if (code != 0 && input.pos == input.size && output.pos < output.size) {
+                throw std::runtime_error("truncated zstd data");
+            }
+        }
+        return result;
+    }
+
+private:
+    static void check(std::size_t code) {
+        if (ZSTD_isError(code)) {
+            throw std::runtime_error(ZSTD_getErrorName(code));
+        }
+    }
+};
+#endif
+
+#ifdef MLN_WITH_BROTLI
+class BrotliCodec final : public Codec {
+public:
+    CodecType type() const override { return CodecType::Brotli; }
+
+    std::string compress(std::string_view raw) const override {
+        std::size_t size = BrotliEncoderMaxCompressedSize(raw.size());
+        std::string result(size, '\0');
+        if (size == 0 || !BrotliEncoderCompress(BROTLI_DEFAULT_QUALITY,
+                                                BROTLI_DEFAULT_WINDOW,
+                                                BROTLI_MODE_GENERIC,
+                                                raw.size(),
+                                                reinterpret_cast<const uint8_t *>(raw.data()),
+                                                &size,
+                                                reinterpret_cast<uint8_t *>(result.data()))) {
+            throw std::runtime_error("brotli compression failed");
+        }
+        result.resize(size);
+        return result;
+    }
+
+    std::string decompress(std::string_view raw) const override {
+        const auto state = createDecoder();
+        std::string result;
+        char out[chunkSize];
+        std::size_t availableIn = raw.size();
+        const auto* nextIn = reinterpret_cast<const uint8_t *>(raw.data());
+        BrotliDecoderResult code;
+        do {
+            std::size_t availableOut = sizeof(out);
+            auto* nextOut = reinterpret_cast<uint8_t *>(out);
+            code = BrotliDecoderDecompressStream(
+                state.get(), &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+            result.append(out, sizeof(out) - availableOut);
+        } while (code == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT);
+
+        if (code != BROTLI_DECODER_RESULT_SUCCESS) {
+            throw std::runtime_error("brotli decompression error");
+        }
+        return result;
+    }
+
+private:
+    using Decoder = std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)>;
+
+    static Decoder createDecoder() {
+        Decoder state(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr), BrotliDecoderDestroyInstance);
+        if (!state) {
+            throw std::runtime_error("failed to initialize brotli");
+        }
+        return state;
+    }
+};
+#endif
+
+struct CodecRegistry {
+    CodecRegistry() {
+        add(std::make_shared<ZlibCodec>(CodecType::Zlib, CompressionFormat::ZLIB));
+        add(std::make_shared<ZlibCodec>(CodecType::Gzip, CompressionFormat::GZIP));
+#ifdef MLN_WITH_ZSTD
+        add(std::make_shared<ZstdCodec>());
+#endif
+#ifdef MLN_WITH_BROTLI
+        add(std::make_shared<BrotliCodec>());
+#endif
+    }
+
+    void add(std::shared_ptr<const Codec> codec) {
+        auto& slot = codecs[static_cast<std::size_t>(codec->type())];
+        // Replaced codecs are kept alive, callers may still hold them
+        if (slot) {
+            replaced.push_back(std::move(slot));
+        }
+        slot = std::move(codec);
+    }
+
+    std::mutex mutex;
+    std::array<std::shared_ptr<const Codec>, 4> codecs;
+    std::vector<std::shared_ptr<const Codec>> replaced;
+};
+
+CodecRegistry& getRegistry() {
+    static CodecRegistry registry;
+    return registry;
+}
+
+} // namespace
+
+const Codec* getCodec(CodecType type) {
+    auto& registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    return registry.codecs[static_cast<std::size_t>(type)].get();
+}
+
+const Codec* detectCodec(std::string_view raw) {
+    auto& registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    for (const auto& codec : registry.codecs) {
+        if (codec && codec->matches(raw)) {
+            return codec.get();
+        }
+    }
+    return nullptr;
+}
+
+void registerCodec(std::shared_ptr<const Codec> codec) {
+    auto& registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    registry.add(std::move(codec));
+}
+
 } // namespace util
 } // namespace mbgl
@@ -181,6 +181,20 @@ target_link_libraries(
         mbgl-vendor-sqlite
 )
 
+if(MLN_WITH_ZSTD)
+    pkg_search_module(ZSTD libzstd REQUIRED)
+    target_compile_definitions(mbgl-core PRIVATE MLN_WITH_ZSTD=1)
+    target_include_directories(mbgl-core PRIVATE ${ZSTD_INCLUDE_DIRS})
+    target_link_libraries(mbgl-core PRIVATE ${ZSTD_LIBRARIES})
+endif()
+
+if(MLN_WITH_BROTLI)
+    pkg_check_modules(BROTLI REQUIRED libbrotlienc libbrotlidec)
+    target_compile_definitions(mbgl-core PRIVATE MLN_WITH_BROTLI=1)
+    target_include_directories(mbgl-core PRIVATE ${BROTLI_INCLUDE_DIRS})
+    target_link_libraries(mbgl-core PRIVATE ${BROTLI_LIBRARIES})
+endif()
+
 if(MLN_CREATE_AMALGAMATION)
     if ("${ARMERGE}" STREQUAL "MLN_CREATE_AMALGAMATION")
         message(FATAL_ERROR "armerge required when MLN_CREATE_AMALGAMATION=ON")
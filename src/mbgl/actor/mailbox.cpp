@@ -5,9 +5,19 @@
 #include <mbgl/util/scoped.hpp>
 
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
+namespace {
+
+class StubMessage final : public Message {
+public:
+    void operator()() override { assert(false); }
+};
+
+} // namespace
+
 Mailbox::Mailbox() = default;
 
 Mailbox::Mailbox(Scheduler& scheduler_)
@@ -17,6 +27,12 @@ Mailbox::Mailbox(const TaggedScheduler& scheduler_)
     : schedulerTag(scheduler_.tag),
       weakScheduler(scheduler_.get()->makeWeakPtr()) {}
 
+Mailbox::~Mailbox() {
+    // Messages which were never received, either because the mailbox was closed or never opened
+    while (dequeue()) {
+    }
+}
+
 void Mailbox::open(const TaggedScheduler& scheduler_) {
     assert(!weakScheduler);
     schedulerTag = scheduler_.tag;
@@ -37,7 +53,7 @@ void Mailbox::open(Scheduler& scheduler_) {
 
     weakScheduler = scheduler_.makeWeakPtr();
 
-    if (!queue.empty()) {
+    if (queueSize > 0) {
         scheduleToRecieve();
     }
 }
@@ -51,6 +67,8 @@ void Mailbox::close() {
     // will obtain them when it self-sends a message, and consistent lock
     // acquisition order prevents deadlocks. The receiving mutex is recursive to
     // allow a mailbox (and thus the actor) to close itself.
+    // push() only takes the pushing mutex when it schedules a receive, and checks `closed` again
+    // once it has it. Messages enqueued while closing are never received.
     std::scoped_lock receivingLock(receivingMutex);
     std::scoped_lock pushingLock(pushingMutex);
 
@@ -87,25 +105,17 @@ void Mailbox::push(std::unique_ptr<Message> message) {
         }
     }};
 
-    {
-        MLN_TRACE_ZONE(push lock);
-        std::scoped_lock pushingLock(pushingMutex);
-
-        if (closed) {
-            state = State::Abandoned;
-            return;
-        }
+    if (closed) {
+        state = State::Abandoned;
+        return;
+    }
 
-        bool wasEmpty = false;
-        {
-            MLN_TRACE_ZONE(queue lock);
-            std::scoped_lock queueLock(queueMutex);
-            wasEmpty = queue.empty();
-            queue.push(std::move(message));
-        }
+    enqueue(std::move(message));
 
-        if (wasEmpty) {
-            MLN_TRACE_ZONE(schedule);
+    if (queueSize.fetch_add(1) == 0) {
+        MLN_TRACE_ZONE(schedule);
+        std::scoped_lock pushingLock(pushingMutex);
+        if (!closed) {
             scheduleToRecieve(schedulerTag);
         }
     }
@@ -131,16 +141,18 @@ void Mailbox::receive() {
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty = false;
+    // open() may schedule a receive for messages which a concurrent push() also scheduled one for
+    if (queueSize == 0) {
+        return;
+    }
 
-    {
-        std::scoped_lock queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
+    std::unique_ptr<Message> message = dequeue();
+    while (!message) {
+        // A producer has claimed its place in the queue, but hasn't linked it up yet
+        std::this_thread::yield();
+        message = dequeue();
     }
+    const bool wasEmpty = queueSize.fetch_sub(1) == 1;
 
     (*message)();
 
@@ -167,4 +179,54 @@ void Mailbox::scheduleToRecieve(const std::optional<util::SimpleIdentity>& tag)
     }
 }
 
+std::unique_ptr<Message> Mailbox::makeStub() {
+    return std::make_unique<StubMessage>();
+}
+
+// Vyukov's intrusive MPSC queue: a producer swaps itself in as the new head, then links the
+// previous head to it. Between the two steps the consumer can't see past the previous head.
+void Mailbox::enqueue(std::unique_ptr<Message> message) {
+    Message* node = message.release();
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+// Only called with the receiving mutex held, or on destruction. Returns null if the queue is
+// empty or the next message isn't linked up yet.
+std::unique_ptr<Message> Mailbox::dequeue() {
+    Message* node = tail;
+    Message* next = node->next.load(std::memory_order_acquire);
+
+    if (node == stub.get()) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        node = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return std::unique_ptr<Message>(node);
+    }
+
+    if (node != head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // `node` is the last message. Put the stub back behind it so that it can be handed out.
+    stub->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(stub.get(), std::memory_order_acq_rel);
+    prev->next.store(stub.get(), std::memory_order_release);
+
+    next = node->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return std::unique_ptr<Message>(node);
+    }
+    return nullptr;
+}
+
 } // namespace mbgl
@@ -12,8 +12,12 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/style_impl.hpp>
 
+#include <mbgl/util/projection.hpp>
+
 #include <boost/iterator/function_output_iterator.hpp>
 
+#include <algorithm>
+
 // Note: LayerManager::annotationsEnabled is defined
 // at compile time, so that linker (with LTO on) is able
 // to optimize out the unreachable code.
@@ -78,18 +82,21 @@ void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& anno
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
     symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
+    invalidate(*impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation) {
     ShapeAnnotationImpl& impl =
         *shapeAnnotations.emplace(id, std::make_unique<LineAnnotationImpl>(id, annotation)).first->second;
     impl.updateStyle(*style.get().impl);
+    invalidate(impl.getBounds());
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation) {
     ShapeAnnotationImpl& impl =
         *shapeAnnotations.emplace(id, std::make_unique<FillAnnotationImpl>(id, annotation)).first->second;
     impl.updateStyle(*style.get().impl);
+    invalidate(impl.getBounds());
 }
 
 void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation) {
@@ -116,8 +123,7 @@ void AnnotationManager::update(const AnnotationID& id, const LineAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
-    add(id, annotation);
+    updateShape(it->second, std::make_unique<LineAnnotationImpl>(id, annotation));
     dirty = true;
 }
 
@@ -128,18 +134,32 @@ void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
-    add(id, annotation);
+    updateShape(it->second, std::make_unique<FillAnnotationImpl>(id, annotation));
     dirty = true;
 }
 
+void AnnotationManager::updateShape(std::unique_ptr<ShapeAnnotationImpl>& existing,
+                                    std::unique_ptr<ShapeAnnotationImpl> updated) {
+    if (updated->geometry() == existing->geometry()) {
+        // Only the paint properties changed, the tiles stay the same
+        updated->shapeTiler = std::move(existing->shapeTiler);
+    } else {
+        invalidate(existing->getBounds());
+        invalidate(updated->getBounds());
+    }
+    existing = std::move(updated);
+    existing->updateStyle(*style.get().impl);
+}
+
 void AnnotationManager::remove(const AnnotationID& id) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN_NOARG();
     if (symbolAnnotations.contains(id)) {
+        invalidate(*symbolAnnotations.at(id));
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.contains(id)) {
         auto it = shapeAnnotations.find(id);
+        invalidate(it->second->getBounds());
         (void)*style.get().impl->removeLayer(it->second->layerID);
         shapeAnnotations.erase(it);
     } else {
@@ -147,6 +167,21 @@ void AnnotationManager::remove(const AnnotationID& id) {
     }
 }
 
+void AnnotationManager::invalidate(const mapbox::geometry::box<double>& bounds) {
+    dirtyBounds.push_back(bounds);
+}
+
+void AnnotationManager::invalidate(const SymbolAnnotationImpl& symbol) {
+    const Point<double>& point = symbol.annotation.geometry;
+    const Point<double> projected = Projection::project(LatLng(point.y, point.x), 0);
+    invalidate(mapbox::geometry::box<double>{projected, projected});
+}
+
+bool AnnotationManager::isTileDirty(const CanonicalTileID& tileID) const {
+    return std::ranges::any_of(
+        dirtyBounds, [&](const auto& bounds) { return ShapeAnnotationImpl::intersects(bounds, tileID); });
+}
+
 std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const CanonicalTileID& tileID) {
     if (symbolAnnotations.empty() && shapeAnnotations.empty()) return nullptr;
 
@@ -167,7 +202,9 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
         boost::make_function_output_iterator([&](const auto& val) { val->updateLayer(tileID, *pointLayer); }));
 
     for (const auto& shape : shapeAnnotations) {
-        shape.second->updateTileData(tileID, *tileData);
+        if (shape.second->intersects(tileID)) {
+            shape.second->updateTileData(tileID, *tileData);
+        }
     }
 
     return tileData;
@@ -214,9 +251,13 @@ void AnnotationManager::updateData() {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN_NOARG();
     std::scoped_lock lock(mutex);
     if (dirty) {
+        // Only tiles touched by the changed annotations are regenerated
         for (auto& tile : tiles) {
-            tile->setData(getTileData(tile->id.canonical));
+            if (isTileDirty(tile->id.canonical)) {
+                tile->setData(getTileData(tile->id.canonical));
+            }
         }
+        dirtyBounds.clear();
         dirty = false;
     }
 }
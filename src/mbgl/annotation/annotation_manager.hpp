@@ -11,6 +11,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace mbgl {
 
@@ -61,10 +62,17 @@ private:
     void update(const AnnotationID&, const LineAnnotation&);
     void update(const AnnotationID&, const FillAnnotation&);
 
+    void updateShape(std::unique_ptr<ShapeAnnotationImpl>& existing, std::unique_ptr<ShapeAnnotationImpl> updated);
+
     void remove(const AnnotationID&);
 
     void updateStyle();
 
+    // Marks the tiles touched by bounds in world coordinates for the next updateData()
+    void invalidate(const mapbox::geometry::box<double>&);
+    void invalidate(const SymbolAnnotationImpl&);
+    bool isTileDirty(const CanonicalTileID&) const;
+
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
 
     std::reference_wrapper<style::Style> style;
@@ -72,6 +80,7 @@ private:
     std::mutex mutex;
 
     bool dirty = false;
+    std::vector<mapbox::geometry::box<double>> dirtyBounds;
 
     AnnotationID nextID = 0;
 
@@ -7,6 +7,11 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
@@ -27,7 +32,7 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
         // The annotation source is currently hard coded to maxzoom 16, so we're
         // topping out at z16 here as well.
         options.maxZoom = 16;
-        options.buffer = 255u;
+        options.buffer = tileBuffer;
         options.extent = util::EXTENT;
         options.tolerance = baseTolerance;
         shapeTiler = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
@@ -55,4 +60,43 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
     }
 }
 
+const mapbox::geometry::box<double>& ShapeAnnotationImpl::getBounds() {
+    if (!bounds) {
+        mapbox::geometry::for_each_point(geometry(), [&](const Point<double>& point) {
+            const Point<double> projected = Projection::project(LatLng(util::clamp(point.y, -90.0, 90.0), point.x), 0);
+            if (!bounds) {
+                bounds = mapbox::geometry::box<double>{projected, projected};
+            } else {
+                bounds->min = {std::min(bounds->min.x, projected.x), std::min(bounds->min.y, projected.y)};
+                bounds->max = {std::max(bounds->max.x, projected.x), std::max(bounds->max.y, projected.y)};
+            }
+        });
+        if (!bounds) {
+            // Empty geometries don't touch any tile
+            bounds = mapbox::geometry::box<double>{{2, 2}, {2, 2}};
+        }
+    }
+    return *bounds;
+}
+
+bool ShapeAnnotationImpl::intersects(const mapbox::geometry::box<double>& box, const CanonicalTileID& tileID) {
+    const double scale = 1.0 / (1u << tileID.z);
+    const double buffer = scale * tileBuffer / util::EXTENT;
+    const double minY = tileID.y * scale - buffer;
+    const double maxY = (tileID.y + 1) * scale + buffer;
+    if (box.max.y < minY || box.min.y > maxY) {
+        return false;
+    }
+
+    // The tiler wraps shapes around the antimeridian
+    for (const double shift : {0.0, -1.0, 1.0}) {
+        const double minX = tileID.x * scale - buffer + shift;
+        const double maxX = (tileID.x + 1) * scale + buffer + shift;
+        if (box.max.x >= minX && box.min.x <= maxX) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace mbgl
@@ -7,6 +7,7 @@
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/style/style.hpp>
 
+#include <optional>
 #include <string>
 #include <memory>
 
@@ -25,9 +26,24 @@ public:
 
     void updateTileData(const CanonicalTileID &, AnnotationTileData &);
 
+    /// The bounds of the geometry in world coordinates from 0 to 1
+    const mapbox::geometry::box<double> &getBounds();
+
+    /// Whether the shape has any features in the tile, including its buffer
+    bool intersects(const CanonicalTileID &tileID) { return intersects(getBounds(), tileID); }
+
+    /// Whether bounds in world coordinates intersect the tile, including its buffer
+    static bool intersects(const mapbox::geometry::box<double> &, const CanonicalTileID &);
+
+    // In tile units
+    static constexpr uint16_t tileBuffer = 255;
+
     const AnnotationID id;
     const std::string layerID;
     std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+
+private:
+    std::optional<mapbox::geometry::box<double>> bounds;
 };
 
 struct CloseShapeAnnotation {
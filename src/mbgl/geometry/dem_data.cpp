@@ -1,6 +1,8 @@
 #include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/math/clamp.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 
 DEMData::DEMData(const PremultipliedImage& _image, Tileset::RasterEncoding _encoding)
@@ -50,40 +52,41 @@ DEMData::DEMData(const PremultipliedImage& _image, Tileset::RasterEncoding _enco
 // surrounding pixels, and if we don't have the pixel buffer we get seams at
 // tile boundaries.
 void DEMData::backfillBorder(const DEMData& borderTileData, int8_t dx, int8_t dy) {
-    auto& o = borderTileData;
-
     // Tiles from the same source should always be of the same dimensions.
-    assert(dim == o.dim);
+    assert(dim == borderTileData.dim);
+    backfillBorder(*image, *borderTileData.image, dim, dx, dy);
+}
+
+void DEMData::backfillBorder(
+    PremultipliedImage& image, const PremultipliedImage& borderImage, int32_t dim, int8_t dx, int8_t dy) {
+    assert(image.size == borderImage.size);
+    assert(image.size.width == static_cast<uint32_t>(dim + 2));
 
     // We determine the pixel range to backfill based which corner/edge
-    // `borderTileData` represents. For example, dx = -1, dy = -1 represents the
+    // `borderImage` represents. For example, dx = -1, dy = -1 represents the
     // upper left corner of the base tile, so we only need to backfill one pixel
     // at coordinates (-1, -1) of the tile image.
-    int32_t xMin = dx * dim;
-    int32_t xMax = dx * dim + dim;
-    int32_t yMin = dy * dim;
-    int32_t yMax = dy * dim + dim;
-
-    if (dx == -1)
-        xMin = xMax - 1;
-    else if (dx == 1)
-        xMax = xMin + 1;
+    const int32_t xMin = dx == -1 ? -1 : dx * dim;
+    const int32_t xMax = dx == 1 ? dim + 1 : dx * dim + dim;
+    const int32_t yMin = dy == -1 ? -1 : dy * dim;
+    const int32_t yMax = dy == 1 ? dim + 1 : dy * dim + dim;
 
-    if (dy == -1)
-        yMin = yMax - 1;
-    else if (dy == 1)
-        yMax = yMin + 1;
+    const int32_t ox = -dx * dim;
+    const int32_t oy = -dy * dim;
 
-    int32_t ox = -dx * dim;
-    int32_t oy = -dy * dim;
+    const int32_t stride = dim + 2;
+    const auto idx = [stride](const int32_t x, const int32_t y) {
+        return static_cast<size_t>((y + 1) * stride + (x + 1));
+    };
 
-    auto* dest = reinterpret_cast<uint32_t*>(image->data.get());
-    auto* source = reinterpret_cast<uint32_t*>(o.image->data.get());
+    auto* dest = reinterpret_cast<uint32_t*>(image.data.get());
+    const auto* source = reinterpret_cast<const uint32_t*>(borderImage.data.get());
 
+    // Rows are contiguous, so the top and bottom edges are a single copy and the left and
+    // right edges one pixel per row
+    const auto width = static_cast<size_t>(xMax - xMin);
     for (int32_t y = yMin; y < yMax; y++) {
-        for (int32_t x = xMin; x < xMax; x++) {
-            dest[idx(x, y)] = source[idx(x + ox, y + oy)];
-        }
+        std::memcpy(dest + idx(xMin, y), source + idx(xMin + ox, y + oy), width * sizeof(uint32_t));
     }
 }
 
@@ -16,12 +16,23 @@ public:
     DEMData(const PremultipliedImage& image, Tileset::RasterEncoding encoding);
     void backfillBorder(const DEMData& borderTileData, int8_t dx, int8_t dy);
 
+    // Backfills the border of `image` from `borderImage`, both laid out like the image of a DEMData with `dim`
+    static void backfillBorder(
+        PremultipliedImage& image, const PremultipliedImage& borderImage, int32_t dim, int8_t dx, int8_t dy);
+
     int32_t get(int32_t x, int32_t y) const;
     const std::array<float, 4>& getUnpackVector() const;
 
     const PremultipliedImage* getImage() const { return &*image; }
     const std::shared_ptr<PremultipliedImage>& getImagePtr() const { return image; }
 
+    // Replaces the image with a backfilled copy. The image is shared with textures and workers,
+    // so it's never modified in place once the tile has been handed to the renderer.
+    void setImage(std::shared_ptr<PremultipliedImage> image_) {
+        assert(image_ && image_->size == image->size);
+        image = std::move(image_);
+    }
+
     const int32_t dim;
     const int32_t stride;
     const Tileset::RasterEncoding encoding;
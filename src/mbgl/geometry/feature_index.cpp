@@ -334,6 +334,49 @@ void FeatureIndex::setBucketLayerIDs(const std::string& bucketLeaderID, const st
     bucketLayerIDs[bucketLeaderID] = layerIDs;
 }
 
+std::size_t FeatureIndex::getMemoryUsage() const {
+    // Each box is referenced by at least one grid cell
+    const auto& elements = grid.getBoxElements();
+    return elements.size() * (sizeof(elements.front()) + sizeof(uint32_t));
+}
+
+void FeatureIndex::merge(const FeatureIndex& shard) {
+    if (bucketLayerIDs.empty()) {
+        bucketLayerIDs.reserve(expectedUniqueLeaderIDs);
+    }
+    for (const auto& [leaderID, layerIDs] : shard.bucketLayerIDs) {
+        auto& ids = bucketLayerIDs[leaderID];
+        if (!layerIDs.empty()) {
+            ids = layerIDs;
+        }
+    }
+
+    // Shards rarely hold more than one source layer and bucket, so remember the
+    // last strings we resolved rather than hashing them for every element.
+    const std::string* lastShardLayerName = nullptr;
+    const std::string* lastShardLeaderID = nullptr;
+    const std::string* emplacedLayerName = nullptr;
+    const std::string* emplacedLeaderID = nullptr;
+
+    const auto sortOffset = sortIndex;
+    for (const auto& [subfeature, bbox] : shard.grid.getBoxElements()) {
+        if (&subfeature.getSourceLayerName() != lastShardLayerName) {
+            lastShardLayerName = &subfeature.getSourceLayerName();
+            emplacedLayerName = &*uniqueLayerIDs.insert(*lastShardLayerName).first;
+        }
+        if (&subfeature.getBucketLeaderID() != lastShardLeaderID) {
+            lastShardLeaderID = &subfeature.getBucketLeaderID();
+            emplacedLeaderID = &bucketLayerIDs.find(*lastShardLeaderID)->first;
+        }
+        grid.insert(RefIndexedSubfeature(subfeature.getIndex(),
+                                         *emplacedLayerName,
+                                         *emplacedLeaderID,
+                                         sortOffset + subfeature.getSortIndex()),
+                    bbox);
+    }
+    sortIndex += shard.sortIndex;
+}
+
 DynamicFeatureIndex::~DynamicFeatureIndex() = default;
 
 void DynamicFeatureIndex::query(std::unordered_map<std::string, std::vector<Feature>>& result,
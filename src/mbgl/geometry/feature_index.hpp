@@ -8,9 +8,11 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/mat4.hpp>
 
+#include <optional>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -138,6 +140,13 @@ public:
 
     void setBucketLayerIDs(const std::string& bucketLeaderID, const std::vector<std::string>& layerIDs);
 
+    /// Append the contents of an index built separately for the same tile, e.g., on another thread.
+    /// Features keep their relative order and sort after everything already in this index.
+    void merge(const FeatureIndex& shard);
+
+    /// Approximate size of the indexed features
+    std::size_t getMemoryUsage() const;
+
     std::unordered_map<std::string, std::vector<Feature>> lookupSymbolFeatures(
         const std::vector<IndexedSubfeature>& symbolFeatures,
         const RenderedQueryOptions& options,
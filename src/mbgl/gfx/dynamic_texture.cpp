@@ -2,6 +2,8 @@
 #include <mbgl/gfx/texture2d.hpp>
 #include <mbgl/gfx/context.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 namespace gfx {
 
@@ -32,24 +34,71 @@ bool DynamicTexture::isEmpty() const {
 }
 
 std::optional<TextureHandle> DynamicTexture::reserveSize(const Size& size, int32_t uniqueId) {
-    std::scoped_lock lock(mutex);
+    return packImage(nullptr, size, uniqueId, false);
+}
+
+std::optional<TextureHandle> DynamicTexture::acquireImage(int32_t uniqueId) {
+    return acquireResidentImage(uniqueId, false);
+}
+
+std::optional<TextureHandle> DynamicTexture::addImage(const uint8_t* pixelData,
+                                                      const Size& imageSize,
+                                                      int32_t uniqueId) {
+    return packImage(pixelData, imageSize, uniqueId, true);
+}
+
+std::optional<TextureHandle> DynamicTexture::acquireResidentImage(int32_t uniqueId, bool revive) {
+    auto& shard = shardFor(uniqueId);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.images.find(uniqueId);
+    if (it == shard.images.end()) {
+        return std::nullopt;
+    }
+
+    auto& image = it->second;
+    int32_t refcount = image.refcount;
+    while (refcount > 0 || revive) {
+        if (image.refcount.compare_exchange_weak(refcount, refcount + 1)) {
+            return TextureHandle(uniqueId, image.rectangle);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<TextureHandle> DynamicTexture::packImage(const uint8_t* pixelData,
+                                                       const Size& size,
+                                                       int32_t uniqueId,
+                                                       bool upload) {
+    std::scoped_lock allocationLock(allocationMutex);
+    // Added by another tile since it was looked up, or still there while being removed
+    if (auto texHandle = acquireResidentImage(uniqueId, true)) {
+        return texHandle;
+    }
+    if (retired) {
+        return std::nullopt;
+    }
+
     mapbox::Bin* bin = shelfPack.packOne(uniqueId, size.width, size.height);
     if (!bin) {
         return std::nullopt;
     }
-    if (bin->refcount() == 1) {
-        numTextures++;
+    assert(bin->refcount() == 1);
+    TextureHandle texHandle(*bin);
+    if (upload) {
+        uploadImage(pixelData, texHandle);
     }
-    return TextureHandle(*bin);
-}
 
-std::optional<TextureHandle> DynamicTexture::addImage(const uint8_t* pixelData,
-                                                      const Size& imageSize,
-                                                      int32_t uniqueId) {
-    auto texHandle = reserveSize(imageSize, uniqueId);
-    if (texHandle && texHandle->isUploadNeeded()) {
-        uploadImage(pixelData, *texHandle);
+    {
+        auto& shard = shardFor(bin->id);
+        std::unique_lock lock(shard.mutex);
+        shard.images.try_emplace(bin->id, texHandle.getRectangle());
     }
+    numTextures++;
+    usedArea += static_cast<std::size_t>(bin->w) * bin->h;
+    slotArea += static_cast<std::size_t>(bin->maxw) * bin->maxh;
+    allocatedArea = std::max<std::size_t>(allocatedArea, slotArea);
+    // Slots are as high as their shelf, and shelves are never freed
+    shelvesHeight = std::max(shelvesHeight.load(), static_cast<uint32_t>(bin->y + bin->maxh));
     return texHandle;
 }
 
@@ -58,17 +107,54 @@ void DynamicTexture::uploadImage(const uint8_t* /*pixelData*/, gfx::TextureHandl
 }
 
 bool DynamicTexture::removeTexture(const TextureHandle& texHandle) {
-    std::scoped_lock lock(mutex);
+    auto& shard = shardFor(texHandle.getId());
+    {
+        std::shared_lock lock(shard.mutex);
+        const auto it = shard.images.find(texHandle.getId());
+        if (it == shard.images.end() || it->second.refcount.fetch_sub(1) != 1) {
+            return false;
+        }
+    }
+
+    // Last reference gone. Free the image unless another tile added it again in the meantime.
+    std::scoped_lock allocationLock(allocationMutex);
+    {
+        std::unique_lock lock(shard.mutex);
+        const auto it = shard.images.find(texHandle.getId());
+        if (it == shard.images.end() || it->second.refcount != 0) {
+            return false;
+        }
+        shard.images.erase(it);
+    }
+
     auto* bin = shelfPack.getBin(texHandle.getId());
     if (!bin) {
         return false;
     }
-    auto refcount = shelfPack.unref(*bin);
-    if (refcount == 0) {
-        numTextures--;
-        return true;
+    usedArea -= static_cast<std::size_t>(bin->w) * bin->h;
+    slotArea -= static_cast<std::size_t>(bin->maxw) * bin->maxh;
+    shelfPack.unref(*bin);
+    discardUpload(texHandle);
+    numTextures--;
+    return true;
+}
+
+bool DynamicTexture::retireIfEmpty(bool& wasRetired) {
+    std::scoped_lock allocationLock(allocationMutex);
+    if (numTextures != 0) {
+        return false;
     }
-    return false;
+    wasRetired = retired.exchange(true);
+    return true;
+}
+
+DynamicTexture::Stats DynamicTexture::getStats() const {
+    return {.images = static_cast<std::size_t>(numTextures.load()),
+            .usedArea = usedArea,
+            .slotArea = slotArea,
+            .allocatedArea = allocatedArea,
+            .shelfArea = static_cast<std::size_t>(texture->getSize().width) * shelvesHeight,
+            .textureArea = texture->getSize().area()};
 }
 
 } // namespace gfx
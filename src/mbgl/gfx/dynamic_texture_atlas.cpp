@@ -1,8 +1,11 @@
 #include <mbgl/gfx/dynamic_texture_atlas.hpp>
 #include <mbgl/gfx/context.hpp>
+#include <mbgl/gfx/texture2d.hpp>
+#include <mbgl/util/instrumentation.hpp>
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace mbgl {
 namespace gfx {
@@ -17,130 +20,168 @@ Rect<uint16_t> rectWithoutExtraPadding(const Rect<uint16_t>& rect) {
     return Rect<uint16_t>(
         rect.x + extraPadding, rect.y + extraPadding, rect.w - 2 * extraPadding, rect.h - 2 * extraPadding);
 }
+
+// Copies an image into the middle of `padded`, reused from one image to the next. Only the padding
+// around the image is cleared, the rest is overwritten. Images without pixels come out blank.
+template <typename Image>
+Size padImage(const Image& image, std::vector<uint8_t>& padded) {
+    constexpr std::size_t channels = Image::channels;
+    const std::size_t width = image.size.width;
+    const std::size_t height = image.size.height;
+    const Size paddedSize(image.size.width + 2 * padding, image.size.height + 2 * padding);
+    const std::size_t stride = paddedSize.width * channels;
+    padded.resize(paddedSize.area() * channels);
+    if (!image.data) {
+        std::fill(padded.begin(), padded.end(), 0);
+        return paddedSize;
+    }
+
+    std::fill_n(padded.begin(), padding * stride, 0);
+    for (std::size_t y = 0; y < height; ++y) {
+        uint8_t* row = padded.data() + (padding + y) * stride;
+        std::fill_n(row, padding * channels, 0);
+        std::memcpy(row + padding * channels, image.data.get() + y * width * channels, width * channels);
+        std::fill_n(row + (padding + width) * channels, padding * channels, 0);
+    }
+    std::fill_n(padded.begin() + (padding + height) * stride, padding * stride, 0);
+    return paddedSize;
+}
+
+// Adds 1 pixel wrapped padding on each side of a pattern padded by `padImage`
+void wrapPatternEdges(const PremultipliedImage& image, std::vector<uint8_t>& padded) {
+    constexpr std::size_t channels = PremultipliedImage::channels;
+    const std::size_t w = image.size.width;
+    const std::size_t h = image.size.height;
+    if (!w || !h || !image.data) {
+        return;
+    }
+    const std::size_t stride = (w + 2 * padding) * channels;
+    const uint8_t* src = image.data.get();
+    uint8_t* dst = padded.data() + padding * stride + padding * channels;
+
+    std::memcpy(dst - stride, src + (h - 1) * w * channels, w * channels); // T
+    std::memcpy(dst + h * stride, src, w * channels);                      // B
+    for (std::size_t y = 0; y < h; ++y) {
+        std::memcpy(dst + y * stride - channels, src + (y * w + w - 1) * channels, channels); // L
+        std::memcpy(dst + y * stride + w * channels, src + y * w * channels, channels);       // R
+    }
+}
 } // namespace
 
-GlyphAtlas DynamicTextureAtlas::uploadGlyphs(const GlyphMap& glyphs) {
-    using GlyphsToUpload = std::vector<std::tuple<TextureHandle, Immutable<Glyph>, FontStackHash>>;
+DynamicTexturePtr DynamicTextureAtlas::getDynamicTexture(std::size_t index,
+                                                         Size& newSize,
+                                                         TexturePixelType pixelType) {
     std::scoped_lock lock(mutex);
+    if (index < dynamicTextures.size()) {
+        return dynamicTextures[index];
+    }
+    // Added before any image is packed into it, so that tiles which don't find room in the other
+    // textures at the same time share it instead of each creating one
+    auto dynamicTexture = context.createDynamicTexture(newSize, pixelType);
+    dynamicTextures.emplace_back(dynamicTexture);
+    newSize = Size(newSize.width * 2, newSize.height * 2);
+    return dynamicTexture;
+}
+
+DynamicTexturePtr DynamicTextureAtlas::getDummyDynamicTexture(TexturePixelType pixelType) {
+    std::scoped_lock lock(mutex);
+    auto& dynamicTexture = dummyDynamicTexture[pixelType];
+    if (!dynamicTexture) {
+        const auto channels = pixelType == TexturePixelType::Alpha ? AlphaImage::channels
+                                                                   : PremultipliedImage::channels;
+        const std::vector<uint8_t> dummyImage(dummySize.area() * channels, 0);
+        dynamicTexture = context.createDynamicTexture(dummySize, pixelType);
+        dynamicTexture->addImage(dummyImage.data(), dummySize);
+    }
+    return dynamicTexture;
+}
+
+GlyphAtlas DynamicTextureAtlas::uploadGlyphs(const GlyphMap& glyphs) {
+    MLN_TRACE_FUNC();
 
     GlyphAtlas glyphAtlas;
     if (!glyphs.size()) {
-        glyphAtlas.dynamicTexture = dummyDynamicTexture[TexturePixelType::Alpha];
-        if (!glyphAtlas.dynamicTexture) {
-            AlphaImage dummyImage(dummySize);
-            dummyImage.fill(0);
-            glyphAtlas.dynamicTexture = context.createDynamicTexture(dummySize, TexturePixelType::Alpha);
-            glyphAtlas.dynamicTexture->addImage(dummyImage.data.get(), dummySize);
-            dummyDynamicTexture[TexturePixelType::Alpha] = glyphAtlas.dynamicTexture;
-        }
+        glyphAtlas.dynamicTexture = getDummyDynamicTexture(TexturePixelType::Alpha);
         return glyphAtlas;
     }
 
     size_t dynTexIndex = 0;
     Size dynTexSize = startSize;
-    GlyphsToUpload glyphsToUpload;
+    std::vector<uint8_t> paddedImage;
 
     while (!glyphAtlas.dynamicTexture) {
-        if (dynTexIndex < dynamicTextures.size()) {
-            glyphAtlas.dynamicTexture = dynamicTextures[dynTexIndex++];
-        } else {
-            glyphAtlas.dynamicTexture = context.createDynamicTexture(dynTexSize, TexturePixelType::Alpha);
-            dynTexSize = Size(dynTexSize.width * 2, dynTexSize.height * 2);
-            dynTexIndex++;
-        }
-
-        if (glyphAtlas.dynamicTexture->getPixelFormat() != TexturePixelType::Alpha) {
-            glyphAtlas.dynamicTexture = nullptr;
+        auto dynamicTexture = getDynamicTexture(dynTexIndex++, dynTexSize, TexturePixelType::Alpha);
+        if (dynamicTexture->getPixelFormat() != TexturePixelType::Alpha || dynamicTexture->isRetired()) {
             continue;
         }
 
         bool hasSpace = true;
-        for (const auto& glyphMapEntry : glyphs) {
-            FontStackHash fontStack = glyphMapEntry.first;
-
-            for (const auto& glyphEntry : glyphMapEntry.second) {
+        for (const auto& [fontStack, glyphMap] : glyphs) {
+            for (const auto& glyphEntry : glyphMap) {
                 const auto& glyph = glyphEntry.second;
+                if (!glyph.has_value() || !glyph.value()->bitmap.valid()) {
+                    continue;
+                }
 
-                if (glyph.has_value() && glyph.value()->bitmap.valid()) {
-                    int32_t uniqueId = static_cast<int32_t>(sqrt(fontStack) / 2 + glyph.value()->id.hash);
-                    const auto size = Size(glyph.value()->bitmap.size.width + 2 * padding,
-                                           glyph.value()->bitmap.size.height + 2 * padding);
-                    const auto& texHandle = glyphAtlas.dynamicTexture->reserveSize(size, uniqueId);
-                    if (!texHandle) {
-                        hasSpace = false;
-                        break;
-                    }
-                    glyphsToUpload.emplace_back(std::make_tuple(*texHandle, glyph.value(), fontStack));
+                // Glyphs other tiles already added are only referenced again, and not padded or uploaded
+                int32_t uniqueId = static_cast<int32_t>(sqrt(fontStack) / 2 + glyph.value()->id.hash);
+                auto texHandle = dynamicTexture->acquireImage(uniqueId);
+                if (!texHandle) {
+                    const auto size = padImage(glyph.value()->bitmap, paddedImage);
+                    texHandle = dynamicTexture->addImage(paddedImage.data(), size, uniqueId);
                 }
+                if (!texHandle) {
+                    hasSpace = false;
+                    break;
+                }
+                glyphAtlas.textureHandles.emplace_back(*texHandle);
+                glyphAtlas.glyphPositions[fontStack].emplace(
+                    glyph.value()->id,
+                    GlyphPosition{.rect = rectWithoutExtraPadding(texHandle->getRectangle()),
+                                  .metrics = glyph.value()->metrics});
             }
             if (!hasSpace) {
-                for (const auto& [texHandle, glyph, fontStack_] : glyphsToUpload) {
-                    glyphAtlas.dynamicTexture->removeTexture(texHandle);
-                }
-                glyphsToUpload.clear();
-                glyphAtlas.dynamicTexture = nullptr;
                 break;
             }
         }
-    }
-    if (dynTexIndex > dynamicTextures.size()) {
-        dynamicTextures.emplace_back(glyphAtlas.dynamicTexture);
-    }
-
-    for (auto& [texHandle, glyph, fontStack] : glyphsToUpload) {
-        const auto& rect = texHandle.getRectangle();
-
-        if (texHandle.isUploadNeeded()) {
-            AlphaImage paddedImage(Size{rect.w, rect.h});
-            paddedImage.fill(0);
-            AlphaImage::copy(glyph->bitmap, paddedImage, {0, 0}, {padding, padding}, glyph->bitmap.size);
-
-            glyphAtlas.dynamicTexture->uploadImage(paddedImage.data.get(), texHandle);
+        if (!hasSpace) {
+            // A texture created for these glyphs is dropped again if they didn't fit
+            removeTextures(glyphAtlas.textureHandles, dynamicTexture);
+            glyphAtlas.textureHandles.clear();
+            glyphAtlas.glyphPositions.clear();
+            continue;
         }
-        glyphAtlas.textureHandles.emplace_back(texHandle);
-        glyphAtlas.glyphPositions[fontStack].emplace(
-            glyph->id, GlyphPosition{.rect = rectWithoutExtraPadding(rect), .metrics = glyph->metrics});
+
+        glyphAtlas.dynamicTexture = std::move(dynamicTexture);
     }
+
+    [[maybe_unused]] const auto textureStats = glyphAtlas.dynamicTexture->getStats();
+    MLN_ZONE_VALUE(textureStats.images);
+    MLN_ZONE_VALUE(textureStats.usedArea);
+    MLN_ZONE_VALUE(textureStats.slotArea);
     return glyphAtlas;
 }
 
 ImageAtlas DynamicTextureAtlas::uploadIconsAndPatterns(const ImageMap& icons,
                                                        const ImageMap& patterns,
                                                        const ImageVersionMap& versionMap) {
-    using ImagesToUpload = std::vector<std::pair<TextureHandle, Immutable<style::Image::Impl>>>;
-    std::scoped_lock lock(mutex);
+    MLN_TRACE_FUNC();
 
     ImageAtlas imageAtlas;
     if (!icons.size() && !patterns.size()) {
-        imageAtlas.dynamicTexture = dummyDynamicTexture[TexturePixelType::RGBA];
-        if (!imageAtlas.dynamicTexture) {
-            PremultipliedImage dummyImage(dummySize);
-            dummyImage.fill(0);
-            imageAtlas.dynamicTexture = context.createDynamicTexture(dummySize, TexturePixelType::RGBA);
-            imageAtlas.dynamicTexture->addImage(dummyImage.data.get(), dummySize);
-            dummyDynamicTexture[TexturePixelType::RGBA] = imageAtlas.dynamicTexture;
-        }
+        imageAtlas.dynamicTexture = getDummyDynamicTexture(TexturePixelType::RGBA);
         return imageAtlas;
     }
 
     size_t dynTexIndex = 0;
     Size dynTexSize = startSize;
-    ImagesToUpload iconsToUpload;
-    ImagesToUpload patternsToUpload;
+    std::vector<uint8_t> paddedImage;
 
-    iconsToUpload.reserve(icons.size());
-    patternsToUpload.reserve(patterns.size());
+    imageAtlas.iconPositions.reserve(icons.size());
+    imageAtlas.patternPositions.reserve(patterns.size());
     while (!imageAtlas.dynamicTexture) {
-        if (dynTexIndex < dynamicTextures.size()) {
-            imageAtlas.dynamicTexture = dynamicTextures[dynTexIndex++];
-        } else {
-            imageAtlas.dynamicTexture = context.createDynamicTexture(dynTexSize, TexturePixelType::RGBA);
-            dynTexSize = Size(dynTexSize.width * 2, dynTexSize.height * 2);
-            dynTexIndex++;
-        }
-
-        if (imageAtlas.dynamicTexture->getPixelFormat() != TexturePixelType::RGBA) {
-            imageAtlas.dynamicTexture = nullptr;
+        auto dynamicTexture = getDynamicTexture(dynTexIndex++, dynTexSize, TexturePixelType::RGBA);
+        if (dynamicTexture->getPixelFormat() != TexturePixelType::RGBA || dynamicTexture->isRetired()) {
             continue;
         }
 
@@ -150,13 +191,20 @@ ImageAtlas DynamicTextureAtlas::uploadIconsAndPatterns(const ImageMap& icons,
 
             auto imageHash = util::hash(icon->id);
             int32_t uniqueId = static_cast<int32_t>(sqrt(imageHash) / 2 + icon->image.size.area());
-            const auto size = Size(icon->image.size.width + 2 * padding, icon->image.size.height + 2 * padding);
-            const auto& texHandle = imageAtlas.dynamicTexture->reserveSize(size, uniqueId);
+            auto texHandle = dynamicTexture->acquireImage(uniqueId);
+            if (!texHandle) {
+                const auto size = padImage(icon->image, paddedImage);
+                texHandle = dynamicTexture->addImage(paddedImage.data(), size, uniqueId);
+            }
             if (!texHandle) {
                 hasSpace = false;
                 break;
             }
-            iconsToUpload.emplace_back(std::make_pair(*texHandle, icon));
+            imageAtlas.textureHandles.emplace_back(*texHandle);
+            const auto it = versionMap.find(icon->id);
+            const auto version = it != versionMap.end() ? it->second : 0;
+            imageAtlas.iconPositions.emplace(
+                icon->id, ImagePosition{rectWithoutExtraPadding(texHandle->getRectangle()), *icon, version});
         }
         if (hasSpace) {
             for (const auto& patternEntry : patterns) {
@@ -164,85 +212,44 @@ ImageAtlas DynamicTextureAtlas::uploadIconsAndPatterns(const ImageMap& icons,
 
                 auto patternHash = util::hash(pattern->id);
                 int32_t uniqueId = static_cast<int32_t>(sqrt(patternHash) / 2 + pattern->image.size.area());
-                const auto size = Size(pattern->image.size.width + 2 * padding,
-                                       pattern->image.size.height + 2 * padding);
-                const auto& texHandle = imageAtlas.dynamicTexture->reserveSize(size, uniqueId);
+                auto texHandle = dynamicTexture->acquireImage(uniqueId);
+                if (!texHandle) {
+                    const auto size = padImage(pattern->image, paddedImage);
+                    wrapPatternEdges(pattern->image, paddedImage);
+                    texHandle = dynamicTexture->addImage(paddedImage.data(), size, uniqueId);
+                }
                 if (!texHandle) {
                     hasSpace = false;
                     break;
                 }
-                patternsToUpload.emplace_back(std::make_pair(*texHandle, pattern));
+                imageAtlas.textureHandles.emplace_back(*texHandle);
+                const auto it = versionMap.find(pattern->id);
+                const auto version = it != versionMap.end() ? it->second : 0;
+                imageAtlas.patternPositions.emplace(
+                    pattern->id,
+                    ImagePosition{rectWithoutExtraPadding(texHandle->getRectangle()), *pattern, version});
             }
         }
         if (!hasSpace) {
-            for (const auto& [texHandle, icon] : iconsToUpload) {
-                imageAtlas.dynamicTexture->removeTexture(texHandle);
-            }
-            iconsToUpload.clear();
-            for (const auto& [texHandle, pattern] : patternsToUpload) {
-                imageAtlas.dynamicTexture->removeTexture(texHandle);
-            }
-            patternsToUpload.clear();
-            imageAtlas.dynamicTexture = nullptr;
+            removeTextures(imageAtlas.textureHandles, dynamicTexture);
+            imageAtlas.textureHandles.clear();
+            imageAtlas.iconPositions.clear();
+            imageAtlas.patternPositions.clear();
             continue;
         }
-    }
-    if (dynTexIndex > dynamicTextures.size()) {
-        dynamicTextures.emplace_back(imageAtlas.dynamicTexture);
-    }
-
-    imageAtlas.iconPositions.reserve(icons.size());
-    for (auto& [texHandle, icon] : iconsToUpload) {
-        const auto& rect = texHandle.getRectangle();
-
-        if (texHandle.isUploadNeeded()) {
-            PremultipliedImage paddedImage(Size{rect.w, rect.h});
-            paddedImage.fill(0);
-            PremultipliedImage::copy(icon->image, paddedImage, {0, 0}, {padding, padding}, icon->image.size);
-
-            imageAtlas.dynamicTexture->uploadImage(paddedImage.data.get(), texHandle);
-        }
-        imageAtlas.textureHandles.emplace_back(texHandle);
-        const auto it = versionMap.find(icon->id);
-        const auto version = it != versionMap.end() ? it->second : 0;
-        imageAtlas.iconPositions.emplace(icon->id, ImagePosition{rectWithoutExtraPadding(rect), *icon, version});
-    }
 
-    imageAtlas.patternPositions.reserve(patterns.size());
-    for (auto& [texHandle, pattern] : patternsToUpload) {
-        const auto& rect = texHandle.getRectangle();
-
-        if (texHandle.isUploadNeeded()) {
-            PremultipliedImage paddedImage(Size{rect.w, rect.h});
-            paddedImage.fill(0);
-            PremultipliedImage::copy(pattern->image, paddedImage, {0, 0}, {padding, padding}, pattern->image.size);
-
-            const uint32_t x = padding;
-            const uint32_t y = padding;
-            const uint32_t w = pattern->image.size.width;
-            const uint32_t h = pattern->image.size.height;
-
-            // Add 1 pixel wrapped padding on each side of the image.
-            PremultipliedImage::copy(pattern->image, paddedImage, {0, h - 1}, {x, y - 1}, {w, 1}); // T
-            PremultipliedImage::copy(pattern->image, paddedImage, {0, 0}, {x, y + h}, {w, 1});     // B
-            PremultipliedImage::copy(pattern->image, paddedImage, {w - 1, 0}, {x - 1, y}, {1, h}); // L
-            PremultipliedImage::copy(pattern->image, paddedImage, {0, 0}, {x + w, y}, {1, h});     // R
-
-            imageAtlas.dynamicTexture->uploadImage(paddedImage.data.get(), texHandle);
-        }
-        imageAtlas.textureHandles.emplace_back(texHandle);
-        const auto it = versionMap.find(pattern->id);
-        const auto version = it != versionMap.end() ? it->second : 0;
-        imageAtlas.patternPositions.emplace(pattern->id,
-                                            ImagePosition{rectWithoutExtraPadding(rect), *pattern, version});
+        imageAtlas.dynamicTexture = std::move(dynamicTexture);
     }
 
+    [[maybe_unused]] const auto textureStats = imageAtlas.dynamicTexture->getStats();
+    MLN_ZONE_VALUE(textureStats.images);
+    MLN_ZONE_VALUE(textureStats.usedArea);
+    MLN_ZONE_VALUE(textureStats.slotArea);
     return imageAtlas;
 }
 
 void DynamicTextureAtlas::removeTextures(const std::vector<TextureHandle>& textureHandles,
                                          const DynamicTexturePtr& dynamicTexture) {
-    std::scoped_lock lock(mutex);
     if (!dynamicTexture) {
         return;
     }
@@ -250,13 +257,83 @@ void DynamicTextureAtlas::removeTextures(const std::vector<TextureHandle>& textu
     for (const auto& texHandle : textureHandles) {
         dynamicTexture->removeTexture(texHandle);
     }
-    if (dynamicTexture->isEmpty()) {
-        auto iterator = std::ranges::find(dynamicTextures, dynamicTexture);
-        if (iterator != dynamicTextures.end()) {
-            dynamicTextures.erase(iterator);
+    if (!dynamicTexture->isEmpty()) {
+        return;
+    }
+
+    // Other tiles may have added images to it in the meantime, and can't add any once it's retired
+    std::scoped_lock lock(mutex);
+    auto iterator = std::ranges::find(dynamicTextures, dynamicTexture);
+    bool wasRetired = false;
+    if (iterator == dynamicTextures.end() || !dynamicTexture->retireIfEmpty(wasRetired)) {
+        return;
+    }
+    dynamicTextures.erase(iterator);
+    if (wasRetired) {
+        const auto& texture = dynamicTexture->getTexture();
+        compactedTextures++;
+        compactedBytes += texture->getSize().area() * texture->getPixelStride();
+    }
+}
+
+void DynamicTextureAtlas::compact(double maxFragmentation) {
+    MLN_TRACE_FUNC();
+
+    std::scoped_lock lock(mutex);
+    auto& renderingStats = context.renderingStats();
+    renderingStats.numCompactedAtlasTextures += compactedTextures.exchange(0);
+    renderingStats.atlasCompactionBytes += compactedBytes.exchange(0);
+
+    for (const auto pixelType : {TexturePixelType::Alpha, TexturePixelType::RGBA}) {
+        DynamicTexturePtr mostFragmented;
+        double mostFragmentation = maxFragmentation;
+        std::size_t mostFragmentedUsedArea = 0;
+        std::size_t mostFragmentedUnshelvedArea = 0;
+        std::size_t unshelvedArea = 0;
+        for (const auto& dynamicTexture : dynamicTextures) {
+            if (dynamicTexture->getPixelFormat() != pixelType || dynamicTexture->isRetired()) {
+                continue;
+            }
+            const auto stats = dynamicTexture->getStats();
+            const auto textureUnshelvedArea = stats.textureArea - std::min(stats.shelfArea, stats.textureArea);
+            unshelvedArea += textureUnshelvedArea;
+            if (!stats.allocatedArea) {
+                continue;
+            }
+            const double fragmentation = 1.0 - static_cast<double>(stats.usedArea) / stats.allocatedArea;
+            if (fragmentation > mostFragmentation) {
+                mostFragmented = dynamicTexture;
+                mostFragmentation = fragmentation;
+                mostFragmentedUsedArea = stats.usedArea;
+                mostFragmentedUnshelvedArea = textureUnshelvedArea;
+            }
+        }
+
+        // Only if its images fit below the last shelves of the other textures, which anything can be
+        // packed into, so that new tiles don't end up in yet another texture. The space left at the
+        // end of their shelves only takes images up to the height of the shelf, so it doesn't count.
+        if (mostFragmented && mostFragmentedUsedArea <= unshelvedArea - mostFragmentedUnshelvedArea) {
+            mostFragmented->retire();
         }
     }
 }
 
+DynamicTextureAtlas::Stats DynamicTextureAtlas::getStats() const {
+    std::scoped_lock lock(mutex);
+    Stats stats;
+    stats.textures = dynamicTextures.size();
+    for (const auto& dynamicTexture : dynamicTextures) {
+        const auto textureStats = dynamicTexture->getStats();
+        stats.retiredTextures += dynamicTexture->isRetired() ? 1 : 0;
+        stats.images += textureStats.images;
+        stats.usedArea += textureStats.usedArea;
+        stats.slotArea += textureStats.slotArea;
+        stats.allocatedArea += textureStats.allocatedArea;
+        stats.shelfArea += textureStats.shelfArea;
+        stats.textureArea += textureStats.textureArea;
+    }
+    return stats;
+}
+
 } // namespace gfx
 } // namespace mbgl
@@ -39,6 +39,8 @@ RenderingStats& RenderingStats::operator+=(const RenderingStats& r) {
     numTextureBindings += r.numTextureBindings;
     numTextureUpdates += r.numTextureUpdates;
     textureUpdateBytes += r.textureUpdateBytes;
+    numCompactedAtlasTextures += r.numCompactedAtlasTextures;
+    atlasCompactionBytes += r.atlasCompactionBytes;
     totalBuffers += r.totalBuffers;
     totalBufferObjs += r.totalBufferObjs;
     bufferUpdates += r.bufferUpdates;
@@ -85,6 +87,8 @@ std::string RenderingStats::toString(std::string_view sep) const {
     optionalStatLine(ss, numTextureBindings, "numTextureBindings", sep);
     optionalStatLine(ss, numTextureUpdates, "numTextureUpdates", sep);
     optionalStatLine(ss, textureUpdateBytes, "textureUpdateBytes", sep);
+    optionalStatLine(ss, numCompactedAtlasTextures, "numCompactedAtlasTextures", sep);
+    optionalStatLine(ss, atlasCompactionBytes, "atlasCompactionBytes", sep);
     optionalStatLine(ss, totalBuffers, "totalBuffers", sep);
     optionalStatLine(ss, totalBufferObjs, "totalBufferObjs", sep);
     optionalStatLine(ss, bufferUpdates, "bufferUpdates", sep);
@@ -36,13 +36,9 @@ void DynamicTexture::uploadDeferredImages() {
     imagesToUpload.clear();
 }
 
-bool DynamicTexture::removeTexture(const gfx::TextureHandle& texHandle) {
-    if (gfx::DynamicTexture::removeTexture(texHandle)) {
-        std::scoped_lock lock(mutex);
-        imagesToUpload.erase(texHandle);
-        return true;
-    }
-    return false;
+void DynamicTexture::discardUpload(const gfx::TextureHandle& texHandle) {
+    std::scoped_lock lock(mutex);
+    imagesToUpload.erase(texHandle);
 }
 
 } // namespace gl
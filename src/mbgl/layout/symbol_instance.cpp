@@ -18,6 +18,15 @@ const Shaping& getAnyShaping(const ShapedTextOrientations& shapedTextOrientation
     return shapedTextOrientations.horizontal;
 }
 
+// 64-bit FNV-1a, the same on every platform
+std::uint64_t hashKey(const std::u16string& key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char16_t c : key) {
+        hash = (hash ^ static_cast<std::uint64_t>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
 } // namespace
 
 SymbolInstanceSharedData::SymbolInstanceSharedData(GeometryCoordinates line_,
@@ -122,6 +131,7 @@ SymbolInstance::SymbolInstance(Anchor& anchor_,
       textOffset(textOffset_),
       iconOffset(iconOffset_),
       key(std::move(key_)),
+      keyHash(hashKey(key)),
       textBoxScale(textBoxScale_),
       textVariableAnchorOffset(textVariableAnchorOffset_),
       singleLine(shapedTextOrientations.singleLine) {
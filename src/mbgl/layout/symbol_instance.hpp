@@ -176,6 +176,8 @@ public:
     std::array<float, 2> getTextOffset() const { return textOffset; }
     std::array<float, 2> getIconOffset() const { return iconOffset; }
     const std::u16string& getKey() const { return key; }
+    // Buckets symbols by key cheaply, equal hashes still have to be confirmed by comparing the keys
+    std::uint64_t getKeyHash() const { return keyHash; }
     std::optional<size_t> getPlacedRightTextIndex() const { return placedRightTextIndex; }
     std::optional<size_t> getPlacedCenterTextIndex() const { return placedCenterTextIndex; }
     std::optional<size_t> getPlacedLeftTextIndex() const { return placedLeftTextIndex; }
@@ -254,6 +256,7 @@ private:
     std::array<float, 2> iconOffset;
     SYM_GUARD_VALUE(17)
     std::u16string key;
+    std::uint64_t keyHash;
     SYM_GUARD_VALUE(18)
     std::optional<size_t> placedRightTextIndex;
     SYM_GUARD_VALUE(19)
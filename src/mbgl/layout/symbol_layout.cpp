@@ -7,6 +7,7 @@
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/tile.hpp>
@@ -14,6 +15,7 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/i18n.hpp>
+#include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/containers.hpp>
 
@@ -588,6 +590,7 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap,
                                   const ImagePositions& imagePositions) {
     const bool isPointPlacement = layout->get<SymbolPlacement>() == SymbolPlacementType::Point;
     const bool textAlongLine = layout->get<TextRotationAlignment>() == AlignmentType::Map && !isPointPlacement;
+    ShapingCache* shapingCache = ShapingCache::forThisThread();
 
     for (auto it = features.begin(); it != features.end(); ++it) {
         auto& feature = *it;
@@ -611,10 +614,30 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap,
                                     WritingModeType writingMode,
                                     SymbolAnchorType textAnchor,
                                     TextJustifyType textJustify) {
+                const float maxWidth = isPointPlacement
+                                           ? layout->evaluate<TextMaxWidth>(zoom, feature, canonicalID) * util::ONE_EM
+                                           : 0.0f;
+                if (shapingCache) {
+                    return shapingCache->getShaping(formattedText,
+                                                    maxWidth,
+                                                    lineHeight,
+                                                    textAnchor,
+                                                    textJustify,
+                                                    spacing,
+                                                    textOffset,
+                                                    writingMode,
+                                                    bidi,
+                                                    glyphMap,
+                                                    glyphPositions,
+                                                    imagePositions,
+                                                    layoutTextSize,
+                                                    layoutTextSizeAtBucketZoomLevel,
+                                                    allowVerticalPlacement);
+                }
+
                 Shaping result = getShaping(
                     /* string */ formattedText,
-                    /* maxWidth: ems */
-                    isPointPlacement ? layout->evaluate<TextMaxWidth>(zoom, feature, canonicalID) * util::ONE_EM : 0.0f,
+                    /* maxWidth: ems */ maxWidth,
                     /* ems */ lineHeight,
                     textAnchor,
                     textJustify,
@@ -761,6 +784,14 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap,
     }
 
     compareText.clear();
+
+    if (shapingCache) {
+        MLN_TRACE_ZONE(shaping cache);
+        [[maybe_unused]] const auto cacheStats = shapingCache->getStats();
+        MLN_ZONE_VALUE(cacheStats.entries);
+        MLN_ZONE_VALUE(cacheStats.hits);
+        MLN_ZONE_VALUE(cacheStats.misses);
+    }
 }
 
 void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
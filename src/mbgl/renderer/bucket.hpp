@@ -51,6 +51,15 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Approximate size of the vertex, index and image data held by this bucket, which
+    // is also roughly what it takes up on the GPU once uploaded.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
+    // Returns a copy of the bucket that is uploaded and updated independently of this one, or
+    // null if the bucket can't be copied. Copies don't share GPU resources, so a bucket built
+    // once may be handed to several renderers.
+    virtual std::shared_ptr<Bucket> clone() const { return nullptr; }
+
     virtual float getQueryRadius(const RenderLayer&) const { return 0; };
 
     bool needsUpload() const { return hasData() && !uploaded; }
@@ -20,6 +20,16 @@ CircleBucket::CircleBucket(const std::map<std::string, Immutable<LayerProperties
     }
 }
 
+CircleBucket::CircleBucket(const CircleBucket& other)
+    : sharedVertices(std::make_shared<VertexVector>(other.vertices)),
+      sharedTriangles(std::make_shared<TriangleIndexVector>(other.triangles)),
+      segments(cloneSegments(other.segments)),
+      mode(other.mode) {
+    for (const auto& pair : other.paintPropertyBinders) {
+        paintPropertyBinders.emplace(pair.first, pair.second.clone());
+    }
+}
+
 CircleBucket::~CircleBucket() {
     sharedVertices->release();
 }
@@ -32,6 +42,14 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t CircleBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes();
+}
+
+std::shared_ptr<Bucket> CircleBucket::clone() const {
+    return std::shared_ptr<CircleBucket>(new CircleBucket(*this));
+}
+
 namespace {
 template <class Property>
 float get(const CirclePaintProperties::PossiblyEvaluated& evaluated,
@@ -27,6 +27,10 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getMemoryUsage() const override;
+
+    std::shared_ptr<Bucket> clone() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -57,6 +61,9 @@ public:
     std::map<std::string, CircleBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    CircleBucket(const CircleBucket&);
 };
 
 } // namespace mbgl
@@ -19,6 +19,23 @@ FillBucket::FillBucket(const FillBucket::PossiblyEvaluatedLayoutProperties&,
     }
 }
 
+FillBucket::FillBucket(const FillBucket& other)
+    :
+#if MLN_TRIANGULATE_FILL_OUTLINES
+      sharedLineVertices(std::make_shared<LineVertexVector>(other.lineVertices)),
+      sharedLineIndexes(std::make_shared<LineIndexVector>(other.lineIndexes)),
+      lineSegments(cloneSegments(other.lineSegments)),
+#endif // MLN_TRIANGULATE_FILL_OUTLINES
+      sharedBasicLineIndexes(std::make_shared<BasicLineIndexVector>(other.basicLines)),
+      basicLineSegments(cloneSegments(other.basicLineSegments)),
+      sharedVertices(std::make_shared<VertexVector>(other.vertices)),
+      sharedTriangles(std::make_shared<TriangleIndexVector>(other.triangles)),
+      triangleSegments(cloneSegments(other.triangleSegments)) {
+    for (const auto& pair : other.paintPropertyBinders) {
+        paintPropertyBinders.emplace(pair.first, pair.second.clone());
+    }
+}
+
 FillBucket::~FillBucket() {
     sharedVertices->release();
 }
@@ -82,6 +99,18 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !basicLineSegments.empty();
 }
 
+std::size_t FillBucket::getMemoryUsage() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes() + basicLines.bytes();
+#if MLN_TRIANGULATE_FILL_OUTLINES
+    bytes += lineVertices.bytes() + lineIndexes.bytes();
+#endif
+    return bytes;
+}
+
+std::shared_ptr<Bucket> FillBucket::clone() const {
+    return std::shared_ptr<FillBucket>(new FillBucket(*this));
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     using namespace style;
     const auto& evaluated = getEvaluated<FillLayerProperties>(layer.evaluatedProperties);
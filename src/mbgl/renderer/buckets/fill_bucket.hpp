@@ -46,6 +46,10 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getMemoryUsage() const override;
+
+    std::shared_ptr<Bucket> clone() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -83,6 +87,9 @@ public:
     SegmentVector triangleSegments;
 
     std::map<std::string, FillBinders> paintPropertyBinders;
+
+private:
+    FillBucket(const FillBucket&);
 };
 
 } // namespace mbgl
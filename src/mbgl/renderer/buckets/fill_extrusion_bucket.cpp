@@ -52,6 +52,15 @@ FillExtrusionBucket::FillExtrusionBucket(
     }
 }
 
+FillExtrusionBucket::FillExtrusionBucket(const FillExtrusionBucket& other)
+    : sharedVertices(std::make_shared<VertexVector>(other.vertices)),
+      sharedTriangles(std::make_shared<TriangleIndexVector>(other.triangles)),
+      triangleSegments(cloneSegments(other.triangleSegments)) {
+    for (const auto& pair : other.paintPropertyBinders) {
+        paintPropertyBinders.emplace(pair.first, pair.second.clone());
+    }
+}
+
 FillExtrusionBucket::~FillExtrusionBucket() {
     sharedVertices->release();
 }
@@ -179,6 +188,14 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+std::size_t FillExtrusionBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes();
+}
+
+std::shared_ptr<Bucket> FillExtrusionBucket::clone() const {
+    return std::shared_ptr<FillExtrusionBucket>(new FillExtrusionBucket(*this));
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillExtrusionLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillExtrusionTranslate>();
@@ -37,6 +37,10 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getMemoryUsage() const override;
+
+    std::shared_ptr<Bucket> clone() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -73,6 +77,9 @@ public:
     SegmentVector triangleSegments;
 
     std::unordered_map<std::string, FillExtrusionBinders> paintPropertyBinders;
+
+private:
+    FillExtrusionBucket(const FillExtrusionBucket&);
 };
 
 } // namespace mbgl
@@ -20,6 +20,16 @@ HeatmapBucket::HeatmapBucket(const BucketParameters& parameters,
     }
 }
 
+HeatmapBucket::HeatmapBucket(const HeatmapBucket& other)
+    : sharedVertices(std::make_shared<VertexVector>(other.vertices)),
+      sharedTriangles(std::make_shared<TriangleIndexVector>(other.triangles)),
+      segments(cloneSegments(other.segments)),
+      mode(other.mode) {
+    for (const auto& pair : other.paintPropertyBinders) {
+        paintPropertyBinders.emplace(pair.first, pair.second.clone());
+    }
+}
+
 HeatmapBucket::~HeatmapBucket() {
     sharedVertices->release();
 }
@@ -32,6 +42,14 @@ bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t HeatmapBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes();
+}
+
+std::shared_ptr<Bucket> HeatmapBucket::clone() const {
+    return std::shared_ptr<HeatmapBucket>(new HeatmapBucket(*this));
+}
+
 void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
                                const GeometryCollection& geometry,
                                const ImagePositions&,
@@ -30,6 +30,10 @@ public:
                     const CanonicalTileID&) override;
     bool hasData() const override;
 
+    std::size_t getMemoryUsage() const override;
+
+    std::shared_ptr<Bucket> clone() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -62,6 +66,9 @@ public:
     std::map<std::string, HeatmapBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    HeatmapBucket(const HeatmapBucket&);
 };
 
 } // namespace mbgl
@@ -107,4 +107,8 @@ bool HillshadeBucket::hasData() const {
     return demdata.getImage()->valid();
 }
 
+std::size_t HillshadeBucket::getMemoryUsage() const {
+    return vertices.bytes() + indices.bytes() + demdata.getImage()->bytes();
+}
+
 } // namespace mbgl
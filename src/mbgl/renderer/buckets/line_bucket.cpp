@@ -26,6 +26,18 @@ LineBucket::LineBucket(LineBucket::PossiblyEvaluatedLayoutProperties layout_,
     }
 }
 
+LineBucket::LineBucket(const LineBucket& other)
+    : layout(other.layout),
+      sharedVertices(std::make_shared<VertexVector>(other.vertices)),
+      sharedTriangles(std::make_shared<TriangleIndexVector>(other.triangles)),
+      segments(cloneSegments(other.segments)),
+      zoom(other.zoom),
+      overscaling(other.overscaling) {
+    for (const auto& pair : other.paintPropertyBinders) {
+        paintPropertyBinders.emplace(pair.first, pair.second.clone());
+    }
+}
+
 LineBucket::~LineBucket() {
     sharedVertices->release();
 }
@@ -137,6 +149,14 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::getMemoryUsage() const {
+    return vertices.bytes() + triangles.bytes();
+}
+
+std::shared_ptr<Bucket> LineBucket::clone() const {
+    return std::shared_ptr<LineBucket>(new LineBucket(*this));
+}
+
 namespace {
 template <class Property>
 float get(const LinePaintProperties::PossiblyEvaluated& evaluated,
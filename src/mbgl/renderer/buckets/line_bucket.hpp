@@ -35,6 +35,10 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getMemoryUsage() const override;
+
+    std::shared_ptr<Bucket> clone() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -96,6 +100,8 @@ public:
     std::map<std::string, LineBinders> paintPropertyBinders;
 
 private:
+    LineBucket(const LineBucket&);
+
     void addGeometry(const GeometryCoordinates&, const GeometryTileFeature&, const CanonicalTileID&);
 
     const float zoom;
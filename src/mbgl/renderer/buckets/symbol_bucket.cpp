@@ -96,6 +96,26 @@ bool SymbolBucket::hasData() const {
            hasTextCollisionBoxData() || hasIconCollisionCircleData() || hasTextCollisionCircleData();
 }
 
+std::size_t SymbolBucket::getMemoryUsage() const {
+    const auto bufferBytes = [](const Buffer& buffer) {
+        return buffer.vertices().bytes() + buffer.dynamicVertices().bytes() + buffer.opacityVertices().bytes() +
+               buffer.triangles.bytes() + buffer.placedSymbols.size() * sizeof(PlacedSymbol);
+    };
+    const auto collisionBytes = [](const CollisionBuffer* buffer) -> std::size_t {
+        return buffer ? buffer->vertices().bytes() + buffer->dynamicVertices().bytes() : 0;
+    };
+
+    std::size_t bytes = bufferBytes(text) + bufferBytes(icon) + bufferBytes(sdfIcon) +
+                        symbolInstances.size() * sizeof(SymbolInstance);
+    for (const auto* box : {iconCollisionBox.get(), textCollisionBox.get()}) {
+        bytes += box ? collisionBytes(box) + box->lines.bytes() : 0;
+    }
+    for (const auto* circle : {iconCollisionCircle.get(), textCollisionCircle.get()}) {
+        bytes += circle ? collisionBytes(circle) + circle->triangles.bytes() : 0;
+    }
+    return bytes;
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
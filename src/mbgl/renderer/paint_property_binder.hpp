@@ -135,6 +135,9 @@ public:
 
     virtual gfx::VertexVectorBasePtr getSharedVertexVector() const = 0;
 
+    /// Copy of this binder with its own vertex data, which is uploaded separately from ours
+    virtual std::unique_ptr<PaintPropertyBinder> clone() const = 0;
+
     static std::unique_ptr<PaintPropertyBinder> create(const PossiblyEvaluatedType& value, float zoom, T defaultValue);
 
     PaintPropertyStatistics<T> statistics;
@@ -178,6 +181,10 @@ public:
         return {ZoomInterpolatedVertexType<A>{0}};
     }
 
+    std::unique_ptr<PaintPropertyBinder<T, T, PossiblyEvaluatedPropertyValue<T>, A>> clone() const override {
+        return std::make_unique<ConstantPaintPropertyBinder>(*this);
+    }
+
     gfx::VertexVectorBasePtr getSharedVertexVector() const override { return detail::noVector; }
 
 private:
@@ -228,6 +235,11 @@ public:
 
     gfx::VertexVectorBasePtr getSharedVertexVector() const override { return detail::noVector; }
 
+    std::unique_ptr<PaintPropertyBinder<T, std::array<uint16_t, 4>, PossiblyEvaluatedPropertyValue<Faded<T>>, As...>>
+    clone() const override {
+        return std::make_unique<ConstantCrossFadedPaintPropertyBinder>(*this);
+    }
+
 private:
     Faded<T> constant;
     std::tuple<std::array<uint16_t, 4>, std::array<uint16_t, 4>> constantPatternPositions;
@@ -242,6 +254,12 @@ public:
     SourceFunctionPaintPropertyBinder(style::PropertyExpression<T> expression_, T defaultValue_)
         : expression(std::move(expression_)),
           defaultValue(std::move(defaultValue_)) {}
+    SourceFunctionPaintPropertyBinder(const SourceFunctionPaintPropertyBinder& other)
+        : PaintPropertyBinder<T, T, PossiblyEvaluatedPropertyValue<T>, A>(other),
+          expression(other.expression),
+          defaultValue(other.defaultValue),
+          sharedVertexVector(std::make_shared<gfx::VertexVector<BaseVertex>>(other.vertexVector)),
+          featureMap(other.featureMap) {}
     ~SourceFunctionPaintPropertyBinder() override { sharedVertexVector->release(); }
 
     void setPatternParameters(const std::optional<ImagePosition>&,
@@ -325,6 +343,10 @@ public:
 
     gfx::VertexVectorBasePtr getSharedVertexVector() const override { return sharedVertexVector; }
 
+    std::unique_ptr<PaintPropertyBinder<T, T, PossiblyEvaluatedPropertyValue<T>, A>> clone() const override {
+        return std::make_unique<SourceFunctionPaintPropertyBinder>(*this);
+    }
+
 private:
     style::PropertyExpression<T> expression;
     T defaultValue;
@@ -347,6 +369,13 @@ public:
         : expression(std::move(expression_)),
           defaultValue(std::move(defaultValue_)),
           zoomRange({zoom, zoom + 1}) {}
+    CompositeFunctionPaintPropertyBinder(const CompositeFunctionPaintPropertyBinder& other)
+        : PaintPropertyBinder<T, T, PossiblyEvaluatedPropertyValue<T>, A>(other),
+          expression(other.expression),
+          defaultValue(other.defaultValue),
+          zoomRange(other.zoomRange),
+          sharedVertexVector(std::make_shared<gfx::VertexVector<Vertex>>(other.vertexVector)),
+          featureMap(other.featureMap) {}
     ~CompositeFunctionPaintPropertyBinder() override { sharedVertexVector->release(); }
 
     void setPatternParameters(const std::optional<ImagePosition>&,
@@ -452,6 +481,10 @@ public:
         return {vertexVector.at(index)};
     }
 
+    std::unique_ptr<PaintPropertyBinder<T, T, PossiblyEvaluatedPropertyValue<T>, A>> clone() const override {
+        return std::make_unique<CompositeFunctionPaintPropertyBinder>(*this);
+    }
+
 private:
     style::PropertyExpression<T> expression;
     T defaultValue;
@@ -477,6 +510,15 @@ public:
         : expression(std::move(expression_)),
           defaultValue(std::move(defaultValue_)),
           zoomRange({zoom, zoom + 1}) {}
+    CompositeCrossFadedPaintPropertyBinder(const CompositeCrossFadedPaintPropertyBinder& other)
+        : PaintPropertyBinder<T, std::array<uint16_t, 4>, PossiblyEvaluatedPropertyValue<Faded<T>>, A1, A2>(other),
+          expression(other.expression),
+          defaultValue(other.defaultValue),
+          zoomRange(other.zoomRange),
+          sharedPatternToVertexVector(std::make_shared<gfx::VertexVector<Vertex>>(other.patternToVertexVector)),
+          zoomInVertexVector(other.zoomInVertexVector),
+          zoomOutVertexVector(other.zoomOutVertexVector),
+          crossfade(other.crossfade) {}
     ~CompositeCrossFadedPaintPropertyBinder() override { sharedPatternToVertexVector->release(); }
 
     void setPatternParameters(const std::optional<ImagePosition>&,
@@ -547,6 +589,11 @@ public:
 
     gfx::VertexVectorBasePtr getSharedVertexVector() const override { return sharedPatternToVertexVector; }
 
+    std::unique_ptr<PaintPropertyBinder<T, std::array<uint16_t, 4>, PossiblyEvaluatedPropertyValue<Faded<T>>, A1, A2>>
+    clone() const override {
+        return std::make_unique<CompositeCrossFadedPaintPropertyBinder>(*this);
+    }
+
 private:
     style::PropertyExpression<T> expression;
     T defaultValue;
@@ -660,6 +707,9 @@ public:
     PaintPropertyBinders(PaintPropertyBinders&&) noexcept = default;
     PaintPropertyBinders(const PaintPropertyBinders&) = delete;
 
+    /// Copies every binder, see `PaintPropertyBinder::clone`
+    PaintPropertyBinders clone() const { return PaintPropertyBinders(CloneTag{}, *this); }
+
     void populateVertexVectors(const GeometryTileFeature& feature,
                                std::size_t length,
                                std::size_t index,
@@ -722,6 +772,10 @@ public:
     }
 
 private:
+    struct CloneTag {};
+    PaintPropertyBinders(CloneTag, const PaintPropertyBinders& other)
+        : binders(other.binders.template get<Ps>()->clone()...) {}
+
     Binders binders;
 };
 
@@ -116,7 +116,8 @@ RenderOrchestrator::RenderOrchestrator(bool backgroundLayerAsColor_,
                                        TaggedScheduler& threadPool_,
                                        const std::optional<std::string>& localFontFamily_)
     : observer(&nullObserver()),
-      glyphManager(std::make_unique<GlyphManager>(std::make_unique<LocalGlyphRasterizer>(localFontFamily_))),
+      glyphManager(std::make_unique<GlyphManager>(std::make_unique<LocalGlyphRasterizer>(localFontFamily_),
+                                                  localFontFamily_.value_or(std::string()))),
       imageManager(std::make_unique<ImageManager>()),
       lineAtlas(std::make_unique<LineAtlas>()),
       patternAtlas(std::make_unique<PatternAtlas>()),
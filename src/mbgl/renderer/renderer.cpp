@@ -5,6 +5,7 @@
 #include <mbgl/gfx/dynamic_texture_atlas.hpp>
 #include <mbgl/gfx/renderer_backend.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/renderer_impl.hpp>
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/renderer/render_tree.hpp>
@@ -15,6 +16,23 @@
 
 namespace mbgl {
 
+namespace {
+
+// Fragmentation above which atlas textures are retired, 1.0 never retiring any
+double getAtlasCompactionThreshold() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_ATLAS_COMPACTION_THRESHOLD);
+    if (const auto* doubleValue = value.getDouble()) {
+        return *doubleValue;
+    } else if (const auto* uintValue = value.getUint()) {
+        return static_cast<double>(*uintValue);
+    } else if (const auto* intValue = value.getInt()) {
+        return static_cast<double>(*intValue);
+    }
+    return 1.0;
+}
+
+} // namespace
+
 Renderer::Renderer(gfx::RendererBackend& backend, float pixelRatio_, const std::optional<std::string>& localFontFamily_)
     : impl(std::make_unique<Impl>(backend, pixelRatio_, localFontFamily_)) {}
 
@@ -45,6 +63,8 @@ void Renderer::render(const std::shared_ptr<UpdateParameters>& updateParameters)
         renderTree->prepare();
         impl->render(*renderTree, updateParameters);
     }
+
+    impl->dynamicTextureAtlas->compact(getAtlasCompactionThreshold());
 }
 
 std::vector<Feature> Renderer::queryRenderedFeatures(const ScreenLineString& geometry,
@@ -100,10 +100,13 @@ void RenderRasterDEMSource::onTileChanged(Tile& tile) {
                     const DEMTileNeighbors& borderMask = opposites[mask];
                     if ((borderTile.neighboringTiles & borderMask) != borderMask) {
                         borderTile.backfillBorder(demtile, borderMask);
+                        borderTile.flushBackfill();
                     }
                 }
             }
         }
+        // The borders are stitched on the worker, all at once
+        demtile.flushBackfill();
     }
     RenderTileSource::onTileChanged(tile);
 }
@@ -6,6 +6,7 @@
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
@@ -156,9 +157,22 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     // using, e.g. as a replacement for tile that aren't loaded yet.
     std::set<OverscaledTileID> retain;
 
+    // Tiles closest to the center of the viewport and to the ideal zoom level are loaded first,
+    // see `LoadPriority`.
+    const LatLng center = parameters.transformState.getLatLng();
+    auto getLoadPriority = [&](const OverscaledTileID& tileID) -> float {
+        const auto& canonical = tileID.canonical;
+        const TileCoordinatePoint point = TileCoordinate::fromLatLng(canonical.z, center).p;
+        const double dx = canonical.x + 0.5 + tileID.wrap * std::pow(2.0, canonical.z) - point.x;
+        const double dy = canonical.y + 0.5 - point.y;
+        return static_cast<float>(std::sqrt(dx * dx + dy * dy) + std::abs(tileZoom - tileID.overscaledZ));
+    };
+
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
         if (retain.emplace(tile.id).second) {
-            tile.setUpdateParameters({.minimumUpdateInterval = minimumUpdateInterval, .isVolatile = isVolatile});
+            tile.setUpdateParameters({.minimumUpdateInterval = minimumUpdateInterval,
+                                      .isVolatile = isVolatile,
+                                      .loadPriority = getLoadPriority(tile.id)});
             tile.setNecessity(necessity);
         }
 
@@ -29,6 +29,9 @@ public:
     // NOLINTNEXTLINE(performance-noexcept-move-constructor)
     SegmentBase(SegmentBase&&) = default;
 
+    /// Copy of the ranges, without the draw scopes created for them
+    SegmentBase clone() const { return {vertexOffset, indexOffset, vertexLength, indexLength, sortKey}; }
+
     const std::size_t vertexOffset;
     const std::size_t indexOffset;
 
@@ -49,4 +52,13 @@ public:
 
 using SegmentVector = std::vector<SegmentBase>;
 
+inline SegmentVector cloneSegments(const SegmentVector& segments) {
+    SegmentVector result;
+    result.reserve(segments.size());
+    for (const auto& segment : segments) {
+        result.push_back(segment.clone());
+    }
+    return result;
+}
+
 } // namespace mbgl
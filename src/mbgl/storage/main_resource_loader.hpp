@@ -15,6 +15,7 @@ public:
 
     bool supportsCacheOnlyRequests() const override;
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void forward(const Resource&, const Response&, std::function<void()>) override;
     bool canRequest(const Resource&) const override;
     void pause() override;
     void resume() override;
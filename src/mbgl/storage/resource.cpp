@@ -41,6 +41,14 @@ std::string getTileBBox(int32_t x, int32_t y, int8_t z) {
 }
 } // namespace
 
+std::atomic<uint64_t> LoadPriority::changes{0};
+
+void LoadPriority::set(float value_) {
+    if (value.exchange(value_, std::memory_order_relaxed) != value_) {
+        changes.fetch_add(1, std::memory_order_release);
+    }
+}
+
 Resource Resource::style(const std::string& url) {
     return Resource{Resource::Kind::Style, url};
 }
@@ -111,6 +111,16 @@ std::optional<GeoJSONOptions> Converter<GeoJSONOptions>::operator()(const Conver
         }
     }
 
+    const auto incrementalUpdatesValue = objectMember(value, "incrementalUpdates");
+    if (incrementalUpdatesValue) {
+        if (toBool(*incrementalUpdatesValue)) {
+            options.incrementalUpdates = *toBool(*incrementalUpdatesValue);
+        } else {
+            error.message = "GeoJSON source incrementalUpdates value must be a boolean";
+            return std::nullopt;
+        }
+    }
+
     const auto clusterProperties = objectMember(value, "clusterProperties");
     if (clusterProperties) {
         if (!isObject(*clusterProperties)) {
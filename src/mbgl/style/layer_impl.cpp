@@ -1,4 +1,8 @@
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
+
+#include <algorithm>
+#include <string_view>
 
 namespace mbgl {
 namespace style {
@@ -9,5 +13,17 @@ Layer::Impl::Impl(std::string layerID, std::string sourceID)
 
 void Layer::Impl::populateFontStack(std::set<FontStack>&) const {}
 
+void Layer::Impl::updateFingerprint(Layer& layer) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    conversion::stringify(writer, layer.serialize());
+
+    auto impl = layer.mutableBaseImpl();
+    // Zero means unknown
+    impl->fingerprint.value = std::max<std::size_t>(
+        std::hash<std::string_view>()(std::string_view(buffer.GetString(), buffer.GetSize())), 1);
+    layer.baseImpl = std::move(impl);
+}
+
 } // namespace style
 } // namespace mbgl
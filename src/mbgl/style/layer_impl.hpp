@@ -59,6 +59,21 @@ public:
     float maxZoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
 
+    // Hash of the serialized layer, set by `updateFingerprint`. Layers with equal non-zero
+    // fingerprints render the same. Copies start at zero again, since they're made to be modified.
+    class Fingerprint {
+    public:
+        Fingerprint() = default;
+        Fingerprint(const Fingerprint&) noexcept {}
+        Fingerprint& operator=(const Fingerprint&) = delete;
+
+        std::size_t value = 0;
+    };
+    Fingerprint fingerprint;
+
+    // Stores a hash of the serialized `layer` in its implementation, see `fingerprint`
+    static void updateFingerprint(Layer& layer);
+
 protected:
     Impl(const Impl&) = default;
 };
@@ -51,6 +51,26 @@ void GeoJSONSource::setGeoJSONData(std::shared_ptr<GeoJSONData> geoJSONData) {
     observer->onSourceChanged(*this);
 }
 
+void GeoJSONSource::updateGeoJSON(const GeoJSONFeatureDiff& diff) {
+    auto current = impl().getData().lock();
+    if (!current) {
+        if (url) {
+            // The data still to be loaded from the URL would replace the update, removals included
+            Log::Warning(Event::Style, "GeoJSON source \"" + getID() + "\" can't be updated before its data loaded");
+            return;
+        }
+        // Without any features to remove, the added features are all the data there is
+        setGeoJSON(diff.add);
+        return;
+    }
+
+    if (auto updated = current->update(diff)) {
+        setGeoJSONData(std::move(updated));
+    } else {
+        Log::Warning(Event::Style, "GeoJSON source \"" + getID() + "\" doesn't support incremental updates");
+    }
+}
+
 std::optional<std::string> GeoJSONSource::getURL() const {
     return url;
 }
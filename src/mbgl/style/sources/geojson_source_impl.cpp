@@ -2,6 +2,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/feature.hpp>
+#include <mbgl/util/hash.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/identity.hpp>
@@ -12,17 +13,392 @@
 #endif
 
 #include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
 #include <supercluster.hpp>
 
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <numbers>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+using Features = GeoJSONData::Features;
+using TileFeatures = GeoJSONData::TileFeatures;
+using Box = mapbox::geometry::box<double>;
+
+Features toFeatures(const GeoJSON& geoJSON) {
+    return geoJSON.match(
+        [](const mapbox::geometry::geometry<double>& geometry) {
+            return Features{mapbox::feature::feature<double>{geometry}};
+        },
+        [](const mapbox::feature::feature<double>& feature) { return Features{feature}; },
+        [](const Features& features) { return features; });
+}
+
+struct FeatureIdentifierHash {
+    std::size_t operator()(const FeatureIdentifier& id) const {
+        return id.match([](const mapbox::feature::null_value_t&) -> std::size_t { return 0; },
+                        [&](const auto& value) -> std::size_t { return util::hash(id.which(), value); });
+    }
+};
+
+Features applyDiff(const Features& features, const GeoJSONFeatureDiff& diff) {
+    if (diff.removeAll) {
+        return diff.add;
+    }
+
+    std::unordered_set<FeatureIdentifier, FeatureIdentifierHash> removed(diff.remove.begin(), diff.remove.end());
+    for (const auto& feature : diff.add) {
+        if (!feature.id.is<mapbox::feature::null_value_t>()) {
+            removed.insert(feature.id);
+        }
+    }
+
+    Features result;
+    result.reserve(features.size() + diff.add.size());
+    for (const auto& feature : features) {
+        if (feature.id.is<mapbox::feature::null_value_t>() || !removed.contains(feature.id)) {
+            result.push_back(feature);
+        }
+    }
+    result.insert(result.end(), diff.add.begin(), diff.add.end());
+    return result;
+}
+
+// The bounds of a feature in world coordinates from 0 to 1, projected like GeoJSON-VT does
+std::optional<Box> getBounds(const mapbox::geometry::geometry<double>& geometry) {
+    std::optional<Box> bounds;
+    mapbox::geometry::for_each_point(geometry, [&](const mapbox::geometry::point<double>& point) {
+        const double sine = std::sin(point.y * std::numbers::pi / 180);
+        const double x = point.x / 360 + 0.5;
+        const double y = std::clamp(0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / std::numbers::pi, 0.0, 1.0);
+        if (!bounds) {
+            bounds = Box{{x, y}, {x, y}};
+        } else {
+            bounds->min = {std::min(bounds->min.x, x), std::min(bounds->min.y, y)};
+            bounds->max = {std::max(bounds->max.x, x), std::max(bounds->max.y, y)};
+        }
+    });
+    return bounds;
+}
+
+bool intersects(const Box& a, const Box& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+// Features wrap around the antimeridian, so copies one world to either side are checked too
+bool intersectsWrapped(const Box& bounds, const Box& query) {
+    return intersects(bounds, query) ||
+           intersects(bounds, {{query.min.x - 1, query.min.y}, {query.max.x - 1, query.max.y}}) ||
+           intersects(bounds, {{query.min.x + 1, query.min.y}, {query.max.x + 1, query.max.y}});
+}
+
+} // namespace
+
+// Slices every tile on its own from the features intersecting it, which are found through a
+// grid. An update copies the grid cells and cached tiles its changes don't touch, so that
+// only the touched tiles are sliced again. The id index isn't copied but moved to the updated
+// data, which replaces this data in the source.
+class IncrementalGeoJSONVTData final : public GeoJSONData,
+                                       public std::enable_shared_from_this<IncrementalGeoJSONVTData> {
+public:
+    void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool runSynchronously) final {
+        assert(fn);
+        if (runSynchronously) {
+            fn(*getTileFeatures(id));
+        } else {
+            sequencedScheduler->scheduleAndReplyValue(
+                util::SimpleIdentity::Empty,
+                [id, self = shared_from_this()]() -> TileFeatures { return *self->getTileFeatures(id); },
+                fn);
+        }
+    }
+
+    Features getChildren(const std::uint32_t) final { return {}; }
+
+    Features getLeaves(const std::uint32_t, const std::uint32_t, const std::uint32_t) final { return {}; }
+
+    std::uint8_t getClusterExpansionZoom(std::uint32_t) final { return 0; }
+
+    std::shared_ptr<GeoJSONData> update(const GeoJSONFeatureDiff& diff) final {
+        return std::shared_ptr<GeoJSONData>(new IncrementalGeoJSONVTData(shared_from_this(), diff));
+    }
+
+    bool isTileAffected(const CanonicalTileID& id, const GeoJSONData& previous) const final {
+        // Data which was freed can't be the previous data, even if the same address was reused
+        if (changedAll || base.lock().get() != &previous) {
+            return true;
+        }
+        const Box query = getTileBounds(id);
+        return std::ranges::any_of(changed, [&](const Box& bounds) { return intersectsWrapped(bounds, query); });
+    }
+
+    IncrementalGeoJSONVTData(const Features& features,
+                             const mapbox::geojsonvt::TileOptions& options_,
+                             std::shared_ptr<Scheduler> sequencedScheduler_)
+        : options(options_),
+          sequencedScheduler(std::move(sequencedScheduler_)),
+          cells(gridSize * gridSize),
+          changedAll(true) {
+        assert(sequencedScheduler);
+        std::ranges::generate(cells, [] { return std::make_shared<Cell>(); });
+        std::vector<bool> owned(cells.size(), true);
+        for (const auto& feature : features) {
+            add(feature, owned);
+        }
+    }
+
+private:
+    struct Entry {
+        mapbox::feature::feature<double> feature;
+        std::optional<Box> bounds;
+        // Features are sliced in the order they were added in
+        uint64_t order;
+    };
+    using Cell = std::vector<std::shared_ptr<const Entry>>;
+    using Ids = std::unordered_map<FeatureIdentifier, std::shared_ptr<const Entry>, FeatureIdentifierHash>;
+
+    static constexpr uint32_t gridSize = 64;
+    // Features covering more cells than this aren't added to the grid
+    static constexpr uint32_t maxFeatureCells = 16;
+    static constexpr std::size_t maxCachedTiles = 512;
+
+    IncrementalGeoJSONVTData(const std::shared_ptr<const IncrementalGeoJSONVTData>& base_,
+                             const GeoJSONFeatureDiff& diff)
+        : options(base_->options),
+          sequencedScheduler(base_->sequencedScheduler),
+          nextOrder(base_->nextOrder),
+          base(base_),
+          changedAll(diff.removeAll) {
+        const IncrementalGeoJSONVTData& other = *base_;
+        if (diff.removeAll) {
+            cells.resize(gridSize * gridSize);
+            std::ranges::generate(cells, [] { return std::make_shared<Cell>(); });
+        } else {
+            cells = other.cells;
+            unindexed = other.unindexed;
+            ids = other.takeIds();
+        }
+
+        std::vector<bool> owned(cells.size(), diff.removeAll);
+        for (const auto& id : diff.remove) {
+            remove(id, owned);
+        }
+        for (const auto& feature : diff.add) {
+            add(feature, owned);
+        }
+
+        std::scoped_lock lock(other.mutex);
+        for (const auto& [id, features] : other.tiles) {
+            if (!isTileAffected(id, other)) {
+                tiles.emplace(id, features);
+            }
+        }
+    }
+
+    struct CellRange {
+        uint32_t minX, minY, maxX, maxY;
+    };
+
+    static CellRange getCells(const Box& bounds) {
+        const auto cell = [](double value) {
+            return static_cast<uint32_t>(std::clamp(value * gridSize, 0.0, gridSize - 1.0));
+        };
+        return {cell(bounds.min.x), cell(bounds.min.y), cell(bounds.max.x), cell(bounds.max.y)};
+    }
+
+    // Whether the feature is kept out of the grid because it's large or crosses the antimeridian
+    static bool isUnindexed(const Box& bounds) {
+        const CellRange range = getCells(bounds);
+        return bounds.min.x < 0 || bounds.max.x > 1 ||
+               (range.maxX - range.minX + 1) * (range.maxY - range.minY + 1) > maxFeatureCells;
+    }
+
+    // Hands the id index over to data updated from this one. Data which is updated more than once
+    // rebuilds the index from the grid, which holds every feature with bounds.
+    Ids takeIds() const {
+        std::scoped_lock lock(mutex);
+        if (!idsTaken) {
+            idsTaken = true;
+            return std::move(ids);
+        }
+
+        Ids result;
+        const auto addIds = [&](const Cell& cell) {
+            for (const auto& entry : cell) {
+                if (!entry->feature.id.is<mapbox::feature::null_value_t>()) {
+                    result.emplace(entry->feature.id, entry);
+                }
+            }
+        };
+        addIds(unindexed);
+        for (const auto& cell : cells) {
+            addIds(*cell);
+        }
+        return result;
+    }
+
+    // Cells are shared with the data this was updated from, and copied before they're first modified
+    Cell& getCell(uint32_t x, uint32_t y, std::vector<bool>& owned) {
+        const uint32_t index = y * gridSize + x;
+        if (!owned[index]) {
+            cells[index] = std::make_shared<Cell>(*cells[index]);
+            owned[index] = true;
+        }
+        return *cells[index];
+    }
+
+    void add(const mapbox::feature::feature<double>& feature, std::vector<bool>& owned) {
+        auto entry = std::make_shared<const Entry>(Entry{feature, getBounds(feature.geometry), nextOrder++});
+        const bool hasId = !feature.id.is<mapbox::feature::null_value_t>();
+        if (hasId) {
+            // Replaces the feature with the same id, which must leave the grid as well
+            remove(feature.id, owned);
+        }
+        // Features without any points don't show up in tiles, so there's nothing to index
+        if (!entry->bounds) {
+            return;
+        }
+        if (hasId) {
+            ids.emplace(feature.id, entry);
+        }
+
+        if (!changedAll) {
+            changed.push_back(*entry->bounds);
+        }
+        if (isUnindexed(*entry->bounds)) {
+            unindexed.push_back(std::move(entry));
+            return;
+        }
+        const CellRange range = getCells(*entry->bounds);
+        for (uint32_t y = range.minY; y <= range.maxY; ++y) {
+            for (uint32_t x = range.minX; x <= range.maxX; ++x) {
+                getCell(x, y, owned).push_back(entry);
+            }
+        }
+    }
+
+    void remove(const FeatureIdentifier& id, std::vector<bool>& owned) {
+        const auto it = ids.find(id);
+        if (it == ids.end()) {
+            return;
+        }
+        const auto entry = std::move(it->second);
+        ids.erase(it);
+        assert(entry->bounds);
+
+        if (!changedAll) {
+            changed.push_back(*entry->bounds);
+        }
+        if (isUnindexed(*entry->bounds)) {
+            std::erase(unindexed, entry);
+            return;
+        }
+        const CellRange range = getCells(*entry->bounds);
+        for (uint32_t y = range.minY; y <= range.maxY; ++y) {
+            for (uint32_t x = range.minX; x <= range.maxX; ++x) {
+                std::erase(getCell(x, y, owned), entry);
+            }
+        }
+    }
+
+    // The area of the tile including its buffer, in world coordinates
+    Box getTileBounds(const CanonicalTileID& id) const {
+        const double scale = 1.0 / (1u << id.z);
+        const double buffer = scale * options.buffer / options.extent;
+        return {{id.x * scale - buffer, id.y * scale - buffer},
+                {(id.x + 1) * scale + buffer, (id.y + 1) * scale + buffer}};
+    }
+
+    TileFeatures sliceTile(const CanonicalTileID& id) const {
+        const Box query = getTileBounds(id);
+
+        std::vector<const Entry*> candidates;
+        for (const auto& entry : unindexed) {
+            if (intersectsWrapped(*entry->bounds, query)) {
+                candidates.push_back(entry.get());
+            }
+        }
+        // The buffer of tiles at the antimeridian reaches into the other side of the world
+        for (const double shift : {0.0, -1.0, 1.0}) {
+            const Box shifted{{query.min.x + shift, query.min.y}, {query.max.x + shift, query.max.y}};
+            if (shifted.max.x < 0 || shifted.min.x > 1) {
+                continue;
+            }
+            const CellRange range = getCells(shifted);
+            for (uint32_t y = range.minY; y <= range.maxY; ++y) {
+                for (uint32_t x = range.minX; x <= range.maxX; ++x) {
+                    for (const auto& entry : *cells[y * gridSize + x]) {
+                        if (intersects(*entry->bounds, shifted)) {
+                            candidates.push_back(entry.get());
+                        }
+                    }
+                }
+            }
+        }
+        if (candidates.empty()) {
+            return {};
+        }
+
+        std::ranges::sort(candidates, {}, &Entry::order);
+        const auto duplicates = std::ranges::unique(candidates);
+        candidates.erase(duplicates.begin(), duplicates.end());
+
+        Features features;
+        features.reserve(candidates.size());
+        for (const auto* entry : candidates) {
+            features.push_back(entry->feature);
+        }
+        const GeoJSON geoJSON{std::move(features)};
+        return mapbox::geojsonvt::geoJSONToTile(geoJSON, id.z, id.x, id.y, options, true, true).features;
+    }
+
+    std::shared_ptr<const TileFeatures> getTileFeatures(const CanonicalTileID& id) {
+        {
+            std::scoped_lock lock(mutex);
+            if (const auto it = tiles.find(id); it != tiles.end()) {
+                return it->second;
+            }
+        }
+
+        auto features = std::make_shared<const TileFeatures>(sliceTile(id));
+        std::scoped_lock lock(mutex);
+        if (tiles.size() >= maxCachedTiles) {
+            tiles.clear();
+        }
+        tiles.emplace(id, features);
+        return features;
+    }
+
+    const mapbox::geojsonvt::TileOptions options;
+    const std::shared_ptr<Scheduler> sequencedScheduler;
+
+    std::vector<std::shared_ptr<Cell>> cells;
+    Cell unindexed;
+    uint64_t nextOrder = 0;
+
+    // The data this was updated from, and the bounds of the features which changed
+    std::weak_ptr<const GeoJSONData> base;
+    bool changedAll = false;
+    std::vector<Box> changed;
+
+    mutable std::mutex mutex;
+    std::unordered_map<CanonicalTileID, std::shared_ptr<const TileFeatures>> tiles;
+    // Emptied once taken by the data updated from this one
+    mutable Ids ids;
+    mutable bool idsTaken = false;
+};
+
 class GeoJSONVTData final : public GeoJSONData {
     void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool runSynchronously) final {
         assert(fn);
@@ -44,17 +420,27 @@ class GeoJSONVTData final : public GeoJSONData {
 
     std::uint8_t getClusterExpansionZoom(std::uint32_t) final { return 0; }
 
+    // GeoJSON-VT doesn't keep the features it was created from, so the data can only be replaced
+    std::shared_ptr<GeoJSONData> update(const GeoJSONFeatureDiff& diff) final {
+        if (!diff.removeAll) {
+            return nullptr;
+        }
+        return std::make_shared<IncrementalGeoJSONVTData>(diff.add, options, sequencedScheduler);
+    }
+
     friend GeoJSONData;
     GeoJSONVTData(const GeoJSON& geoJSON,
-                  const mapbox::geojsonvt::Options& options,
+                  const mapbox::geojsonvt::Options& options_,
                   std::shared_ptr<Scheduler> sequencedScheduler_)
-        : impl(std::make_shared<mapbox::geojsonvt::GeoJSONVT>(geoJSON, options)),
-          sequencedScheduler(std::move(sequencedScheduler_)) {
+        : impl(std::make_shared<mapbox::geojsonvt::GeoJSONVT>(geoJSON, options_)),
+          sequencedScheduler(std::move(sequencedScheduler_)),
+          options(options_) {
         assert(sequencedScheduler);
     }
 
     std::shared_ptr<mapbox::geojsonvt::GeoJSONVT> impl; // Accessed on worker thread.
     std::shared_ptr<Scheduler> sequencedScheduler;
+    const mapbox::geojsonvt::Options options;
 };
 
 class SuperclusterData final : public GeoJSONData {
@@ -73,10 +459,22 @@ class SuperclusterData final : public GeoJSONData {
         return impl.getClusterExpansionZoom(cluster_id);
     }
 
+    // Clusters depend on all the points, so the whole index is rebuilt from the points it holds
+    std::shared_ptr<GeoJSONData> update(const GeoJSONFeatureDiff& diff) final {
+        return create(applyDiff(impl.features, diff), sequencedScheduler, geoJSONOptions);
+    }
+
     friend GeoJSONData;
-    SuperclusterData(const Features& features, const mapbox::supercluster::Options& options)
-        : impl(features, options) {}
+    SuperclusterData(const Features& features_,
+                     const mapbox::supercluster::Options& options,
+                     std::shared_ptr<Scheduler> sequencedScheduler_,
+                     Immutable<GeoJSONOptions> geoJSONOptions_)
+        : impl(features_, options),
+          sequencedScheduler(std::move(sequencedScheduler_)),
+          geoJSONOptions(std::move(geoJSONOptions_)) {}
     mapbox::supercluster::Supercluster impl;
+    const std::shared_ptr<Scheduler> sequencedScheduler;
+    const Immutable<GeoJSONOptions> geoJSONOptions;
 };
 
 template <class T>
@@ -125,7 +523,8 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
                 toReturn[p.first] = evaluateFeature<Value>(*feature, p.second.second, accumulated);
             }
         };
-        return std::shared_ptr<GeoJSONData>(new SuperclusterData(geoJSON.get<Features>(), clusterOptions));
+        return std::shared_ptr<GeoJSONData>(
+            new SuperclusterData(geoJSON.get<Features>(), clusterOptions, std::move(sequencedScheduler), options));
     }
 
     mapbox::geojsonvt::Options vtOptions;
@@ -134,6 +533,9 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
     vtOptions.buffer = static_cast<uint16_t>(::round(scale * options->buffer));
     vtOptions.tolerance = scale * options->tolerance;
     vtOptions.lineMetrics = options->lineMetrics;
+    if (options->incrementalUpdates) {
+        return std::make_shared<IncrementalGeoJSONVTData>(toFeatures(geoJSON), vtOptions, std::move(sequencedScheduler));
+    }
     return std::shared_ptr<GeoJSONData>(new GeoJSONVTData(geoJSON, vtOptions, std::move(sequencedScheduler)));
 }
 
@@ -19,6 +19,7 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/style_impl.hpp>
 #include <mbgl/style/transition_options.hpp>
+#include <mbgl/tile/parsed_tile_cache.hpp>
 #include <mbgl/util/async_request.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/logging.hpp>
@@ -109,7 +110,13 @@ void Style::Impl::parse(const std::string& json_) {
         addSource(std::move(source));
     }
 
+    // Layers loaded with the style can share parsed tiles with other maps until they're modified.
+    // The setting is read here only, tiles use the cache as sized here.
+    const bool fingerprintLayers = bool(ParsedTileCache::updateDefault());
     for (auto& layer : parser.layers) {
+        if (fingerprintLayers) {
+            Layer::Impl::updateFingerprint(*layer);
+        }
         addLayer(std::move(layer));
     }
 
@@ -12,11 +12,21 @@
 
 #include <mbgl/renderer/buckets/symbol_bucket.hpp> // For PlacedSymbol: pull out to another location
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <utility>
 
 namespace mbgl {
 
 namespace {
+
+// Extended by any boundaries
+constexpr CollisionBoundaries kNoBounds{{std::numeric_limits<float>::max(),
+                                         std::numeric_limits<float>::max(),
+                                         std::numeric_limits<float>::lowest(),
+                                         std::numeric_limits<float>::lowest()}};
+
 // When a symbol crosses the edge that causes it to be included in
 // collision detection, it will cause changes in the symbols around
 // it. This constant specifies how many pixels to pad the edge of
@@ -32,6 +42,19 @@ inline float findViewportPadding(const TransformState& transformState, MapMode m
     return (transformState.getPitch() != 0.0f) ? viewportPaddingDefault * 2 : viewportPaddingDefault;
 }
 
+template <typename Geometry>
+bool hitTest(const CollisionIndex::CollisionGrid& grid,
+             const Geometry& geometry,
+             const std::optional<CollisionGroupPredicate>& collisionGroupPredicate) {
+    return collisionGroupPredicate ? grid.hitTest(geometry, *collisionGroupPredicate) : grid.hitTest(geometry);
+}
+
+bool hitTestAny(const CollisionIndex::CollisionGrid& grid,
+                const std::vector<CollisionIndex::CollisionGrid::BCircle>& circles,
+                const std::optional<CollisionGroupPredicate>& collisionGroupPredicate) {
+    return collisionGroupPredicate ? grid.hitTestAny(circles, *collisionGroupPredicate) : grid.hitTestAny(circles);
+}
+
 } // namespace
 
 CollisionIndex::CollisionIndex(const TransformState& transformState_, MapMode mapMode)
@@ -48,7 +71,8 @@ CollisionIndex::CollisionIndex(const TransformState& transformState_, MapMode ma
       gridRightBoundary(transformState.getSize().width + 2 * viewportPadding),
       gridBottomBoundary(transformState.getSize().height + 2 * viewportPadding),
       pitchFactor(
-          static_cast<float>(std::cos(transformState.getPitch()) * transformState.getCameraToCenterDistance())) {}
+          static_cast<float>(std::cos(transformState.getPitch()) * transformState.getCameraToCenterDistance())),
+      testedBounds(kNoBounds) {}
 
 float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance,
                                               const float lastSegmentAngle,
@@ -76,6 +100,17 @@ float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance,
            (incidenceStretch - 1) * lastSegmentTile * std::abs(std::sin(lastSegmentAngle));
 }
 
+CollisionBoundaries CollisionIndex::takeTestedBounds() {
+    return std::exchange(testedBounds, kNoBounds);
+}
+
+void CollisionIndex::extendTestedBounds(const CollisionBoundaries& boundaries) {
+    testedBounds[0] = std::min(testedBounds[0], boundaries[0]);
+    testedBounds[1] = std::min(testedBounds[1], boundaries[1]);
+    testedBounds[2] = std::max(testedBounds[2], boundaries[2]);
+    testedBounds[3] = std::max(testedBounds[3], boundaries[3]);
+}
+
 bool CollisionIndex::isOffscreen(const CollisionBoundaries& boundaries) const {
     return boundaries[2] < viewportPadding || boundaries[0] >= screenRightBoundary || boundaries[3] < viewportPadding ||
            boundaries[1] >= screenBottomBoundary;
@@ -159,16 +194,17 @@ std::pair<bool, bool> CollisionIndex::placeFeature(
     const bool pitchWithMap,
     const bool collisionDebug,
     const std::optional<CollisionBoundaries>& avoidEdges,
-    const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
+    const std::optional<CollisionGroupPredicate>& collisionGroupPredicate,
     std::vector<ProjectedCollisionBox>& projectedBoxes) {
     assert(projectedBoxes.empty());
     if (!feature.alongLine) {
         const CollisionBox& box = feature.boxes.front();
         auto collisionBoundaries = getProjectedCollisionBoundaries(posMatrix, shift, textPixelRatio, box);
+        extendTestedBounds(collisionBoundaries);
         projectedBoxes.emplace_back(
             collisionBoundaries[0], collisionBoundaries[1], collisionBoundaries[2], collisionBoundaries[3]);
         if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) || !isInsideGrid(collisionBoundaries) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes.back().box(), collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, projectedBoxes.back().box(), collisionGroupPredicate))) {
             return {false, false};
         }
 
@@ -202,7 +238,7 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
     const bool pitchWithMap,
     const bool collisionDebug,
     const std::optional<CollisionBoundaries>& avoidEdges,
-    const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
+    const std::optional<CollisionGroupPredicate>& collisionGroupPredicate,
     std::vector<ProjectedCollisionBox>& projectedBoxes) {
     assert(feature.alongLine);
     assert(projectedBoxes.empty());
@@ -252,6 +288,9 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
 
     bool previousCirclePlaced = false;
     projectedBoxes.resize(feature.boxes.size());
+    // Hit tested against the grid all together once they're all placed
+    std::vector<CollisionGrid::BCircle> placedCircles;
+    placedCircles.reserve(feature.boxes.size());
     for (size_t i = 0; i < feature.boxes.size(); i++) {
         const CollisionBox& circle = feature.boxes[i];
         const float boxSignedDistanceFromAnchor = circle.signedDistanceFromAnchor;
@@ -309,12 +348,13 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
                                                  projectedPoint.y + radius}};
 
         projectedBoxes[i] = ProjectedCollisionBox{projectedPoint.x, projectedPoint.y, radius};
+        placedCircles.push_back(projectedBoxes[i].circle());
+        extendTestedBounds(collisionBoundaries);
 
         entirelyOffscreen &= isOffscreen(collisionBoundaries);
         inGrid |= isInsideGrid(collisionBoundaries);
 
-        if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes[i].circle(), collisionGroupPredicate))) {
+        if (avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -325,6 +365,13 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
         }
     }
 
+    if (!allowOverlap && !collisionDetected && hitTestAny(collisionGrid, placedCircles, collisionGroupPredicate)) {
+        if (!collisionDebug) {
+            return {false, false};
+        }
+        collisionDetected = true;
+    }
+
     return {!collisionDetected && firstAndLastGlyph && inGrid, entirelyOffscreen};
 }
 
@@ -361,6 +408,55 @@ void CollisionIndex::insertFeature(const CollisionFeature& feature,
     }
 }
 
+CollisionIndex::Checkpoint CollisionIndex::checkpoint() const {
+    return {.collisionBoxes = collisionGrid.getBoxElements().size(),
+            .collisionCircles = collisionGrid.getCircleElements().size(),
+            .ignoredBoxes = ignoredGrid.getBoxElements().size(),
+            .ignoredCircles = ignoredGrid.getCircleElements().size()};
+}
+
+namespace {
+
+CollisionIndex::CollisionGrid::BBox moved(CollisionIndex::CollisionGrid::BBox box, Point<float> shift) {
+    box.min.x += shift.x;
+    box.min.y += shift.y;
+    box.max.x += shift.x;
+    box.max.y += shift.y;
+    return box;
+}
+
+CollisionIndex::CollisionGrid::BCircle moved(CollisionIndex::CollisionGrid::BCircle circle, Point<float> shift) {
+    circle.center.x += shift.x;
+    circle.center.y += shift.y;
+    return circle;
+}
+
+template <typename Elements>
+void insertRange(CollisionIndex::CollisionGrid& grid,
+                 const Elements& elements,
+                 std::size_t from,
+                 std::size_t to,
+                 Point<float> shift) {
+    assert(from <= to && to <= elements.size());
+    for (std::size_t i = from; i < to; ++i) {
+        grid.insert(IndexedSubfeature(elements[i].first), moved(elements[i].second, shift));
+    }
+}
+
+} // namespace
+
+void CollisionIndex::insertFrom(const CollisionIndex& other,
+                                const Checkpoint& from,
+                                const Checkpoint& to,
+                                Point<float> shift) {
+    const auto& grid = other.collisionGrid;
+    const auto& ignored = other.ignoredGrid;
+    insertRange(collisionGrid, grid.getBoxElements(), from.collisionBoxes, to.collisionBoxes, shift);
+    insertRange(collisionGrid, grid.getCircleElements(), from.collisionCircles, to.collisionCircles, shift);
+    insertRange(ignoredGrid, ignored.getBoxElements(), from.ignoredBoxes, to.ignoredBoxes, shift);
+    insertRange(ignoredGrid, ignored.getCircleElements(), from.ignoredCircles, to.ignoredCircles, shift);
+}
+
 bool polygonIntersectsBox(const LineString<float>& polygon, const GridIndex<IndexedSubfeature>::BBox& bbox) {
     // This is just a wrapper that allows us to use the integer-based
     // util::polygonIntersectsPolygon Conversion limits our query accuracy to
@@ -7,6 +7,7 @@
 #include <mbgl/map/transform_state.hpp>
 
 #include <array>
+#include <optional>
 
 namespace mbgl {
 
@@ -25,6 +26,16 @@ struct IntersectStatus {
     // Assuming tile border divides box in two sections
     int minSectionLength = 0;
 };
+
+/// Limits collision detection to the features of one collision group
+struct CollisionGroupPredicate {
+    uint16_t collisionGroupId;
+
+    bool operator()(const RefIndexedSubfeature& feature) const {
+        return feature.getCollisionGroupId() == collisionGroupId;
+    }
+};
+
 class CollisionIndex {
 public:
     using CollisionGrid = GridIndex<IndexedSubfeature>;
@@ -48,7 +59,7 @@ public:
         bool pitchWithMap,
         bool collisionDebug,
         const std::optional<CollisionBoundaries>& avoidEdges,
-        const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
+        const std::optional<CollisionGroupPredicate>& collisionGroupPredicate,
         std::vector<ProjectedCollisionBox>& /*out*/
     );
 
@@ -58,6 +69,26 @@ public:
                        uint32_t bucketInstanceId,
                        uint16_t collisionGroupId);
 
+    /// The number of elements inserted into each grid so far
+    struct Checkpoint {
+        std::size_t collisionBoxes = 0;
+        std::size_t collisionCircles = 0;
+        std::size_t ignoredBoxes = 0;
+        std::size_t ignoredCircles = 0;
+    };
+    Checkpoint checkpoint() const;
+
+    /// Inserts the features another index got between two of its checkpoints, in the same order,
+    /// moved on screen by `shift`.
+    void insertFrom(const CollisionIndex& other,
+                    const Checkpoint& from,
+                    const Checkpoint& to,
+                    Point<float> shift = {0.0f, 0.0f});
+
+    /// The screen area covered by every box and circle placeFeature() tested since the last call.
+    /// Empty, with x1 > x2, if it tested none.
+    CollisionBoundaries takeTestedBounds();
+
     std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> queryRenderedSymbols(const ScreenLineString&) const;
 
     CollisionBoundaries projectTileBoundaries(const mat4& posMatrix) const;
@@ -67,6 +98,7 @@ public:
     float getViewportPadding() const { return viewportPadding; }
 
 private:
+    void extendTestedBounds(const CollisionBoundaries&);
     bool isOffscreen(const CollisionBoundaries&) const;
     bool isInsideGrid(const CollisionBoundaries&) const;
     bool isInsideTile(const CollisionBoundaries& boundaries, const CollisionBoundaries& tileBoundaries) const;
@@ -84,7 +116,7 @@ private:
         bool pitchWithMap,
         bool collisionDebug,
         const std::optional<CollisionBoundaries>& avoidEdges,
-        const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
+        const std::optional<CollisionGroupPredicate>& collisionGroupPredicate,
         std::vector<ProjectedCollisionBox>& /*out*/
     );
 
@@ -115,6 +147,8 @@ private:
     const float gridBottomBoundary;
 
     const float pitchFactor;
+
+    CollisionBoundaries testedBounds;
 };
 
 } // namespace mbgl
@@ -6,6 +6,9 @@
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/instrumentation.hpp>
 
+#include <algorithm>
+#include <tuple>
+
 namespace mbgl {
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_,
@@ -15,13 +18,43 @@ TileLayerIndex::TileLayerIndex(OverscaledTileID coord_,
     : coord(coord_),
       bucketInstanceId(bucketInstanceId_),
       bucketLeaderId(std::move(bucketLeaderId_)) {
-    for (const SymbolInstance& symbolInstance : symbolInstances) {
+    std::vector<std::pair<uint64_t, IndexedSymbolInstance>> keyed;
+    keyed.reserve(symbolInstances.size());
+    for (std::size_t i = 0; i < symbolInstances.size(); ++i) {
+        const SymbolInstance& symbolInstance = symbolInstances[i];
         if (!symbolInstance.check(SYM_GUARD_LOC) ||
             symbolInstance.getCrossTileID() == SymbolInstance::invalidCrossTileID) {
             continue;
         }
-        indexedSymbolInstances[symbolInstance.getKey()].emplace_back(symbolInstance.getCrossTileID(),
-                                                                     getScaledCoordinates(symbolInstance, coord));
+        keyed.emplace_back(symbolInstance.getKeyHash(),
+                           IndexedSymbolInstance(symbolInstance.getCrossTileID(),
+                                                 static_cast<uint32_t>(i),
+                                                 getScaledCoordinates(symbolInstance, coord)));
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first, a.second.coord.x, a.second.order) <
+               std::tie(b.first, b.second.coord.x, b.second.order);
+    });
+
+    indexedSymbolInstances.reserve(keyed.size());
+    keyRanges.reserve(keyed.size());
+    for (auto& [keyHash, indexed] : keyed) {
+        const auto index = static_cast<uint32_t>(indexedSymbolInstances.size());
+        auto& range =
+            keyRanges.try_emplace(keyHash, Range{index, index, static_cast<uint32_t>(keys.size())}).first->second;
+        range.end = index + 1;
+
+        // Keys sharing a hash are interned next to each other, almost always as a single key
+        const std::u16string& key = symbolInstances[indexed.order].getKey();
+        auto keyIndex = range.firstKey;
+        while (keyIndex < keys.size() && keys[keyIndex] != key) {
+            ++keyIndex;
+        }
+        if (keyIndex == keys.size()) {
+            keys.push_back(key);
+        }
+        indexed.keyIndex = keyIndex;
+        indexedSymbolInstances.push_back(indexed);
     }
 }
 
@@ -38,7 +71,7 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(const SymbolInstance& symbol
 
 void TileLayerIndex::findMatches(SymbolBucket& bucket,
                                  const OverscaledTileID& newCoord,
-                                 std::set<uint32_t>& zoomCrossTileIDs) const {
+                                 mbgl::unordered_set<uint32_t>& zoomCrossTileIDs) const {
     auto& symbolInstances = bucket.symbolInstances;
     float tolerance = coord.canonical.z < newCoord.canonical.z
                           ? 1.0f
@@ -52,28 +85,40 @@ void TileLayerIndex::findMatches(SymbolBucket& bucket,
             continue;
         }
 
-        auto it = indexedSymbolInstances.find(symbolInstance.getKey());
-        if (it == indexedSymbolInstances.end()) {
+        auto it = keyRanges.find(symbolInstance.getKeyHash());
+        if (it == keyRanges.end()) {
             // No symbol with this key in this bucket
             continue;
         }
 
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (const IndexedSymbolInstance& thisTileSymbol : it->second) {
-            // Return any symbol with the same keys whose coordinates are within
-            // 1 grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
-                std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
-                zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent
-                // symbol, don't let any other symbols at the same zoom level
-                // duplicate against the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.setCrossTileID(thisTileSymbol.crossTileID);
-                break;
+        // Return the first symbol with the same key whose coordinates are within
+        // 1 grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        const auto window = static_cast<int64_t>(std::ceil(tolerance));
+        const auto end = indexedSymbolInstances.begin() + it->second.end;
+        auto candidate = std::lower_bound(indexedSymbolInstances.begin() + it->second.begin,
+                                          end,
+                                          scaledSymbolCoord.x - window,
+                                          [](const IndexedSymbolInstance& indexed, int64_t x) {
+                                              return indexed.coord.x < x;
+                                          });
+        const IndexedSymbolInstance* match = nullptr;
+        for (; candidate != end && candidate->coord.x <= scaledSymbolCoord.x + window; ++candidate) {
+            if (std::abs(candidate->coord.x - scaledSymbolCoord.x) <= tolerance &&
+                std::abs(candidate->coord.y - scaledSymbolCoord.y) <= tolerance &&
+                !zoomCrossTileIDs.contains(candidate->crossTileID) && (!match || candidate->order < match->order) &&
+                keys[candidate->keyIndex] == symbolInstance.getKey()) {
+                match = &*candidate;
             }
         }
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent
+            // symbol, don't let any other symbols at the same zoom level
+            // duplicate against the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.setCrossTileID(match->crossTileID);
+        }
     }
 }
 
@@ -195,10 +240,9 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID,
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (const auto& key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
-            usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
-        }
+    auto& zoomCrossTileIDs = usedCrossTileIDs[zoom];
+    for (const IndexedSymbolInstance& indexedSymbolInstance : removedBucket.indexedSymbolInstances) {
+        zoomCrossTileIDs.erase(indexedSymbolInstance.crossTileID);
     }
 }
 
@@ -3,6 +3,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/bitmask_operations.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/containers.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/util/mat4.hpp>
 
@@ -13,6 +14,7 @@
 #include <memory>
 #include <thread>
 #include <unordered_set>
+#include <utility>
 
 namespace mbgl {
 
@@ -22,11 +24,17 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, uint32_t order_, Point<int64_t> coord_)
         : crossTileID(crossTileID_),
+          order(order_),
           coord(coord_) {}
 
+    // Symbols are grouped by the hash of their key, which different keys may share, so the
+    // key itself is kept once per tile in `TileLayerIndex::keys`
+    uint32_t keyIndex = 0;
     uint32_t crossTileID;
+    // The position of the symbol in its bucket, which decides between several matches
+    uint32_t order;
     Point<int64_t> coord;
 };
 
@@ -38,12 +46,25 @@ public:
                    std::string bucketLeaderId);
 
     Point<int64_t> getScaledCoordinates(const SymbolInstance&, const OverscaledTileID&) const;
-    void findMatches(SymbolBucket&, const OverscaledTileID&, std::set<uint32_t>&) const;
+    void findMatches(SymbolBucket&, const OverscaledTileID&, mbgl::unordered_set<uint32_t>&) const;
 
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
     std::string bucketLeaderId;
-    std::map<std::u16string, std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+    // Grouped by key, and sorted by x within each group
+    std::vector<IndexedSymbolInstance> indexedSymbolInstances;
+    // The distinct keys of the symbols
+    std::vector<std::u16string> keys;
+
+private:
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+        // The first of the keys with this hash in `keys`
+        uint32_t firstKey;
+    };
+    // The group of each key hash in `indexedSymbolInstances`
+    mbgl::unordered_map<uint64_t, Range> keyRanges;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -57,7 +78,7 @@ private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
     std::map<uint8_t, std::map<OverscaledTileID, TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    std::map<uint8_t, mbgl::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
     uint32_t& maxCrossTileID;
 };
@@ -1,3 +1,5 @@
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
@@ -5,28 +7,127 @@
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
 #include <mbgl/util/async_request.hpp>
+#include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/std.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/tiny_sdf.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/util/url.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace mbgl {
 
 namespace {
 GlyphManagerObserver nullObserver;
+
+constexpr double kSDFRadius = 8;
+constexpr double kSDFCutoff = 0.25;
+// Ranges getting new glyphs are written to the glyph cache at most this often
+constexpr Duration kCachedRangeWriteDelay = Seconds(1);
+
+bool glyphCacheEnabled() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_GLYPH_SDF_CACHE);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+void transformRastersToSDF(std::vector<Glyph>& glyphs, std::size_t begin, std::size_t end) {
+    std::vector<AlphaImage*> rasters;
+    rasters.reserve(end - begin);
+    for (std::size_t i = begin; i < end; ++i) {
+        rasters.push_back(&glyphs[i].bitmap);
+    }
+    util::transformRastersToSDF(rasters, kSDFRadius, kSDFCutoff);
+}
+
+// Turns rasterized glyphs into SDFs, spreading larger batches over the worker pool.
+void transformRastersToSDF(std::vector<Glyph>& glyphs) {
+    MLN_TRACE_FUNC();
+    constexpr std::size_t kChunkSize = 8;
+    const std::size_t chunks = (glyphs.size() + kChunkSize - 1) / kChunkSize;
+    if (chunks <= 1) {
+        transformRastersToSDF(glyphs, 0, glyphs.size());
+        return;
+    }
+
+    util::parallelFor(Scheduler::GetBackground(), chunks, [&](const std::size_t i) {
+        transformRastersToSDF(glyphs, i * kChunkSize, std::min(glyphs.size(), (i + 1) * kChunkSize));
+    });
 }
 
-GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
+// Glyphs in the glyph cache are stored one after the other, each as its ID, metrics and
+// bitmap size followed by the bitmap.
+constexpr std::size_t kCachedGlyphHeaderSize = 8 * sizeof(uint32_t);
+constexpr uint32_t kMaxCachedGlyphSize = 1024;
+
+std::string encodeCachedGlyphs(const std::vector<Immutable<Glyph>>& glyphs) {
+    std::string data;
+    for (const auto& glyph : glyphs) {
+        const uint32_t header[] = {static_cast<uint32_t>(glyph->id.hash),
+                                   glyph->metrics.width,
+                                   glyph->metrics.height,
+                                   static_cast<uint32_t>(glyph->metrics.left),
+                                   static_cast<uint32_t>(glyph->metrics.top),
+                                   glyph->metrics.advance,
+                                   glyph->bitmap.size.width,
+                                   glyph->bitmap.size.height};
+        data.append(reinterpret_cast<const char*>(header), sizeof(header));
+        data.append(reinterpret_cast<const char*>(glyph->bitmap.data.get()), glyph->bitmap.bytes());
+    }
+    return data;
+}
+
+std::vector<Glyph> decodeCachedGlyphs(const std::string& data) {
+    std::vector<Glyph> glyphs;
+    std::size_t offset = 0;
+    while (data.size() - offset >= kCachedGlyphHeaderSize) {
+        uint32_t header[8];
+        std::memcpy(header, data.data() + offset, sizeof(header));
+        offset += sizeof(header);
+
+        Glyph glyph;
+        glyph.id.hash = header[0];
+        glyph.metrics = {header[1],
+                         header[2],
+                         static_cast<int32_t>(header[3]),
+                         static_cast<int32_t>(header[4]),
+                         header[5]};
+        const Size size{header[6], header[7]};
+        if (size.width > kMaxCachedGlyphSize || size.height > kMaxCachedGlyphSize ||
+            data.size() - offset < size.area()) {
+            // Bogus or truncated, whatever is left has to be generated again
+            break;
+        }
+        if (!size.isEmpty()) {
+            glyph.bitmap = AlphaImage(size, reinterpret_cast<const uint8_t*>(data.data() + offset), size.area());
+        }
+        offset += size.area();
+        glyphs.push_back(std::move(glyph));
+    }
+    return glyphs;
+}
+
+} // namespace
+
+GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_, std::string localFontFamily_)
     : observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {}
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      localFontFamily(std::move(localFontFamily_)) {}
 
 GlyphManager::~GlyphManager() {
+    storeDirtyRanges();
     hbShapers.clear(); // clear harfbuzz + freetype face before library;
 }
 
-void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphDependencies, FileSource& fileSource) {
+void GlyphManager::getGlyphs(GlyphRequestor& requestor,
+                             GlyphDependencies glyphDependencies,
+                             const std::shared_ptr<FileSource>& fileSource) {
     auto dependencies = std::make_shared<GlyphDependencies>(std::move(glyphDependencies));
     {
         std::scoped_lock readWriteLock(rwLock);
@@ -35,28 +136,53 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
         // shared pointer containing the dependencies. When the shared pointer
         // becomes unique, we know that all the dependencies for that requestor have
         // been fetched, and can notify it of completion.
+        const bool useCache = glyphCacheEnabled() && fileSource->supportsCacheOnlyRequests();
         for (const auto& dependency : dependencies->glyphs) {
             const FontStack& fontStack = dependency.first;
             Entry& entry = entries[fontStack];
 
             const GlyphIDs& glyphIDs = dependency.second;
             std::unordered_set<GlyphRange> ranges;
+            std::map<GlyphRange, GlyphIDs> localRanges;
             for (const auto& glyphID : glyphIDs) {
                 if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
                     if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
-                        entry.glyphs.emplace(glyphID, makeMutable<Glyph>(generateLocalSDF(fontStack, glyphID)));
+                        localRanges[getGlyphRange(glyphID)].insert(glyphID);
                     }
                 } else {
                     ranges.insert(getGlyphRange(glyphID));
                 }
             }
 
+            // Local glyphs are looked up in the glyph cache first, if there is one, and generated
+            // all at once otherwise.
+            GlyphIDs localGlyphIDs;
+            for (auto& [range, rangeGlyphIDs] : localRanges) {
+                if (!useCache) {
+                    localGlyphIDs.merge(rangeGlyphIDs);
+                    continue;
+                }
+                LocalGlyphRequest& request = entry.localRanges[range];
+                if (request.loaded) {
+                    generateLocalGlyphs(fontStack, rangeGlyphIDs, entry);
+                    request.glyphIDs.insert(rangeGlyphIDs.begin(), rangeGlyphIDs.end());
+                    markRangeDirty(fontStack, range, fileSource);
+                } else {
+                    request.pending.merge(rangeGlyphIDs);
+                    request.requestors[&requestor] = dependencies;
+                    requestCachedRange(request, fontStack, range, fileSource);
+                }
+            }
+            if (!localGlyphIDs.empty()) {
+                generateLocalGlyphs(fontStack, localGlyphIDs, entry);
+            }
+
             for (const auto& range : ranges) {
                 auto it = entry.ranges.find(range);
                 if (it == entry.ranges.end() || !it->second.parsed) {
                     GlyphRequest& request = entry.ranges[range];
                     request.requestors[&requestor] = dependencies;
-                    requestRange(request, fontStack, range, fileSource);
+                    requestRange(request, fontStack, range, *fileSource);
                 }
             }
         }
@@ -69,10 +195,154 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
     }
 }
 
-Glyph GlyphManager::generateLocalSDF(const FontStack& fontStack, GlyphID glyphID) {
-    Glyph local = localGlyphRasterizer->rasterizeGlyph(fontStack, glyphID);
-    local.bitmap = util::transformRasterToSDF(local.bitmap, 8, .25);
-    return local;
+void GlyphManager::generateLocalGlyphs(const FontStack& fontStack, const GlyphIDs& glyphIDs, Entry& entry) {
+    MLN_TRACE_FUNC();
+    // Platform rasterizers aren't necessarily thread safe, only the SDF transform moves to the worker pool.
+    std::vector<Glyph> glyphs;
+    glyphs.reserve(glyphIDs.size());
+    for (const auto& glyphID : glyphIDs) {
+        glyphs.push_back(localGlyphRasterizer->rasterizeGlyph(fontStack, glyphID));
+    }
+    transformRastersToSDF(glyphs);
+
+    auto glyph = glyphs.begin();
+    for (const auto& glyphID : glyphIDs) {
+        entry.glyphs.emplace(glyphID, makeMutable<Glyph>(std::move(*glyph++)));
+    }
+}
+
+Resource GlyphManager::cachedRangeResource(const FontStack& fontStack, const GlyphRange& range) const {
+    // Keyed by everything that goes into the SDFs, so that changing any of it doesn't show stale glyphs
+    Resource resource(Resource::Kind::Glyphs,
+                      "local-glyphs://" + util::percentEncode(localFontFamily) + "/" +
+                          util::percentEncode(fontStackToString(fontStack)) + "/" + util::toString(range.first) + "-" +
+                          util::toString(range.second) + ".sdf?radius=" + util::toString(kSDFRadius) +
+                          "&cutoff=" + util::toString(kSDFCutoff),
+                      std::nullopt,
+                      Resource::LoadingMethod::CacheOnly);
+    return resource;
+}
+
+void GlyphManager::requestCachedRange(LocalGlyphRequest& request,
+                                      const FontStack& fontStack,
+                                      const GlyphRange& range,
+                                      const std::shared_ptr<FileSource>& fileSource) {
+    if (request.req) {
+        return;
+    }
+    request.req = fileSource->request(
+        cachedRangeResource(fontStack, range),
+        [this, fontStack, range, weakFileSource = std::weak_ptr<FileSource>(fileSource)](const Response& response) {
+            processCachedRange(response, fontStack, range, weakFileSource);
+        });
+}
+
+void GlyphManager::processCachedRange(const Response& res,
+                                      const FontStack& fontStack,
+                                      const GlyphRange& range,
+                                      const std::weak_ptr<FileSource>& fileSource) {
+    std::scoped_lock readWriteLock(rwLock);
+
+    Entry& entry = entries[fontStack];
+    LocalGlyphRequest& request = entry.localRanges[range];
+    request.loaded = true;
+
+    // A cache miss is no error, the glyphs are generated either way
+    if (!res.error && !res.noContent && res.data) {
+        for (auto& glyph : decodeCachedGlyphs(*res.data)) {
+            const GlyphID glyphID = glyph.id;
+            if (getGlyphRange(glyphID) == range && localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
+                request.glyphIDs.insert(glyphID);
+                entry.glyphs.emplace(glyphID, makeMutable<Glyph>(std::move(glyph)));
+            }
+        }
+    }
+
+    GlyphIDs missing;
+    for (const auto& glyphID : request.pending) {
+        if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
+            missing.insert(glyphID);
+        }
+    }
+    request.pending.clear();
+    if (!missing.empty()) {
+        generateLocalGlyphs(fontStack, missing, entry);
+        request.glyphIDs.insert(missing.begin(), missing.end());
+        markRangeDirty(fontStack, range, fileSource);
+    }
+
+    for (auto& pair : request.requestors) {
+        GlyphRequestor& requestor = *pair.first;
+        const std::shared_ptr<GlyphDependencies>& dependencies = pair.second;
+        if (dependencies.use_count() == 1) {
+            notify(requestor, *dependencies);
+        }
+    }
+
+    request.requestors.clear();
+}
+
+void GlyphManager::storeCachedRange(const LocalGlyphRequest& request,
+                                    const Entry& entry,
+                                    const FontStack& fontStack,
+                                    const GlyphRange& range,
+                                    FileSource& fileSource) {
+    std::vector<Immutable<Glyph>> glyphs;
+    glyphs.reserve(request.glyphIDs.size());
+    for (const auto& glyphID : request.glyphIDs) {
+        if (auto it = entry.glyphs.find(glyphID); it != entry.glyphs.end()) {
+            glyphs.push_back(it->second);
+        }
+    }
+
+    Response response;
+    response.data = std::make_shared<const std::string>(encodeCachedGlyphs(glyphs));
+    fileSource.forward(cachedRangeResource(fontStack, range), response, nullptr);
+}
+
+void GlyphManager::markRangeDirty(const FontStack& fontStack,
+                                  const GlyphRange& range,
+                                  std::weak_ptr<FileSource> fileSource) {
+    const bool scheduled = !dirtyRanges.empty();
+    dirtyRanges[fontStack].insert(range);
+    dirtyRangesFileSource = std::move(fileSource);
+    if (scheduled) {
+        return;
+    }
+
+    // Glyphs seen over the next moment, by this tile or others, go in the same write
+    if (!dirtyRangesTimer) {
+        dirtyRangesTimer = std::make_unique<util::Timer>();
+    }
+    dirtyRangesTimer->start(kCachedRangeWriteDelay, Duration::zero(), [this] {
+        std::scoped_lock readWriteLock(rwLock);
+        storeDirtyRanges();
+    });
+}
+
+void GlyphManager::storeDirtyRanges() {
+    if (dirtyRanges.empty()) {
+        return;
+    }
+    // The file source belongs to the map and its tiles, once they are gone there's nothing to store to
+    if (const auto fileSource = dirtyRangesFileSource.lock()) {
+        for (const auto& [fontStack, ranges] : dirtyRanges) {
+            const auto entry = entries.find(fontStack);
+            if (entry == entries.end()) {
+                continue;
+            }
+            for (const auto& range : ranges) {
+                if (auto request = entry->second.localRanges.find(range);
+                    request != entry->second.localRanges.end()) {
+                    storeCachedRange(request->second, entry->second, fontStack, range, *fileSource);
+                }
+            }
+        }
+    }
+    dirtyRanges.clear();
+    if (dirtyRangesTimer) {
+        dirtyRangesTimer->stop();
+    }
 }
 
 void GlyphManager::requestRange(GlyphRequest& request,
@@ -196,11 +466,16 @@ void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
         for (auto& range : entry.second.ranges) {
             range.second.requestors.erase(&requestor);
         }
+        for (auto& range : entry.second.localRanges) {
+            range.second.requestors.erase(&requestor);
+        }
     }
 }
 
 void GlyphManager::evict(const std::set<FontStack>& keep) {
     std::scoped_lock readWriteLock(rwLock);
+    // Evicted glyphs still go in the glyph cache
+    storeDirtyRanges();
     util::erase_if(entries, [&](const auto& entry) { return keep.count(entry.first) == 0; });
 }
 
@@ -224,17 +499,11 @@ bool GlyphManager::loadHBShaper(const FontStack& fontStack, GlyphIDType type, co
 
 Immutable<Glyph> GlyphManager::getGlyph(const FontStack& fontStack, GlyphID glyphID) {
     auto& entry = entries[fontStack];
-    if (entry.glyphs.find(glyphID) != entry.glyphs.end()) return entry.glyphs.at(glyphID);
-
-    if (glyphID.complex.type != FontPBF) {
-        auto shaper = getHBShaper(fontStack, glyphID.complex.type);
-        if (shaper) {
-            auto glyph = shaper->rasterizeGlyph(glyphID);
-
-            glyph.bitmap = util::transformRasterToSDF(glyph.bitmap, 8, .25);
-            entry.glyphs.emplace(glyphID, makeMutable<Glyph>(std::move(glyph)));
-            return entry.glyphs.at(glyphID);
-        }
+    if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
+        loadGlyphs(fontStack, {glyphID});
+    }
+    if (auto it = entry.glyphs.find(glyphID); it != entry.glyphs.end()) {
+        return it->second;
     }
 
     Glyph empty;
@@ -242,6 +511,29 @@ Immutable<Glyph> GlyphManager::getGlyph(const FontStack& fontStack, GlyphID glyp
     return makeMutable<Glyph>(std::move(empty));
 }
 
+void GlyphManager::loadGlyphs(const FontStack& fontStack, const GlyphIDs& glyphIDs) {
+    MLN_TRACE_FUNC();
+    auto& entry = entries[fontStack];
+
+    // Font faces aren't thread safe, only the SDF transform moves to the worker pool.
+    std::vector<GlyphID> loadedIDs;
+    std::vector<Glyph> glyphs;
+    for (const auto& glyphID : glyphIDs) {
+        if (glyphID.complex.type == FontPBF || entry.glyphs.find(glyphID) != entry.glyphs.end()) {
+            continue;
+        }
+        if (auto shaper = getHBShaper(fontStack, glyphID.complex.type)) {
+            loadedIDs.push_back(glyphID);
+            glyphs.push_back(shaper->rasterizeGlyph(glyphID));
+        }
+    }
+    transformRastersToSDF(glyphs);
+
+    for (std::size_t i = 0; i < glyphs.size(); ++i) {
+        entry.glyphs.emplace(loadedIDs[i], makeMutable<Glyph>(std::move(glyphs[i])));
+    }
+}
+
 void GlyphManager::hbShaping(const std::u16string& text,
                              const FontStack& font,
                              GlyphIDType type,
@@ -7,7 +7,9 @@
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
+#include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -17,8 +19,13 @@ namespace mbgl {
 
 class FileSource;
 class AsyncRequest;
+class Resource;
 class Response;
 
+namespace util {
+class Timer;
+} // namespace util
+
 struct HBShapeResult {
     std::u16string str;
 
@@ -44,8 +51,10 @@ class GlyphManager {
 public:
     GlyphManager(const GlyphManager &) = delete;
     GlyphManager &operator=(const GlyphManager &) = delete;
+    // The local font family identifies locally rasterized glyphs in the glyph cache.
     explicit GlyphManager(
-        std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(std::optional<std::string>()));
+        std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(std::optional<std::string>()),
+        std::string localFontFamily = {});
     ~GlyphManager();
 
     // Workers send a `getGlyphs` message to the main thread once they have
@@ -53,7 +62,7 @@ public:
     // available, GlyphManager will provide them to the requestor immediately.
     // Otherwise, it makes a request on the FileSource is made for each range
     // needed, and notifies the observer when all are complete.
-    void getGlyphs(GlyphRequestor &, GlyphDependencies, FileSource &);
+    void getGlyphs(GlyphRequestor &, GlyphDependencies, const std::shared_ptr<FileSource> &);
     void removeRequestor(GlyphRequestor &);
 
     void setURL(const std::string &url) { glyphURL = url; }
@@ -64,6 +73,8 @@ public:
     void evict(const std::set<FontStack> &);
 
     Immutable<Glyph> getGlyph(const FontStack &, GlyphID);
+    // Rasterizes whichever of the glyphs of loaded font faces haven't been yet, all at once.
+    void loadGlyphs(const FontStack &, const GlyphIDs &);
 
     void setFontFaces(std::shared_ptr<FontFaces> faces) { fontFaces = faces; }
 
@@ -80,7 +91,6 @@ public:
     std::string getFontFaceURL(GlyphIDType type);
 
 private:
-    Glyph generateLocalSDF(const FontStack &fontStack, GlyphID glyphID);
     std::string glyphURL;
 
     struct GlyphRequest {
@@ -89,21 +99,55 @@ private:
         std::unordered_map<GlyphRequestor *, std::shared_ptr<GlyphDependencies>> requestors;
     };
 
+    // A range of locally rasterized glyphs in the glyph cache
+    struct LocalGlyphRequest {
+        bool loaded = false;
+        std::unique_ptr<AsyncRequest> req;
+        // Generated once the cache was read, if they aren't in there
+        GlyphIDs pending;
+        // Everything to store in the cache
+        GlyphIDs glyphIDs;
+        std::unordered_map<GlyphRequestor *, std::shared_ptr<GlyphDependencies>> requestors;
+    };
+
     struct Entry {
         std::map<GlyphRange, GlyphRequest> ranges;
+        std::map<GlyphRange, LocalGlyphRequest> localRanges;
         std::map<GlyphID, Immutable<Glyph>> glyphs;
     };
 
     std::unordered_map<FontStack, Entry, FontStackHasher> entries;
 
+    std::map<FontStack, std::set<GlyphRange>> dirtyRanges;
+    // Not kept alive by the glyph manager, which outlives the tiles owning it
+    std::weak_ptr<FileSource> dirtyRangesFileSource;
+    std::unique_ptr<util::Timer> dirtyRangesTimer;
+
     void requestRange(GlyphRequest &, const FontStack &, const GlyphRange &, FileSource &fileSource);
     void processResponse(const Response &, const FontStack &, const GlyphRange &);
+    void generateLocalGlyphs(const FontStack &, const GlyphIDs &, Entry &);
+    Resource cachedRangeResource(const FontStack &, const GlyphRange &) const;
+    void requestCachedRange(LocalGlyphRequest &,
+                            const FontStack &,
+                            const GlyphRange &,
+                            const std::shared_ptr<FileSource> &);
+    void processCachedRange(const Response &,
+                            const FontStack &,
+                            const GlyphRange &,
+                            const std::weak_ptr<FileSource> &);
+    void storeCachedRange(
+        const LocalGlyphRequest &, const Entry &, const FontStack &, const GlyphRange &, FileSource &);
+    // Ranges with new glyphs are written to the glyph cache together, a moment later, rather
+    // than once for every request adding some
+    void markRangeDirty(const FontStack &, const GlyphRange &, std::weak_ptr<FileSource>);
+    void storeDirtyRanges();
     void notify(GlyphRequestor &, const GlyphDependencies &);
 
     GlyphManagerObserver *observer = nullptr;
 
     // Shaping objects
     std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    const std::string localFontFamily;
     std::shared_ptr<FontFaces> fontFaces;
 
     FreeTypeLibrary ftLibrary;
@@ -1,6 +1,8 @@
 #include <mbgl/text/placement.hpp>
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/render_layer.hpp>
@@ -9,7 +11,9 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/parallel_for.hpp>
 
+#include <algorithm>
 #include <list>
 #include <utility>
 
@@ -49,12 +53,7 @@ const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& s
     if (!crossSourceCollisions) {
         if (!collisionGroups.contains(sourceID)) {
             uint16_t nextGroupID = ++maxGroupID;
-            collisionGroups.emplace(
-                sourceID,
-                CollisionGroup(nextGroupID,
-                               std::optional<Predicate>([nextGroupID](const RefIndexedSubfeature& feature) -> bool {
-                                   return feature.getCollisionGroupId() == nextGroupID;
-                               })));
+            collisionGroups.emplace(sourceID, CollisionGroup(nextGroupID, Predicate{nextGroupID}));
         }
         return collisionGroups[sourceID];
     } else {
@@ -175,6 +174,180 @@ bool PlacementController::hasTransitions(TimePoint now) const {
     return placement->hasTransitions(now);
 }
 
+// Incremental placement
+
+namespace {
+
+bool isEmpty(const CollisionBoundaries& bounds) {
+    return bounds[0] > bounds[2];
+}
+
+template <typename Map>
+std::optional<typename Map::mapped_type> findValue(const Map& map, uint32_t key) {
+    const auto it = map.find(key);
+    return it != map.end() ? std::optional(it->second) : std::nullopt;
+}
+
+} // namespace
+
+/// The records of the previous placement, and where on screen they can't be reused because the
+/// collision index may not look the same there as it did back then.
+class Placement::IncrementalPlacement {
+public:
+    /// Returns null if the view changed by more than a pan since the previous placement.
+    static std::unique_ptr<IncrementalPlacement> create(const Placement&, const RenderLayerReferences&);
+
+    IncrementalPlacement(const Placement& prev_, const CollisionIndex& collisionIndex, Point<float> shift_)
+        : prev(prev_),
+          shift(shift_),
+          viewport{{collisionIndex.getViewportPadding(),
+                    collisionIndex.getViewportPadding(),
+                    collisionIndex.getTransformState().getSize().width + collisionIndex.getViewportPadding(),
+                    collisionIndex.getTransformState().getSize().height + collisionIndex.getViewportPadding()}},
+          changed(collisionIndex.getTransformState().getSize().width + 2 * collisionIndex.getViewportPadding(),
+                  collisionIndex.getTransformState().getSize().height + 2 * collisionIndex.getViewportPadding(),
+                  25) {}
+
+    static BucketKey key(const BucketPlacementData& data) {
+        const auto& bucket = static_cast<const SymbolBucket&>(data.bucket.get());
+        return {bucket.bucketInstanceId,
+                data.tile.get().id.wrap,
+                data.sortKeyRange ? data.sortKeyRange->start : std::size_t{0}};
+    }
+
+    /// The previous record of a bucket, if its symbols can be reused
+    const BucketRecord* find(const BucketKey& key) const {
+        const auto it = buckets.find(key);
+        return it != buckets.end() ? it->second : nullptr;
+    }
+
+    /// Whether placing the symbol again would do what it did in the previous placement
+    bool canReuse(const SymbolRecord& symbol) const {
+        if (isEmpty(symbol.testedBounds)) {
+            return true;
+        }
+        const auto bounds = moved(symbol.testedBounds);
+        // Boxes leaving the viewport or the grid don't collide the same way
+        if ((shift.x != 0.0f || shift.y != 0.0f) && !(isInViewport(symbol.testedBounds) && isInViewport(bounds))) {
+            return false;
+        }
+        return !changed.hitTest({{bounds[0], bounds[1]}, {bounds[2], bounds[3]}});
+    }
+
+    /// Does what placing the symbol did in the previous placement, given the start of its features
+    void reuse(Placement& placement, const SymbolRecord& symbol, const CollisionIndex::Checkpoint& begin) const {
+        placement.collisionIndex.insertFrom(prev.collisionIndex, begin, symbol.end, shift);
+        // As when placed, the result supersedes any from a tile that's fading out
+        placement.placements.erase(symbol.crossTileID);
+        placement.placements.emplace(symbol.crossTileID, symbol.placement);
+        if (symbol.variableOffset) {
+            placement.variableOffsets[symbol.crossTileID] = *symbol.variableOffset;
+        }
+        if (symbol.orientation) {
+            placement.placedOrientations[symbol.crossTileID] = *symbol.orientation;
+        }
+    }
+
+    /// Symbols tested anywhere near an area that changed have to be placed again
+    void markChanged(const CollisionBoundaries& bounds) {
+        if (!isEmpty(bounds)) {
+            changed.insert(0u, {{bounds[0], bounds[1]}, {bounds[2], bounds[3]}});
+        }
+    }
+    void markChanged(const SymbolRecord& symbol) { markChanged(moved(symbol.testedBounds)); }
+
+    /// Previous screen coordinates in this placement
+    CollisionBoundaries moved(CollisionBoundaries bounds) const {
+        bounds[0] += shift.x;
+        bounds[1] += shift.y;
+        bounds[2] += shift.x;
+        bounds[3] += shift.y;
+        return bounds;
+    }
+
+private:
+    bool isInViewport(const CollisionBoundaries& bounds) const {
+        return bounds[0] >= viewport[0] && bounds[1] >= viewport[1] && bounds[2] < viewport[2] &&
+               bounds[3] < viewport[3];
+    }
+
+    const Placement& prev;
+    const Point<float> shift;
+    const CollisionBoundaries viewport;
+    std::map<BucketKey, const BucketRecord*> buckets;
+    GridIndex<uint32_t> changed;
+};
+
+std::optional<Point<float>> Placement::getPanOffset(const TransformState& prevState, const TransformState& state) {
+    // Tilted views sort symbols by how they were placed before, and they don't just move along in a pan.
+    if (state.getPitch() != 0.0 || prevState.getPitch() != 0.0 || state.getSize() != prevState.getSize()) {
+        return std::nullopt;
+    }
+    // Otherwise a pan only changes the translation of the projection, and the whole screen moves by
+    // the same amount.
+    const mat4& matrix = state.getProjectionMatrix();
+    const mat4& prevMatrix = prevState.getProjectionMatrix();
+    for (std::size_t i = 0; i < matrix.size(); ++i) {
+        if (i != 12 && i != 13 && matrix[i] != prevMatrix[i]) {
+            return std::nullopt;
+        }
+    }
+    if (matrix[3] != 0.0 || matrix[7] != 0.0 || matrix[15] == 0.0) {
+        return std::nullopt;
+    }
+    return Point<float>{static_cast<float>((matrix[12] - prevMatrix[12]) / matrix[15] * state.getSize().width / 2),
+                        static_cast<float>((prevMatrix[13] - matrix[13]) / matrix[15] * state.getSize().height / 2)};
+}
+
+std::unique_ptr<Placement::IncrementalPlacement> Placement::IncrementalPlacement::create(
+    const Placement& placement, const RenderLayerReferences& layers) {
+    const Placement* prev = placement.getPrevPlacement();
+    if (!prev || !prev->recordSymbols || placement.showCollisionBoxes || prev->showCollisionBoxes ||
+        placement.updateParameters->crossSourceCollisions != prev->updateParameters->crossSourceCollisions) {
+        return nullptr;
+    }
+
+    const auto shift = getPanOffset(prev->collisionIndex.getTransformState(),
+                                    placement.collisionIndex.getTransformState());
+    if (!shift) {
+        return nullptr;
+    }
+    auto result = std::make_unique<IncrementalPlacement>(*prev, placement.collisionIndex, *shift);
+
+    // Buckets are only reused in the order they were placed before, so that their symbols are
+    // placed after the same ones as then.
+    const auto& records = prev->bucketRecords;
+    std::map<BucketKey, std::size_t> recordIndices;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        recordIndices.emplace(records[i].key, i);
+    }
+    std::vector<bool> reused(records.size(), false);
+    std::optional<std::size_t> lastIndex;
+    for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
+        const RenderLayer& layer = *it;
+        for (const BucketPlacementData& data : layer.getPlacementData()) {
+            const auto found = recordIndices.find(key(data));
+            if (found == recordIndices.end() || (lastIndex && found->second <= *lastIndex) ||
+                !records[found->second].reusable) {
+                continue;
+            }
+            lastIndex = found->second;
+            reused[found->second] = true;
+            result->buckets.emplace(found->first, &records[found->second]);
+        }
+    }
+
+    // The features of everything else are missing from wherever they were before
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        if (!reused[i]) {
+            for (const SymbolRecord& symbol : records[i].symbols) {
+                result->markChanged(symbol);
+            }
+        }
+    }
+    return result;
+}
+
 // Placement implementation
 
 Placement::Placement(std::shared_ptr<const UpdateParameters> updateParameters_,
@@ -198,12 +371,142 @@ Placement::Placement()
 
 Placement::~Placement() = default;
 
+namespace {
+
+bool parallelPlacementEnabled() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PARALLEL_PLACEMENT);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+// Symbols that allow overlap and ignore placement are never hit tested, and only ever
+// inserted into the grid of ignored features, so they don't affect any other symbols.
+bool placesIndependently(const RenderLayer& layer) {
+    return std::ranges::all_of(layer.getPlacementData(), [](const BucketPlacementData& data) {
+        const auto& layout = *static_cast<const SymbolBucket&>(data.bucket.get()).layout;
+        return layout.get<style::TextAllowOverlap>() && layout.get<style::IconAllowOverlap>() &&
+               layout.get<style::TextIgnorePlacement>() && layout.get<style::IconIgnorePlacement>();
+    });
+}
+
+bool incrementalPlacementEnabled() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+} // namespace
+
 void Placement::placeLayers(const RenderLayerReferences& layers) {
+    if (getPrevPlacement() && incrementalPlacementEnabled()) {
+        placeLayersIncrementally(layers);
+    } else if (!parallelPlacementEnabled() || !placeLayersConcurrently(layers)) {
+        for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
+            std::set<uint32_t> seenCrossTileIDs;
+            placeLayer(*it, seenCrossTileIDs);
+        }
+    }
+    commit();
+}
+
+bool Placement::placeLayersConcurrently(const RenderLayerReferences& layers) {
+    MLN_TRACE_FUNC();
+
+    // Layers are split up into lanes of layers that are placed against the same collision
+    // index, one after the other. Symbols of different collision groups never collide, and
+    // layers placing independently get a lane of their own.
+    struct Lane {
+        std::vector<const RenderLayer*> layers;
+        std::unique_ptr<Placement> placement;
+        // Before the first layer, and after each one
+        std::vector<CollisionIndex::Checkpoint> checkpoints;
+    };
+    std::vector<Lane> lanes;
+    // The lane of each layer, in placement order
+    std::vector<std::size_t> layerLanes;
+    std::unordered_map<uint16_t, std::size_t> groupLanes;
+
+    for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
+        const RenderLayer& layer = *it;
+        const auto& placementData = layer.getPlacementData();
+        if (placementData.empty()) {
+            continue;
+        }
+
+        // Collision group IDs are handed out in the order sources are first placed
+        uint16_t groupID = 0;
+        for (const BucketPlacementData& data : placementData) {
+            groupID = collisionGroups.get(data.sourceId).first;
+        }
+
+        std::size_t lane = lanes.size();
+        if (!placesIndependently(layer)) {
+            lane = groupLanes.emplace(groupID, lanes.size()).first->second;
+        }
+        if (lane == lanes.size()) {
+            lanes.emplace_back();
+        }
+        lanes[lane].layers.push_back(&layer);
+        layerLanes.push_back(lane);
+    }
+
+    if (lanes.size() < 2) {
+        return false;
+    }
+
+    // Created up front, as creating a placement updates the previous one
+    for (auto& lane : lanes) {
+        lane.placement = std::make_unique<Placement>(updateParameters, prevPlacement);
+        lane.placement->collisionGroups = collisionGroups;
+    }
+
+    util::parallelFor(Scheduler::GetBackground(), lanes.size(), [&](const std::size_t i) {
+        MLN_TRACE_ZONE(place lane);
+        auto& lane = lanes[i];
+        auto& placement = *lane.placement;
+        lane.checkpoints.push_back(placement.collisionIndex.checkpoint());
+        for (const RenderLayer* layer : lane.layers) {
+            std::set<uint32_t> seenCrossTileIDs;
+            placement.placeLayer(*layer, seenCrossTileIDs);
+            lane.checkpoints.push_back(placement.collisionIndex.checkpoint());
+        }
+    });
+
+    MLN_TRACE_ZONE(merge);
+    // Features are inserted layer by layer in placement order, so that the collision index
+    // ends up exactly as if the layers had been placed one after the other. Everything else
+    // is keyed by cross tile or bucket instance IDs, which are unique across layers.
+    std::vector<std::size_t> placedLayers(lanes.size(), 0);
+    for (const auto index : layerLanes) {
+        const auto& lane = lanes[index];
+        const auto i = placedLayers[index]++;
+        collisionIndex.insertFrom(lane.placement->collisionIndex, lane.checkpoints[i], lane.checkpoints[i + 1]);
+    }
+    for (auto& lane : lanes) {
+        auto& placement = *lane.placement;
+        placements.merge(placement.placements);
+        variableOffsets.merge(placement.variableOffsets);
+        placedOrientations.merge(placement.placedOrientations);
+        retainedQueryData.merge(placement.retainedQueryData);
+        collisionCircles.merge(placement.collisionCircles);
+    }
+    return true;
+}
+
+void Placement::placeLayersIncrementally(const RenderLayerReferences& layers) {
+    MLN_TRACE_FUNC();
+    recordSymbols = true;
+    incremental = IncrementalPlacement::create(*this, layers);
+    if (incremental) {
+        // Reused features keep the collision group IDs they were inserted with
+        collisionGroups = getPrevPlacement()->collisionGroups;
+    }
+
     for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
         std::set<uint32_t> seenCrossTileIDs;
         placeLayer(*it, seenCrossTileIDs);
     }
-    commit();
+    incremental.reset();
 }
 
 void Placement::placeLayer(const RenderLayer& layer, std::set<uint32_t>& seenCrossTileIDs) {
@@ -243,16 +546,81 @@ void Placement::placeSymbolBucket(const BucketPlacementData& params, std::set<ui
                          placementZoom,
                          collisionGroups.get(params.sourceId),
                          getAvoidEdges(symbolBucket, renderTile.matrix)};
+
+    BucketRecord* record = nullptr;
+    const BucketRecord* prevRecord = nullptr;
+    std::size_t nextPrevSymbol = 0;
+    if (recordSymbols) {
+        const auto key = IncrementalPlacement::key(params);
+        record = &bucketRecords.emplace_back(
+            BucketRecord{.key = key, .reusable = !symbolBucket.justReloaded, .begin = collisionIndex.checkpoint()});
+        prevRecord = incremental ? incremental->find(key) : nullptr;
+        collisionIndex.takeTestedBounds();
+    }
+
     for (const SymbolInstance& symbol : getSortedSymbols(params, ctx.pixelRatio)) {
         if (!symbol.check(SYM_GUARD_LOC)) continue;
-        if (seenCrossTileIDs.contains(symbol.getCrossTileID())) continue;
-        placeSymbol(symbol, ctx);
+        const auto symbolIndex = static_cast<uint32_t>(&symbol - symbolBucket.symbolInstances.data());
+
+        // Symbols are recorded in the order they're placed, skipping the same ones as now unless
+        // something changed.
+        const SymbolRecord* prevSymbol = nullptr;
+        CollisionIndex::Checkpoint prevSymbolBegin;
+        if (prevRecord && nextPrevSymbol < prevRecord->symbols.size() &&
+            prevRecord->symbols[nextPrevSymbol].symbolIndex == symbolIndex) {
+            prevSymbolBegin = nextPrevSymbol > 0 ? prevRecord->symbols[nextPrevSymbol - 1].end : prevRecord->begin;
+            prevSymbol = &prevRecord->symbols[nextPrevSymbol++];
+        }
+
+        if (seenCrossTileIDs.contains(symbol.getCrossTileID())) {
+            if (prevSymbol) {
+                incremental->markChanged(*prevSymbol);
+            }
+            continue;
+        }
+
+        CollisionBoundaries testedBounds{};
+        if (prevSymbol && prevSymbol->crossTileID == symbol.getCrossTileID() && !renderTile.holdForFade() &&
+            incremental->canReuse(*prevSymbol)) {
+            incremental->reuse(*this, *prevSymbol, prevSymbolBegin);
+            testedBounds = incremental->moved(prevSymbol->testedBounds);
+        } else {
+            placeSymbol(symbol, ctx);
+            if (record) {
+                testedBounds = collisionIndex.takeTestedBounds();
+            }
+            if (incremental) {
+                if (prevSymbol) {
+                    incremental->markChanged(*prevSymbol);
+                }
+                incremental->markChanged(testedBounds);
+            }
+        }
+
+        // Symbols of tiles held for fading are never placed
+        if (record && !renderTile.holdForFade()) {
+            const uint32_t crossTileID = symbol.getCrossTileID();
+            if (const auto placed = placements.find(crossTileID); placed != placements.end()) {
+                record->symbols.push_back(SymbolRecord{.symbolIndex = symbolIndex,
+                                                       .crossTileID = crossTileID,
+                                                       .testedBounds = testedBounds,
+                                                       .end = collisionIndex.checkpoint(),
+                                                       .placement = placed->second,
+                                                       .variableOffset = findValue(variableOffsets, crossTileID),
+                                                       .orientation = findValue(placedOrientations, crossTileID)});
+            }
+        }
 
         // Prevent a flickering issue while zooming out.
         if (symbol.getCrossTileID() != SymbolInstance::invalidCrossTileID && !ctx.getRenderTile().holdForFade()) {
             seenCrossTileIDs.insert(symbol.getCrossTileID());
         }
     }
+    if (prevRecord) {
+        for (std::size_t i = nextPrevSymbol; i < prevRecord->symbols.size(); ++i) {
+            incremental->markChanged(prevRecord->symbols[i]);
+        }
+    }
 
     // Prevent a flickering issue when a symbol is moved.
     symbolBucket.justReloaded = false;
@@ -5,7 +5,9 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/collision_index.hpp>
 #include <mbgl/util/chrono.hpp>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -77,7 +79,7 @@ struct RetainedQueryData {
 
 class CollisionGroups {
 public:
-    using Predicate = std::function<bool(const RefIndexedSubfeature&)>;
+    using Predicate = CollisionGroupPredicate;
     using CollisionGroup = std::pair<uint16_t, std::optional<Predicate>>;
 
     CollisionGroups(const bool crossSourceCollisions_)
@@ -138,6 +140,10 @@ public:
 
     const RetainedQueryData& getQueryData(uint32_t bucketInstanceId) const;
 
+    /// The screen offset everything moved by from `prev` to `state` when the view was only panned,
+    /// without pitch. Null after any other change, the previous placement can't be reused then.
+    static std::optional<Point<float>> getPanOffset(const TransformState& prev, const TransformState& state);
+
     // Public constructors are required for makeMutable(), shall not be called directly.
     Placement();
     Placement(std::shared_ptr<const UpdateParameters>, std::optional<Immutable<Placement>> prevPlacement);
@@ -147,6 +153,10 @@ protected:
     virtual void placeSymbolBucket(const BucketPlacementData&, std::set<uint32_t>& seenCrossTileIDs);
     JointPlacement placeSymbol(const SymbolInstance& symbolInstance, const PlacementContext&);
     void placeLayer(const RenderLayer&, std::set<uint32_t>&);
+    // Returns `false` if the layers can't be split up, and have to be placed one after the other.
+    bool placeLayersConcurrently(const RenderLayerReferences&);
+    // Reuses the results of the previous placement where nothing changed around the symbols.
+    void placeLayersIncrementally(const RenderLayerReferences&);
     virtual void commit();
     virtual void newSymbolPlaced(const SymbolInstance&,
                                  const PlacementContext&,
@@ -206,6 +216,36 @@ protected:
     std::vector<ProjectedCollisionBox> iconBoxes;
     // Used for debug purposes.
     std::unordered_map<const CollisionFeature*, std::vector<ProjectedCollisionBox>> collisionCircles;
+
+    // What placing a symbol did, so that the next placement can do the same without placing it again.
+    struct SymbolRecord {
+        uint32_t symbolIndex;
+        uint32_t crossTileID;
+        // The screen area of every box the symbol was tested with
+        CollisionBoundaries testedBounds;
+        // The symbol's features end here in the collision index, and start where the previous
+        // symbol's end.
+        CollisionIndex::Checkpoint end;
+        JointPlacement placement;
+        std::optional<VariableOffset> variableOffset;
+        std::optional<style::TextWritingModeType> orientation;
+    };
+    // The bucket instance, the world copy its tile is in, and the start of its sort key range
+    using BucketKey = std::tuple<uint32_t, int16_t, std::size_t>;
+    struct BucketRecord {
+        BucketKey key;
+        // Symbols of a bucket placed right after being reloaded skip fading in, and can't be reused.
+        bool reusable;
+        CollisionIndex::Checkpoint begin;
+        std::vector<SymbolRecord> symbols;
+    };
+    class IncrementalPlacement;
+
+    // Kept in placement order when placing incrementally.
+    bool recordSymbols = false;
+    std::vector<BucketRecord> bucketRecords;
+    // The previous placement's records, while placing.
+    std::unique_ptr<IncrementalPlacement> incremental;
 };
 
 } // namespace mbgl
@@ -0,0 +1,227 @@
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+namespace {
+
+void hashMetrics(std::size_t& seed, const GlyphMetrics* metrics) {
+    util::hash_combine(seed, metrics != nullptr);
+    if (metrics) {
+        util::hash_combine(seed, metrics->width);
+        util::hash_combine(seed, metrics->height);
+        util::hash_combine(seed, metrics->left);
+        util::hash_combine(seed, metrics->top);
+        util::hash_combine(seed, metrics->advance);
+    }
+}
+
+// Hashes everything shaping reads from the glyphs and images of the string, other than where they
+// are in the atlas: glyph metrics from both the glyph map and the glyph positions, and image sizes.
+std::size_t hashResources(const TaggedString& string,
+                          const GlyphMap& glyphMap,
+                          const GlyphPositions& glyphPositions,
+                          const ImagePositions& imagePositions) {
+    std::size_t seed = 0;
+    for (std::size_t i = 0; i < string.length(); i++) {
+        const SectionOptions& section = string.getSection(i);
+        if (section.imageID) {
+            const auto image = imagePositions.find(*section.imageID);
+            util::hash_combine(seed, image != imagePositions.end());
+            if (image != imagePositions.end()) {
+                const auto size = image->second.displaySize();
+                util::hash_combine(seed, size[0]);
+                util::hash_combine(seed, size[1]);
+            }
+            continue;
+        }
+
+        const GlyphID glyphID(string.getCharCodeAt(i), section.type);
+        const GlyphMetrics* positionMetrics = nullptr;
+        if (const auto positions = glyphPositions.find(section.fontStackHash); positions != glyphPositions.end()) {
+            if (const auto position = positions->second.find(glyphID); position != positions->second.end()) {
+                positionMetrics = &position->second.metrics;
+            }
+        }
+        const GlyphMetrics* glyphMetrics = nullptr;
+        if (const auto glyphs = glyphMap.find(section.fontStackHash); glyphs != glyphMap.end()) {
+            if (const auto glyph = glyphs->second.find(glyphID); glyph != glyphs->second.end() && glyph->second) {
+                glyphMetrics = &(*glyph->second)->metrics;
+            }
+        }
+        hashMetrics(seed, positionMetrics);
+        hashMetrics(seed, glyphMetrics);
+    }
+    return seed;
+}
+
+// Points the glyphs and images of a stored shaping to where they are in the current atlases
+void updateRects(Shaping& shaping, const GlyphPositions& glyphPositions, const ImagePositions& imagePositions) {
+    for (auto& line : shaping.positionedLines) {
+        for (auto& glyph : line.positionedGlyphs) {
+            if (glyph.imageID) {
+                if (const auto image = imagePositions.find(*glyph.imageID); image != imagePositions.end()) {
+                    glyph.rect = image->second.paddedRect;
+                }
+                continue;
+            }
+
+            glyph.rect = {};
+            if (const auto positions = glyphPositions.find(glyph.font); positions != glyphPositions.end()) {
+                if (const auto position = positions->second.find(glyph.glyph); position != positions->second.end()) {
+                    glyph.rect = position->second.rect;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = util::hash(key.text.first,
+                                  key.sections.size(),
+                                  key.maxWidth,
+                                  static_cast<uint8_t>(key.textAnchor),
+                                  static_cast<uint8_t>(key.textJustify),
+                                  static_cast<uint8_t>(key.writingMode),
+                                  key.layoutTextSize,
+                                  key.resources);
+    for (const auto& section : key.sections) {
+        util::hash_combine(seed, section.fontStackHash);
+    }
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t maxEntries_)
+    : maxEntries(maxEntries_) {}
+
+ShapingCache::~ShapingCache() = default;
+
+ShapingCache* ShapingCache::forThisThread() {
+    static thread_local ShapingCache cache;
+
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_SHAPING_CACHE_SIZE);
+    if (const auto* uintValue = value.getUint()) {
+        cache.setMaxEntries(static_cast<std::size_t>(*uintValue));
+    } else if (const auto* intValue = value.getInt()) {
+        cache.setMaxEntries(static_cast<std::size_t>(std::max<int64_t>(*intValue, 0)));
+    } else {
+        cache.setMaxEntries(0);
+    }
+    return cache.getMaxEntries() ? &cache : nullptr;
+}
+
+Shaping ShapingCache::getShaping(const TaggedString& string,
+                                 const float maxWidth,
+                                 const float lineHeight,
+                                 const style::SymbolAnchorType textAnchor,
+                                 const style::TextJustifyType textJustify,
+                                 const float spacing,
+                                 const std::array<float, 2>& translate,
+                                 const WritingModeType writingMode,
+                                 BiDi& bidi,
+                                 const GlyphMap& glyphMap,
+                                 const GlyphPositions& glyphPositions,
+                                 const ImagePositions& imagePositions,
+                                 float layoutTextSize,
+                                 float layoutTextSizeAtBucketZoomLevel,
+                                 bool allowVerticalPlacement) {
+    auto shape = [&] {
+        return mbgl::getShaping(string,
+                                maxWidth,
+                                lineHeight,
+                                textAnchor,
+                                textJustify,
+                                spacing,
+                                translate,
+                                writingMode,
+                                bidi,
+                                glyphMap,
+                                glyphPositions,
+                                imagePositions,
+                                layoutTextSize,
+                                layoutTextSizeAtBucketZoomLevel,
+                                allowVerticalPlacement);
+    };
+    if (maxEntries == 0) {
+        return shape();
+    }
+
+    Key key{.text = string.getStyledText(),
+            .sections = {},
+            .maxWidth = maxWidth,
+            .lineHeight = lineHeight,
+            .textAnchor = textAnchor,
+            .textJustify = textJustify,
+            .spacing = spacing,
+            .translate = translate,
+            .writingMode = writingMode,
+            .layoutTextSize = layoutTextSize,
+            .layoutTextSizeAtBucketZoomLevel = layoutTextSizeAtBucketZoomLevel,
+            .allowVerticalPlacement = allowVerticalPlacement,
+            .resources = hashResources(string, glyphMap, glyphPositions, imagePositions)};
+    key.sections.reserve(string.sectionCount());
+    for (const auto& section : string.getSections()) {
+        std::vector<float> adjusts;
+        if (section.adjusts) {
+            adjusts.reserve(section.adjusts->size() * 3);
+            for (const auto& adjust : *section.adjusts) {
+                adjusts.insert(adjusts.end(), {adjust.x_offset, adjust.y_offset, adjust.advance});
+            }
+        }
+        key.sections.push_back({.scale = section.scale,
+                                .fontStackHash = section.fontStackHash,
+                                .type = section.type,
+                                .startIndex = section.startIndex,
+                                .imageID = section.imageID,
+                                .adjusts = std::move(adjusts)});
+    }
+
+    if (const auto it = index.find(key); it != index.end()) {
+        hits++;
+        items.splice(items.begin(), items, it->second);
+        Shaping shaping = it->second->shaping;
+        updateRects(shaping, glyphPositions, imagePositions);
+        return shaping;
+    }
+
+    misses++;
+    Shaping shaping = shape();
+    items.push_front({key, shaping});
+    index.emplace(std::move(key), items.begin());
+    evict();
+    return shaping;
+}
+
+void ShapingCache::setMaxEntries(std::size_t maxEntries_) {
+    maxEntries = maxEntries_;
+    evict();
+}
+
+std::size_t ShapingCache::getMaxEntries() const {
+    return maxEntries;
+}
+
+ShapingCache::Stats ShapingCache::getStats() const {
+    return {.hits = hits, .misses = misses, .evictions = evictions, .entries = items.size()};
+}
+
+void ShapingCache::clear() {
+    items.clear();
+    index.clear();
+}
+
+void ShapingCache::evict() {
+    while (items.size() > maxEntries) {
+        index.erase(items.back().key);
+        items.pop_back();
+        evictions++;
+    }
+}
+
+} // namespace mbgl
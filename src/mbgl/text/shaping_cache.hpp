@@ -0,0 +1,122 @@
+#pragma once
+
+#include <mbgl/text/shaping.hpp>
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/**
+ * @brief Shapings of recently laid out labels, reused for labels with the same text and layout.
+ *
+ * The same text is often shaped many times over with the same parameters: a street name split
+ * into many line segments, a category label repeated on every POI, or a label showing up again
+ * in the neighbouring tile. Entries are keyed by everything `getShaping` reads: the text and its
+ * sections, the layout parameters, and the metrics of every glyph and size of every image the
+ * text refers to. Only the positions of glyphs and images in the atlas differ from one tile to
+ * the next, and they are looked up again whenever an entry is reused.
+ *
+ * Bounded by `maxEntries`, least recently used entries are evicted first. Not thread safe: every
+ * worker thread keeps its own, see `forThisThread`.
+ */
+class ShapingCache {
+public:
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        /// Entries dropped to stay within `maxEntries`
+        std::size_t evictions = 0;
+        std::size_t entries = 0;
+    };
+
+    /// A cache of 0 entries stores nothing
+    explicit ShapingCache(std::size_t maxEntries = 0);
+    ~ShapingCache();
+
+    /// The cache of the calling thread, or null if it's disabled. Sized by
+    /// `platform::EXPERIMENTAL_SHAPING_CACHE_SIZE`, which is re-read on every call.
+    static ShapingCache* forThisThread();
+
+    /// Same as `mbgl::getShaping`, but returns a copy of the stored shaping if there is one
+    Shaping getShaping(const TaggedString& string,
+                       float maxWidth,
+                       float lineHeight,
+                       style::SymbolAnchorType textAnchor,
+                       style::TextJustifyType textJustify,
+                       float spacing,
+                       const std::array<float, 2>& translate,
+                       WritingModeType,
+                       BiDi& bidi,
+                       const GlyphMap& glyphMap,
+                       const GlyphPositions& glyphPositions,
+                       const ImagePositions& imagePositions,
+                       float layoutTextSize,
+                       float layoutTextSizeAtBucketZoomLevel,
+                       bool allowVerticalPlacement);
+
+    void setMaxEntries(std::size_t);
+    std::size_t getMaxEntries() const;
+
+    Stats getStats() const;
+    void clear();
+
+private:
+    struct Section {
+        double scale;
+        FontStackHash fontStackHash;
+        GlyphIDType type;
+        int32_t startIndex;
+        std::optional<std::string> imageID;
+        /// HarfBuzz adjustments, as x offset, y offset and advance of each glyph
+        std::vector<float> adjusts;
+
+        bool operator==(const Section&) const = default;
+    };
+
+    struct Key {
+        StyledText text;
+        std::vector<Section> sections;
+        float maxWidth;
+        float lineHeight;
+        style::SymbolAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        std::array<float, 2> translate;
+        WritingModeType writingMode;
+        float layoutTextSize;
+        float layoutTextSizeAtBucketZoomLevel;
+        bool allowVerticalPlacement;
+        /// Hash of the metrics of the glyphs and the sizes of the images in the text
+        std::size_t resources;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+    struct Item {
+        Key key;
+        Shaping shaping;
+    };
+    using Items = std::list<Item>;
+
+    void evict();
+
+    std::size_t maxEntries;
+    /// Most recently used first
+    Items items;
+    std::unordered_map<Key, Items::iterator, KeyHash> index;
+
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
+
+} // namespace mbgl
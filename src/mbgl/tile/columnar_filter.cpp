@@ -0,0 +1,286 @@
+#include <mbgl/tile/columnar_filter.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/instrumentation.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <type_traits>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+// Upper bound for the number of distinct property/type combinations whose results are kept.
+// Filters with more combinations than this, and filters reading the ID, are evaluated per feature.
+constexpr std::size_t maxCombinations = 1 << 16;
+
+constexpr std::size_t typeCount = 4;
+
+// Dictionary keys compare doubles bitwise so values which compare equal but may still evaluate
+// differently (0 and -0) keep separate codes.
+struct ValueHash {
+    std::size_t operator()(const Value& value) const {
+        return value.match(
+            [](const std::string& s) { return std::hash<std::string>()(s); },
+            [](double d) { return std::hash<uint64_t>()(std::bit_cast<uint64_t>(d)); },
+            [](const auto& v) -> std::size_t {
+                if constexpr (std::is_arithmetic_v<std::decay_t<decltype(v)>>) {
+                    return std::hash<std::decay_t<decltype(v)>>()(v);
+                } else {
+                    return 0;
+                }
+            });
+    }
+};
+
+struct ValueEqual {
+    bool operator()(const Value& lhs, const Value& rhs) const {
+        if (lhs.is<double>() && rhs.is<double>()) {
+            return std::bit_cast<uint64_t>(lhs.get<double>()) == std::bit_cast<uint64_t>(rhs.get<double>());
+        }
+        return lhs == rhs;
+    }
+};
+
+using Dictionary = std::unordered_map<Value, uint32_t, ValueHash, ValueEqual>;
+
+/// A feature reading its data from one row of the columns
+class ColumnFeature final : public GeometryTileFeature {
+public:
+    explicit ColumnFeature(const FeatureColumns::View& view_)
+        : view(view_) {}
+
+    FeatureType getType() const override { return view.types ? (*view.types)[row] : FeatureType::Unknown; }
+
+    std::optional<Value> getValue(const std::string& key) const override {
+        for (const auto& [name, column] : view.properties) {
+            if (name == key) {
+                const uint32_t code = column->codes[row];
+                return code ? std::optional<Value>(column->dictionary[code - 1]) : std::nullopt;
+            }
+        }
+        assert(false);
+        return std::nullopt;
+    }
+
+    FeatureIdentifier getID() const override { return view.ids ? (*view.ids)[row] : FeatureIdentifier(NullValue{}); }
+
+    std::size_t row = 0;
+
+private:
+    const FeatureColumns::View& view;
+};
+
+std::optional<std::string> literalKey(const expression::Expression& expression) {
+    if (expression.getKind() != expression::Kind::Literal) {
+        return std::nullopt;
+    }
+    const auto& value = static_cast<const expression::Literal&>(expression).getValue();
+    if (!value.is<std::string>()) {
+        return std::nullopt;
+    }
+    return value.get<std::string>();
+}
+
+// Collects the columns read by the expression, returns false if it reads anything else
+bool collectColumns(const expression::Expression& expression,
+                    std::vector<std::string>& keys,
+                    bool& type,
+                    bool& id) {
+    using expression::Kind;
+
+    switch (expression.getKind()) {
+        case Kind::Within:
+        case Kind::Distance:
+        case Kind::FormatSectionOverride:
+            return false;
+        case Kind::CompoundExpression: {
+            std::vector<const expression::Expression*> args;
+            expression.eachChild([&](const expression::Expression& child) { args.push_back(&child); });
+
+            const std::string op = expression.getOperator();
+            if (op == "properties" || op == "feature-state") {
+                return false;
+            } else if (op == "geometry-type" || op.starts_with("filter-type-")) {
+                type = true;
+            } else if (op == "id" || op.starts_with("filter-id-") || op == "filter-has-id") {
+                id = true;
+            } else if (((op == "get" || op == "has") && args.size() == 1) || op.starts_with("filter-")) {
+                // The context forms of "get" and "has", and the legacy filters, all read the
+                // property named by their first argument. The object forms only read their arguments.
+                auto key = args.empty() ? std::nullopt : literalKey(*args.front());
+                if (!key) {
+                    return false;
+                }
+                if (std::ranges::find(keys, *key) == keys.end()) {
+                    keys.push_back(std::move(*key));
+                }
+            }
+
+            return std::ranges::all_of(args, [&](const auto* arg) { return collectColumns(*arg, keys, type, id); });
+        }
+        default: {
+            bool supported = true;
+            expression.eachChild([&](const expression::Expression& child) {
+                supported = supported && collectColumns(child, keys, type, id);
+            });
+            return supported;
+        }
+    }
+}
+
+} // namespace
+
+FeatureColumns::FeatureColumns(const GeometryTileLayer& layer_)
+    : layer(layer_),
+      featureCount(layer.featureCount()) {}
+
+FeatureColumns::~FeatureColumns() = default;
+
+FeatureColumns::View FeatureColumns::get(const std::vector<std::string>& keys, bool withTypes, bool withIDs) {
+    std::scoped_lock lock(mutex);
+
+    std::vector<std::pair<const std::string*, std::unique_ptr<PropertyColumn>>> missing;
+    for (const auto& key : keys) {
+        if (!properties.contains(key)) {
+            missing.emplace_back(&key, std::make_unique<PropertyColumn>());
+        }
+    }
+    std::unique_ptr<std::vector<FeatureType>> newTypes;
+    if (withTypes && !types) {
+        newTypes = std::make_unique<std::vector<FeatureType>>();
+    }
+    std::unique_ptr<std::vector<FeatureIdentifier>> newIDs;
+    if (withIDs && !ids) {
+        newIDs = std::make_unique<std::vector<FeatureIdentifier>>();
+    }
+
+    if (!missing.empty() || newTypes || newIDs) {
+        MLN_TRACE_ZONE(decode columns);
+
+        std::vector<Dictionary> dictionaries(missing.size());
+        for (auto& pair : missing) {
+            pair.second->codes.reserve(featureCount);
+        }
+        if (newTypes) {
+            newTypes->reserve(featureCount);
+        }
+        if (newIDs) {
+            newIDs->reserve(featureCount);
+        }
+
+        for (std::size_t i = 0; i < featureCount; ++i) {
+            const auto feature = layer.getFeature(i);
+
+            for (std::size_t k = 0; k < missing.size(); ++k) {
+                auto& column = *missing[k].second;
+                auto value = feature->getValue(*missing[k].first);
+                if (!value) {
+                    column.codes.push_back(0);
+                    continue;
+                }
+                const auto code = static_cast<uint32_t>(column.dictionary.size() + 1);
+                const auto result = dictionaries[k].emplace(std::move(*value), code);
+                if (result.second) {
+                    column.dictionary.push_back(result.first->first);
+                }
+                column.codes.push_back(result.first->second);
+            }
+            if (newTypes) {
+                newTypes->push_back(feature->getType());
+            }
+            if (newIDs) {
+                newIDs->push_back(feature->getID());
+            }
+        }
+
+        // Columns are only published once complete, in case decoding throws
+        for (auto& pair : missing) {
+            properties.emplace(*pair.first, std::move(pair.second));
+        }
+        if (newTypes) {
+            types = std::move(newTypes);
+        }
+        if (newIDs) {
+            ids = std::move(newIDs);
+        }
+    }
+
+    View view;
+    view.properties.reserve(keys.size());
+    for (const auto& key : keys) {
+        view.properties.emplace_back(key, properties.at(key).get());
+    }
+    view.types = withTypes ? types.get() : nullptr;
+    view.ids = withIDs ? ids.get() : nullptr;
+    return view;
+}
+
+std::optional<ColumnarFilter> ColumnarFilter::compile(const Filter& filter) {
+    if (!filter.expression) {
+        return std::nullopt;
+    }
+
+    ColumnarFilter result(filter);
+    if (!collectColumns(**filter.expression, result.keys, result.type, result.id)) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::vector<bool> ColumnarFilter::select(FeatureColumns& columns, float zoom, const CanonicalTileID& canonical) const {
+    MLN_TRACE_FUNC();
+
+    const FeatureColumns::View view = columns.get(keys, type, id);
+    const std::size_t size = columns.size();
+    std::vector<bool> selection(size);
+
+    ColumnFeature feature(view);
+    expression::EvaluationContext context(zoom, &feature);
+    context.withCanonicalTileID(&canonical);
+
+    // Features are numbered by their combination of property codes and type. IDs are
+    // usually unique, so there's nothing to share between features once they're read.
+    std::size_t combinations = id ? 0 : 1;
+    for (const auto& pair : view.properties) {
+        const std::size_t radix = pair.second->dictionary.size() + 1;
+        combinations = combinations > maxCombinations / radix ? 0 : combinations * radix;
+    }
+    if (type) {
+        combinations = combinations > maxCombinations / typeCount ? 0 : combinations * typeCount;
+    }
+
+    if (combinations == 0) {
+        for (std::size_t i = 0; i < size; ++i) {
+            feature.row = i;
+            selection[i] = filter(context);
+        }
+        return selection;
+    }
+
+    std::vector<int8_t> results(combinations, -1);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::size_t index = 0;
+        for (const auto& pair : view.properties) {
+            index = index * (pair.second->dictionary.size() + 1) + pair.second->codes[i];
+        }
+        if (type) {
+            index = index * typeCount + static_cast<std::size_t>((*view.types)[i]);
+        }
+
+        auto& result = results[index];
+        if (result < 0) {
+            feature.row = i;
+            result = filter(context) ? 1 : 0;
+        }
+        selection[i] = result != 0;
+    }
+    return selection;
+}
+
+} // namespace mbgl
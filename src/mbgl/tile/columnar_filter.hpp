@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/**
+ * @brief Property, type and ID columns of one source layer, decoded on demand.
+ *
+ * Property values are dictionary encoded: every feature gets the code of its value, and each
+ * distinct value is stored once. Columns are decoded at most once no matter how many filters
+ * (or threads) ask for them, so layers reading the same source layer share the work.
+ *
+ * The layer must outlive the columns.
+ */
+class FeatureColumns {
+public:
+    struct PropertyColumn {
+        /// Per feature, 0 if the feature doesn't have the property, otherwise the dictionary index + 1
+        std::vector<uint32_t> codes;
+        std::vector<Value> dictionary;
+    };
+
+    /// Columns requested together, valid as long as the `FeatureColumns` they came from
+    struct View {
+        std::vector<std::pair<std::string, const PropertyColumn*>> properties;
+        const std::vector<FeatureType>* types = nullptr;
+        const std::vector<FeatureIdentifier>* ids = nullptr;
+    };
+
+    explicit FeatureColumns(const GeometryTileLayer&);
+    ~FeatureColumns();
+
+    std::size_t size() const { return featureCount; }
+
+    /// Returns the requested columns, decoding the missing ones in a single pass over the features
+    View get(const std::vector<std::string>& keys, bool types, bool ids);
+
+private:
+    const GeometryTileLayer& layer;
+    const std::size_t featureCount;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<PropertyColumn>> properties;
+    std::unique_ptr<std::vector<FeatureType>> types;
+    std::unique_ptr<std::vector<FeatureIdentifier>> ids;
+};
+
+/**
+ * @brief A filter evaluated over whole columns rather than one feature at a time.
+ *
+ * Only filters which read nothing but literal keyed properties, the geometry type and the
+ * feature ID can be compiled. Features sharing the same property values and type share the
+ * result, so the expression is evaluated once per distinct combination instead of once per
+ * feature. The results are identical to evaluating `filter` for each feature.
+ */
+class ColumnarFilter {
+public:
+    /// Returns nothing if the filter reads feature data that isn't available as a column
+    static std::optional<ColumnarFilter> compile(const style::Filter&);
+
+    /// Returns whether each feature of the layer passes the filter
+    std::vector<bool> select(FeatureColumns&, float zoom, const CanonicalTileID&) const;
+
+    const std::vector<std::string>& getKeys() const { return keys; }
+    bool readsType() const { return type; }
+    bool readsID() const { return id; }
+
+private:
+    explicit ColumnarFilter(style::Filter filter_)
+        : filter(std::move(filter_)) {}
+
+    style::Filter filter;
+    std::vector<std::string> keys;
+    bool type = false;
+    bool id = false;
+};
+
+} // namespace mbgl
@@ -0,0 +1,217 @@
+#include <mbgl/tile/feature_decode_cache.hpp>
+
+#include <mbgl/util/instrumentation.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace mbgl {
+
+namespace {
+
+std::size_t estimateBytes(const GeometryCollection& geometries) {
+    std::size_t bytes = sizeof(GeometryCollection) + geometries.capacity() * sizeof(GeometryCoordinates);
+    for (const auto& ring : geometries) {
+        bytes += ring.capacity() * sizeof(GeometryCoordinate);
+    }
+    return bytes;
+}
+
+std::size_t estimateBytes(const PropertyMap& properties) {
+    // Rough per-node cost, string payloads are not walked
+    constexpr std::size_t nodeOverhead = sizeof(void*) * 4;
+    return sizeof(PropertyMap) + properties.size() * (sizeof(PropertyMap::value_type) + nodeOverhead);
+}
+
+} // namespace
+
+class FeatureDecodeCache::Shared {
+public:
+    explicit Shared(std::size_t maxBytes_)
+        : maxBytes(maxBytes_) {}
+
+    bool full() const { return bytes >= maxBytes; }
+
+    void add([[maybe_unused]] const void* id, std::size_t size) {
+        bytes += size;
+        MLN_TRACE_ALLOC_FEATURE_CACHE(id, size);
+    }
+
+    void remove([[maybe_unused]] const void* id, std::size_t size) {
+        bytes -= size;
+        MLN_TRACE_FREE_FEATURE_CACHE(id);
+    }
+
+    const std::size_t maxBytes;
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::size_t> features{0};
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+};
+
+namespace {
+
+struct Entry {
+    explicit Entry(std::unique_ptr<GeometryTileFeature> feature_)
+        : feature(std::move(feature_)) {}
+
+    std::unique_ptr<GeometryTileFeature> feature;
+
+    // Features decode lazily into mutable members, which must only happen once when shared
+    std::once_flag geometriesOnce;
+    std::once_flag propertiesOnce;
+    std::atomic<bool> hasProperties{false};
+    std::size_t geometryBytes = 0;
+    std::size_t propertyBytes = 0;
+};
+
+} // namespace
+
+class FeatureDecodeCache::LayerTable {
+public:
+    LayerTable(std::shared_ptr<Shared> shared_, std::unique_ptr<GeometryTileLayer> layer_)
+        : shared(std::move(shared_)),
+          layer(std::move(layer_)),
+          count(layer->featureCount()),
+          slots(std::make_unique<std::atomic<Entry*>[]>(count)) {}
+
+    ~LayerTable() {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (auto* entry = slots[i].load(std::memory_order_relaxed)) {
+                if (entry->geometryBytes) {
+                    shared->remove(&entry->geometriesOnce, entry->geometryBytes);
+                }
+                if (entry->propertyBytes) {
+                    shared->remove(&entry->propertiesOnce, entry->propertyBytes);
+                }
+                shared->features--;
+                delete entry;
+            }
+        }
+    }
+
+    /// Returns the shared entry for feature `i`, or null if the budget doesn't allow creating it
+    Entry* get(std::size_t i) {
+        auto* entry = slots[i].load(std::memory_order_acquire);
+        if (entry) {
+            shared->hits++;
+            return entry;
+        }
+        if (shared->full()) {
+            shared->misses++;
+            return nullptr;
+        }
+
+        auto* created = new Entry(layer->getFeature(i));
+        if (slots[i].compare_exchange_strong(entry, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            shared->features++;
+            return created;
+        }
+
+        // Another thread created it first
+        delete created;
+        shared->hits++;
+        return entry;
+    }
+
+    const GeometryCollection& getGeometries(Entry& entry) {
+        std::call_once(entry.geometriesOnce, [&] {
+            entry.geometryBytes = estimateBytes(entry.feature->getGeometries());
+            shared->add(&entry.geometriesOnce, entry.geometryBytes);
+        });
+        return entry.feature->getGeometries();
+    }
+
+    const PropertyMap& getProperties(Entry& entry) {
+        std::call_once(entry.propertiesOnce, [&] {
+            entry.propertyBytes = estimateBytes(entry.feature->getProperties());
+            shared->add(&entry.propertiesOnce, entry.propertyBytes);
+            entry.hasProperties.store(true, std::memory_order_release);
+        });
+        return entry.feature->getProperties();
+    }
+
+    const std::shared_ptr<Shared> shared;
+    const std::unique_ptr<GeometryTileLayer> layer;
+    const std::size_t count;
+
+private:
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+};
+
+namespace {
+
+class CachedTileFeature : public GeometryTileFeature {
+public:
+    CachedTileFeature(std::shared_ptr<FeatureDecodeCache::LayerTable> table_, Entry& entry_)
+        : table(std::move(table_)),
+          entry(entry_) {}
+
+    FeatureType getType() const override { return entry.feature->getType(); }
+
+    std::optional<Value> getValue(const std::string& key) const override {
+        if (entry.hasProperties.load(std::memory_order_acquire)) {
+            const auto& properties = entry.feature->getProperties();
+            const auto it = properties.find(key);
+            return it != properties.end() ? std::optional<Value>(it->second) : std::nullopt;
+        }
+        return entry.feature->getValue(key);
+    }
+
+    const PropertyMap& getProperties() const override { return table->getProperties(entry); }
+
+    FeatureIdentifier getID() const override { return entry.feature->getID(); }
+
+    const GeometryCollection& getGeometries() const override { return table->getGeometries(entry); }
+
+private:
+    // Keeps the decoded data alive for as long as the feature is, e.g., while held by a symbol layout
+    std::shared_ptr<FeatureDecodeCache::LayerTable> table;
+    Entry& entry;
+};
+
+class CachedTileLayer : public GeometryTileLayer {
+public:
+    explicit CachedTileLayer(std::shared_ptr<FeatureDecodeCache::LayerTable> table_)
+        : table(std::move(table_)) {}
+
+    std::size_t featureCount() const override { return table->count; }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        if (auto* entry = table->get(i)) {
+            return std::make_unique<CachedTileFeature>(table, *entry);
+        }
+        return table->layer->getFeature(i);
+    }
+
+    std::string getName() const override { return table->layer->getName(); }
+
+private:
+    std::shared_ptr<FeatureDecodeCache::LayerTable> table;
+};
+
+} // namespace
+
+FeatureDecodeCache::FeatureDecodeCache(std::size_t maxBytes)
+    : shared(std::make_shared<Shared>(maxBytes)) {}
+
+FeatureDecodeCache::~FeatureDecodeCache() = default;
+
+std::unique_ptr<GeometryTileLayer> FeatureDecodeCache::getLayer(const GeometryTileData& data,
+                                                                const std::string& sourceLayer) {
+    auto it = tables.find(sourceLayer);
+    if (it == tables.end()) {
+        auto layer = data.getLayer(sourceLayer);
+        if (!layer) {
+            return nullptr;
+        }
+        it = tables.emplace(sourceLayer, std::make_shared<LayerTable>(shared, std::move(layer))).first;
+    }
+    return std::make_unique<CachedTileLayer>(it->second);
+}
+
+FeatureDecodeCache::Stats FeatureDecodeCache::getStats() const {
+    return {.bytes = shared->bytes, .features = shared->features, .hits = shared->hits, .misses = shared->misses};
+}
+
+} // namespace mbgl
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+/**
+ * @brief Shares decoded features between the layer groups of a single tile parse.
+ *
+ * Several style layers usually read the same source layer, and each of them would otherwise
+ * decode and scale the same geometries and property maps again. Layers obtained through this
+ * cache hand out features whose geometries and properties are decoded at most once, no matter
+ * how many groups (or threads) read them.
+ *
+ * Memory is bounded by `maxBytes`. Once the budget is used up, features which aren't cached yet
+ * are returned directly from the tile data and decoded privately, as without the cache.
+ *
+ * Cached data is released when the cache and every feature handed out by it are gone.
+ */
+class FeatureDecodeCache {
+public:
+    struct Stats {
+        /// Estimated size of the decoded geometries and properties held
+        std::size_t bytes = 0;
+        /// Number of features held
+        std::size_t features = 0;
+        /// Requests for a feature which was already held
+        std::size_t hits = 0;
+        /// Requests which could not be cached because the budget was used up
+        std::size_t misses = 0;
+    };
+
+    static constexpr std::size_t defaultMaxBytes = 16 * 1024 * 1024;
+
+    explicit FeatureDecodeCache(std::size_t maxBytes = defaultMaxBytes);
+    ~FeatureDecodeCache();
+
+    /// Returns the named source layer of `data`, or null if it doesn't exist. All layers returned
+    /// for the same name share decoded features. Must not be called concurrently; the returned
+    /// layers and features may be used from any thread.
+    std::unique_ptr<GeometryTileLayer> getLayer(const GeometryTileData& data, const std::string& sourceLayer);
+
+    Stats getStats() const;
+
+    class Shared;
+    class LayerTable;
+
+private:
+    std::shared_ptr<Shared> shared;
+    std::map<std::string, std::shared_ptr<LayerTable>> tables;
+};
+
+} // namespace mbgl
@@ -23,13 +23,19 @@ void GeoJSONTile::updateData(std::shared_ptr<style::GeoJSONData> data_, bool nee
     MLN_TRACE_FUNC();
 
     assert(data_);
+    if (data && !needsRelayout && !data_->isTileAffected(id.canonical, *data)) {
+        // An incremental update which doesn't touch this tile, a pending request still has the right features
+        data = std::move(data_);
+        return;
+    }
+
     data = std::move(data_);
     if (needsRelayout) reset();
     data->getTile(
         id.canonical,
-        [this, self = weakFactory.makeWeakPtr(), capturedData = data.get()](TileFeatures features) {
+        [this, self = weakFactory.makeWeakPtr(), capturedRequest = ++dataRequest](TileFeatures features) {
             // If the data has changed, a new request is being processed, ignore this one
-            if (auto guard = self.lock(); self && data.get() == capturedData) {
+            if (auto guard = self.lock(); self && dataRequest == capturedRequest) {
                 setData(std::make_unique<GeoJSONTileData>(std::move(features)));
             }
         },
@@ -25,6 +25,7 @@ public:
 
 private:
     std::shared_ptr<style::GeoJSONData> data;
+    uint64_t dataRequest = 0;
     mapbox::base::WeakPtrFactory<GeoJSONTile> weakFactory{this};
     // Do not add members here, see `WeakPtrFactory`
 };
@@ -22,6 +22,7 @@
 #include <mbgl/util/thread_pool.hpp>
 #include <mbgl/gfx/upload_pass.hpp>
 
+#include <unordered_set>
 #include <utility>
 
 namespace mbgl {
@@ -234,6 +235,34 @@ void GeometryTile::cancel() {
     markObsolete();
 }
 
+std::size_t GeometryTile::getMemoryUsage() const {
+    if (!layoutResult) {
+        return 0;
+    }
+
+    std::size_t bytes = 0;
+    // Layers sharing a layout share their bucket
+    std::unordered_set<const Bucket*> buckets;
+    for (const auto& pair : layoutResult->layerRenderData) {
+        if (pair.second.bucket && buckets.insert(pair.second.bucket.get()).second) {
+            bytes += pair.second.bucket->getMemoryUsage();
+        }
+    }
+
+    // Glyphs are single channel, icons and patterns are RGBA
+    const auto atlasBytes = [](const std::vector<gfx::TextureHandle>& handles, std::size_t pixelSize) {
+        std::size_t result = 0;
+        for (const auto& handle : handles) {
+            const auto& rect = handle.getRectangle();
+            result += std::size_t{rect.w} * rect.h * pixelSize;
+        }
+        return result;
+    };
+    bytes += atlasBytes(layoutResult->glyphAtlas.textureHandles, 1);
+    bytes += atlasBytes(layoutResult->imageAtlas.textureHandles, 4);
+    return bytes;
+}
+
 void GeometryTile::markObsolete() {
     obsolete = true;
     mailbox->abandon();
@@ -380,6 +409,8 @@ void GeometryTile::onGlyphsAvailable(GlyphMap glyphMap, [[maybe_unused]] HBShape
 
     HBShapeResults results;
 #ifdef MLN_TEXT_SHAPING_HARFBUZZ
+    // Glyphs that still need to be rasterized, all of which are done at once afterwards
+    std::map<FontStack, GlyphIDs> missingGlyphs;
     for (auto& fontStackIT : requests) {
         auto fontStack = fontStackIT.first;
         auto& fontTypes = fontStackIT.second;
@@ -405,8 +436,7 @@ void GeometryTile::onGlyphsAvailable(GlyphMap glyphMap, [[maybe_unused]] HBShape
                         if (glyphs.contains(glyphID)) needShape = false;
                     }
                     if (needShape) {
-                        auto glyph = glyphManager->getGlyph(fontStack, glyphID);
-                        glyphMap[fontStackHash].emplace(glyph->id, glyph);
+                        missingGlyphs[fontStack].insert(glyphID);
                     }
                 }
 
@@ -415,6 +445,15 @@ void GeometryTile::onGlyphsAvailable(GlyphMap glyphMap, [[maybe_unused]] HBShape
             }
         }
     }
+
+    for (const auto& [fontStack, glyphIDs] : missingGlyphs) {
+        glyphManager->loadGlyphs(fontStack, glyphIDs);
+        auto& glyphs = glyphMap[FontStackHasher()(fontStack)];
+        for (const auto& glyphID : glyphIDs) {
+            auto glyph = glyphManager->getGlyph(fontStack, glyphID);
+            glyphs.emplace(glyph->id, glyph);
+        }
+    }
 #endif // MLN_TEXT_SHAPING_HARFBUZZ
     worker.self().invoke(&GeometryTileWorker::onGlyphsAvailable, std::move(glyphMap), std::move(results));
 }
@@ -423,7 +462,7 @@ void GeometryTile::getGlyphs(GlyphDependencies glyphDependencies) {
     MLN_TRACE_FUNC();
 
     if (fileSource) {
-        glyphManager->getGlyphs(*this, std::move(glyphDependencies), *fileSource);
+        glyphManager->getGlyphs(*this, std::move(glyphDependencies), fileSource);
     }
 }
 
@@ -101,6 +101,8 @@ public:
 
     void setFeatureState(const LayerFeatureStates&) override;
 
+    std::size_t getMemoryUsage() const override;
+
 protected:
     const GeometryTileData* getData() const;
     LayerRenderData* getLayerRenderData(const style::Layer::Impl&);
@@ -90,6 +90,14 @@ public:
     // Returns the layer with the given name. The returned layer object *may*
     // outlive the data object.
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
+
+    // Returns the encoded tile this data is read from, if there is one. Data read from
+    // identical bytes always yields identical layers.
+    virtual std::shared_ptr<const std::string> getRawData() const { return nullptr; }
+
+    // Identifies the encoded tile across maps, e.g. by where it came from and when it was last
+    // modified. Data with equal non-zero versions holds identical bytes, zero means unknown.
+    virtual std::size_t getVersion() const { return 0; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
@@ -1,10 +1,13 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
+#include <mbgl/tile/columnar_filter.hpp>
+#include <mbgl/tile/feature_decode_cache.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
 #include <mbgl/layout/layout.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/style/filter.hpp>
@@ -19,9 +22,13 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/hash.hpp>
 #include <mbgl/util/stopwatch.hpp>
+#include <mbgl/util/parallel_for.hpp>
 #include <mbgl/util/thread_pool.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <unordered_set>
 #include <utility>
 
@@ -29,6 +36,22 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Expected number of elements per feature index cell, to avoid small reallocations for populated cells.
+constexpr auto estimatedElementsPerCell = 8;
+
+// Tiles with fewer layer groups than this are not worth splitting up across the worker pool
+constexpr std::size_t minParallelLayerGroups = 4;
+
+bool parallelLayerParsingEnabled() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PARALLEL_LAYER_PARSING);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+} // namespace
+
 GeometryTileWorker::GeometryTileWorker(OptionalActorRef<GeometryTileWorker> self_,
                                        OptionalActorRef<GeometryTile> parent_,
                                        const TaggedScheduler& scheduler_,
@@ -48,6 +71,7 @@ GeometryTileWorker::GeometryTileWorker(OptionalActorRef<GeometryTileWorker> self
       obsolete(obsolete_),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      parallelParsing(parallelLayerParsingEnabled()),
       showCollisionBoxes(showCollisionBoxes_),
       dynamicTextureAtlas(dynamicTextureAtlas_),
       fontFaces(fontFaces_) {}
@@ -165,6 +189,7 @@ void GeometryTileWorker::setLayers(std::vector<Immutable<LayerProperties>> layer
         layers = std::move(layers_);
         correlationID = correlationID_;
         availableImages = std::move(availableImages_);
+        compileFilters();
 
         switch (state) {
             case Idle:
@@ -185,6 +210,23 @@ void GeometryTileWorker::setLayers(std::vector<Immutable<LayerProperties>> layer
     }
 }
 
+void GeometryTileWorker::compileFilters() {
+    mbgl::unordered_map<std::string, CompiledFilter> compiled;
+    for (const auto& layer : *layers) {
+        const style::Layer::Impl& impl = *layer->baseImpl;
+        if (impl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
+            continue;
+        }
+        if (const auto it = compiledFilters.find(impl.id);
+            it != compiledFilters.end() && it->second.filter == impl.filter) {
+            compiled.emplace(impl.id, std::move(it->second));
+        } else {
+            compiled.emplace(impl.id, CompiledFilter{impl.filter, ColumnarFilter::compile(impl.filter)});
+        }
+    }
+    compiledFilters = std::move(compiled);
+}
+
 void GeometryTileWorker::reset(uint64_t correlationID_) {
     layers = std::nullopt;
     data = std::nullopt;
@@ -415,8 +457,6 @@ void GeometryTileWorker::parse() {
 
     MBGL_TIMING_START(watch)
 
-    std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
-
     renderData.clear();
     layouts.clear();
 
@@ -424,93 +464,118 @@ void GeometryTileWorker::parse() {
 
     // Avoid small reallocations for populated cells.
     // If we had a total feature count, this could be based on that and the cell count.
-    constexpr auto estimatedElementsPerCell = 8;
     featureIndex->reserve(estimatedElementsPerCell);
 
+    parsedTileCache = ParsedTileCache::getDefault();
+    parsedTileKey.reset();
+    if (parsedTileCache && *data) {
+        if (auto rawData = (*data)->getRawData()) {
+            const auto version = (*data)->getVersion();
+            parsedTileKey = ParsedTileCache::Key{.sourceID = sourceID,
+                                                 .tileID = id,
+                                                 .mode = mode,
+                                                 .pixelRatio = pixelRatio,
+                                                 .layers = 0,
+                                                 .dataVersion = version,
+                                                 .data = version ? nullptr : std::move(rawData)};
+        }
+    }
+
     GlyphDependencies glyphDependencies;
     ImageDependencies imageDependencies;
 
     // Create render layers and group by layout
-    mbgl::unordered_map<std::string, std::vector<Immutable<style::LayerProperties>>> groupMap;
+    mbgl::unordered_map<std::string, LayerGroup> groupMap;
     groupMap.reserve(layers->size());
 
     for (auto layer : *layers) {
         groupMap[layoutKey(*layer->baseImpl)].push_back(std::move(layer));
     }
 
-    for (auto& pair : groupMap) {
-        const auto& group = pair.second;
-        if (obsolete) {
-            return;
+    // Source layers read by more than one group share their decoded features. The cache is
+    // dropped when parsing is done, features still held by pending layouts keep their data alive.
+    mbgl::unordered_map<std::string, std::size_t> sourceLayerReaders;
+    for (const auto& pair : groupMap) {
+        sourceLayerReaders[pair.second.at(0)->baseImpl->sourceLayer]++;
+    }
+    FeatureDecodeCache decodeCache;
+    const auto getGeometryLayer = [&](const LayerGroup& group) -> std::unique_ptr<GeometryTileLayer> {
+        const auto& sourceLayer = group.at(0)->baseImpl->sourceLayer;
+        return sourceLayerReaders[sourceLayer] > 1 ? decodeCache.getLayer(**data, sourceLayer)
+                                                   : (*data)->getLayer(sourceLayer);
+    };
+
+    // Shared source layers also share the property columns decoded for filtering
+    struct SharedColumns {
+        std::unique_ptr<GeometryTileLayer> geometryLayer;
+        std::unique_ptr<FeatureColumns> columns;
+    };
+    mbgl::unordered_map<std::string, SharedColumns> sharedColumns;
+    const auto getColumns = [&](const LayerGroup& group) -> FeatureColumns* {
+        const auto& sourceLayer = group.at(0)->baseImpl->sourceLayer;
+        if (sourceLayerReaders[sourceLayer] < 2) {
+            return nullptr;
         }
-
-        if (!*data) {
-            continue; // Tile has no data.
+        auto& shared = sharedColumns[sourceLayer];
+        if (!shared.geometryLayer) {
+            shared.geometryLayer = decodeCache.getLayer(**data, sourceLayer);
+            if (!shared.geometryLayer) {
+                return nullptr;
+            }
+            shared.columns = std::make_unique<FeatureColumns>(*shared.geometryLayer);
         }
-
-        const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
-        BucketParameters parameters{
-            .tileID = id, .mode = mode, .pixelRatio = pixelRatio, .layerType = leaderImpl.getTypeInfo()};
-
-        auto geometryLayer = (*data)->getLayer(leaderImpl.sourceLayer);
-        if (!geometryLayer) {
-            continue;
+        return shared.columns.get();
+    };
+
+    if (parallelParsing && *data && groupMap.size() >= minParallelLayerGroups) {
+        // Source layers are resolved up front, tile data may parse its layer table lazily
+        std::vector<LayerGroupInput> groups;
+        groups.reserve(groupMap.size());
+        for (const auto& pair : groupMap) {
+            if (auto geometryLayer = getGeometryLayer(pair.second)) {
+                groups.push_back({&pair.second, std::move(geometryLayer), getColumns(pair.second)});
+            }
         }
-
-        std::vector<std::string> layerIDs;
-        layerIDs.reserve(group.size());
-        for (const auto& layer : group) {
-            layerIDs.push_back(layer->baseImpl->id);
-        }
-
-        featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
-
-        // Symbol layers and layers that support pattern properties have an
-        // extra step at layout time to figure out what images/glyphs are needed
-        // to render the layer. They use the intermediate Layout data structure
-        // to accomplish this, and either immediately create a bucket if no
-        // images/glyphs are used, or the Layout is stored until the
-        // images/glyphs are available to add the features to the buckets.
-        if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
-            std::unique_ptr<Layout> layout = LayerManager::get()->createLayout({.bucketParameters = parameters,
-                                                                                .fontFaces = fontFaces,
-                                                                                .glyphDependencies = glyphDependencies,
-                                                                                .imageDependencies = imageDependencies,
-                                                                                .availableImages = availableImages},
-                                                                               std::move(geometryLayer),
-                                                                               group);
-            if (layout->hasDependencies()) {
-                layouts.push_back(std::move(layout));
-            } else {
-                layout->createBucket({}, featureIndex, renderData, firstLoad, showCollisionBoxes, id.canonical);
+        parseLayerGroupsParallel(std::move(groups), glyphDependencies, imageDependencies);
+    } else {
+        for (auto& pair : groupMap) {
+            const auto& group = pair.second;
+            if (obsolete) {
+                return;
             }
-        } else {
-            const Filter& filter = leaderImpl.filter;
-            const std::string& sourceLayerID = leaderImpl.sourceLayer;
-            std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
-
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
-
-                if (!filter(expression::EvaluationContext(static_cast<float>(this->id.overscaledZ), feature.get())
-                                .withCanonicalTileID(&id.canonical)))
-                    continue;
 
-                const GeometryCollection& geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i, id.canonical);
-                featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
+            if (!*data) {
+                continue; // Tile has no data.
             }
 
-            if (!bucket->hasData()) {
+            auto geometryLayer = getGeometryLayer(group);
+            if (!geometryLayer) {
                 continue;
             }
 
-            for (const auto& layer : group) {
-                renderData.emplace(layer->baseImpl->id, LayerRenderData{.bucket = bucket, .layerProperties = layer});
-            }
+            parseLayerGroupCached(group,
+                                  std::move(geometryLayer),
+                                  getColumns(group),
+                                  featureIndex,
+                                  renderData,
+                                  layouts,
+                                  glyphDependencies,
+                                  imageDependencies);
         }
     }
 
+    if (obsolete) {
+        return;
+    }
+
+    {
+        MLN_TRACE_ZONE(feature decode cache);
+        [[maybe_unused]] const auto cacheStats = decodeCache.getStats();
+        MLN_ZONE_VALUE(cacheStats.bytes);
+        MLN_ZONE_VALUE(cacheStats.hits);
+        MLN_ZONE_VALUE(cacheStats.misses);
+    }
+
     requestNewGlyphs(glyphDependencies);
     requestNewImages(imageDependencies);
 
@@ -522,6 +587,252 @@ void GeometryTileWorker::parse() {
     finalizeLayout();
 }
 
+void GeometryTileWorker::parseLayerGroup(const LayerGroup& group,
+                                         std::unique_ptr<GeometryTileLayer> geometryLayer,
+                                         FeatureColumns* columns,
+                                         std::unique_ptr<FeatureIndex>& featureIndex_,
+                                         mbgl::unordered_map<std::string, LayerRenderData>& renderData_,
+                                         std::vector<std::unique_ptr<Layout>>& layouts_,
+                                         GlyphDependencies& glyphDependencies,
+                                         ImageDependencies& imageDependencies) {
+    const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
+    BucketParameters parameters{
+        .tileID = id, .mode = mode, .pixelRatio = pixelRatio, .layerType = leaderImpl.getTypeInfo()};
+
+    std::vector<std::string> layerIDs;
+    layerIDs.reserve(group.size());
+    for (const auto& layer : group) {
+        layerIDs.push_back(layer->baseImpl->id);
+    }
+
+    featureIndex_->setBucketLayerIDs(leaderImpl.id, layerIDs);
+
+    // Symbol layers and layers that support pattern properties have an
+    // extra step at layout time to figure out what images/glyphs are needed
+    // to render the layer. They use the intermediate Layout data structure
+    // to accomplish this, and either immediately create a bucket if no
+    // images/glyphs are used, or the Layout is stored until the
+    // images/glyphs are available to add the features to the buckets.
+    if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
+        std::unique_ptr<Layout> layout = LayerManager::get()->createLayout({.bucketParameters = parameters,
+                                                                            .fontFaces = fontFaces,
+                                                                            .glyphDependencies = glyphDependencies,
+                                                                            .imageDependencies = imageDependencies,
+                                                                            .availableImages = availableImages},
+                                                                           std::move(geometryLayer),
+                                                                           group);
+        if (layout->hasDependencies()) {
+            layouts_.push_back(std::move(layout));
+        } else {
+            layout->createBucket({}, featureIndex_, renderData_, firstLoad, showCollisionBoxes, id.canonical);
+        }
+    } else {
+        const Filter& filter = leaderImpl.filter;
+        const std::string& sourceLayerID = leaderImpl.sourceLayer;
+        std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
+
+        // Filters reading nothing but properties, type and ID are evaluated for the whole layer
+        // at once, and features which don't pass aren't decoded at all.
+        std::optional<std::vector<bool>> selection;
+        const auto compiled = compiledFilters.find(leaderImpl.id);
+        if (compiled != compiledFilters.end() && compiled->second.columnarFilter) {
+            const auto& columnarFilter = compiled->second.columnarFilter;
+            std::optional<FeatureColumns> ownColumns;
+            if (!columns) {
+                columns = &ownColumns.emplace(*geometryLayer);
+            }
+            selection = columnarFilter->select(*columns, static_cast<float>(id.overscaledZ), id.canonical);
+        }
+
+        for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
+            if (selection && !(*selection)[i]) {
+                continue;
+            }
+
+            std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+
+            if (!selection &&
+                !filter(expression::EvaluationContext(static_cast<float>(this->id.overscaledZ), feature.get())
+                            .withCanonicalTileID(&id.canonical)))
+                continue;
+
+            const GeometryCollection& geometries = feature->getGeometries();
+            bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i, id.canonical);
+            featureIndex_->insert(geometries, i, sourceLayerID, leaderImpl.id);
+        }
+
+        if (!bucket->hasData()) {
+            return;
+        }
+
+        for (const auto& layer : group) {
+            renderData_.emplace(layer->baseImpl->id, LayerRenderData{.bucket = bucket, .layerProperties = layer});
+        }
+    }
+}
+
+std::optional<ParsedTileCache::Key> GeometryTileWorker::getParsedTileKey(const LayerGroup& group) const {
+    // Symbol buckets carry placement state of the map they're rendered in
+    if (!parsedTileKey ||
+        group.at(0)->baseImpl->getTypeInfo()->crossTileIndex == LayerTypeInfo::CrossTileIndex::Required) {
+        return std::nullopt;
+    }
+
+    auto key = *parsedTileKey;
+    for (const auto& layer : group) {
+        if (!layer->baseImpl->fingerprint.value) {
+            return std::nullopt;
+        }
+        util::hash_combine(key.layers, layer->baseImpl->fingerprint.value);
+    }
+    return key;
+}
+
+void GeometryTileWorker::parseLayerGroupCached(const LayerGroup& group,
+                                               std::unique_ptr<GeometryTileLayer> geometryLayer,
+                                               FeatureColumns* columns,
+                                               std::unique_ptr<FeatureIndex>& featureIndex_,
+                                               mbgl::unordered_map<std::string, LayerRenderData>& renderData_,
+                                               std::vector<std::unique_ptr<Layout>>& layouts_,
+                                               GlyphDependencies& glyphDependencies,
+                                               ImageDependencies& imageDependencies) {
+    auto key = getParsedTileKey(group);
+    if (!key) {
+        parseLayerGroup(group,
+                        std::move(geometryLayer),
+                        columns,
+                        featureIndex_,
+                        renderData_,
+                        layouts_,
+                        glyphDependencies,
+                        imageDependencies);
+        return;
+    }
+
+    if (const auto entry = parsedTileCache->get(*key)) {
+        MLN_TRACE_ZONE(parsed tile cache hit);
+        featureIndex_->merge(*entry->featureIndex);
+        if (entry->bucket) {
+            const std::shared_ptr<Bucket> bucket = entry->bucket->clone();
+            for (const auto& layer : group) {
+                renderData_.emplace(layer->baseImpl->id, LayerRenderData{.bucket = bucket, .layerProperties = layer});
+            }
+        }
+        return;
+    }
+
+    // The group gets an index of its own, so that its features can be stored separately
+    auto groupIndex = std::make_unique<FeatureIndex>(nullptr);
+    groupIndex->reserve(estimatedElementsPerCell);
+    mbgl::unordered_map<std::string, LayerRenderData> groupRenderData;
+    std::vector<std::unique_ptr<Layout>> groupLayouts;
+    parseLayerGroup(group,
+                    std::move(geometryLayer),
+                    columns,
+                    groupIndex,
+                    groupRenderData,
+                    groupLayouts,
+                    glyphDependencies,
+                    imageDependencies);
+    if (obsolete) {
+        return;
+    }
+
+    featureIndex_->merge(*groupIndex);
+
+    // Groups waiting for images are finished by each map on its own. All layers of a group
+    // share one bucket, which the stored copy is taken from.
+    if (groupLayouts.empty()) {
+        std::shared_ptr<const Bucket> bucket;
+        if (!groupRenderData.empty()) {
+            bucket = groupRenderData.begin()->second.bucket->clone();
+        }
+        if (bucket || groupRenderData.empty()) {
+            parsedTileCache->put(std::move(*key),
+                                 std::make_shared<const ParsedTileCache::Entry>(ParsedTileCache::Entry{
+                                     .bucket = std::move(bucket), .featureIndex = std::move(groupIndex)}));
+        }
+    }
+
+    for (auto& pair : groupRenderData) {
+        renderData_.emplace(pair.first, std::move(pair.second));
+    }
+    std::move(groupLayouts.begin(), groupLayouts.end(), std::back_inserter(layouts_));
+}
+
+void GeometryTileWorker::parseLayerGroupsParallel(std::vector<LayerGroupInput> groups,
+                                                  GlyphDependencies& glyphDependencies,
+                                                  ImageDependencies& imageDependencies) {
+    MLN_TRACE_FUNC();
+
+    if (groups.empty()) {
+        return;
+    }
+
+    // Each group is parsed into its own shard, and shards are merged in group order
+    // afterwards so the result matches what the serial path would have produced.
+    struct Shard {
+        std::unique_ptr<FeatureIndex> featureIndex;
+        mbgl::unordered_map<std::string, LayerRenderData> renderData;
+        std::vector<std::unique_ptr<Layout>> layouts;
+        GlyphDependencies glyphDependencies;
+        ImageDependencies imageDependencies;
+    };
+
+    std::vector<Shard> shards(groups.size());
+    util::parallelFor(scheduler, groups.size(), [&](const std::size_t i) {
+        MLN_TRACE_ZONE(parse layer group);
+        if (obsolete) {
+            return;
+        }
+        auto& shard = shards[i];
+        shard.featureIndex = std::make_unique<FeatureIndex>(nullptr);
+        shard.featureIndex->reserve(estimatedElementsPerCell);
+        auto& input = groups[i];
+        parseLayerGroupCached(*input.group,
+                              std::move(input.geometryLayer),
+                              input.columns,
+                              shard.featureIndex,
+                              shard.renderData,
+                              shard.layouts,
+                              shard.glyphDependencies,
+                              shard.imageDependencies);
+    });
+
+    if (obsolete) {
+        return;
+    }
+
+    MLN_TRACE_ZONE(merge);
+    for (auto& shard : shards) {
+        if (!shard.featureIndex) {
+            continue;
+        }
+
+        featureIndex->merge(*shard.featureIndex);
+
+        for (auto& pair : shard.renderData) {
+            renderData.emplace(pair.first, std::move(pair.second));
+        }
+
+        std::move(shard.layouts.begin(), shard.layouts.end(), std::back_inserter(layouts));
+
+        for (auto& [fontStack, glyphIDs] : shard.glyphDependencies.glyphs) {
+            glyphDependencies.glyphs[fontStack].merge(glyphIDs);
+        }
+        for (auto& [fontStack, types] : shard.glyphDependencies.shapes) {
+            for (auto& [type, strings] : types) {
+                glyphDependencies.shapes[fontStack][type].merge(strings);
+            }
+        }
+
+        // First one wins, as when a single map is shared by every group
+        for (auto& pair : shard.imageDependencies) {
+            imageDependencies.emplace(pair.first, pair.second);
+        }
+    }
+}
+
 bool GeometryTileWorker::hasPendingDependencies() const {
     for (auto& glyphDependency : pendingGlyphDependencies.glyphs) {
         if (!glyphDependency.second.empty()) {
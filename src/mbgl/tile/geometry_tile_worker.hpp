@@ -11,14 +11,18 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/tile/columnar_filter.hpp>
+#include <mbgl/tile/parsed_tile_cache.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/containers.hpp>
 
 #include <atomic>
 #include <memory>
+#include <optional>
 
 namespace mbgl {
 
+class FeatureColumns;
 class GeometryTile;
 class GeometryTileData;
 class Layout;
@@ -66,6 +70,35 @@ public:
 private:
     void coalesced();
     void parse();
+    using LayerGroup = std::vector<Immutable<style::LayerProperties>>;
+    struct LayerGroupInput {
+        const LayerGroup* group;
+        std::unique_ptr<GeometryTileLayer> geometryLayer;
+        // Columns shared with other groups reading the same source layer, may be null
+        FeatureColumns* columns;
+    };
+    void parseLayerGroupsParallel(std::vector<LayerGroupInput>, GlyphDependencies&, ImageDependencies&);
+    void parseLayerGroup(const LayerGroup& group,
+                         std::unique_ptr<GeometryTileLayer> geometryLayer,
+                         FeatureColumns* columns,
+                         std::unique_ptr<FeatureIndex>& featureIndex_,
+                         mbgl::unordered_map<std::string, LayerRenderData>& renderData_,
+                         std::vector<std::unique_ptr<Layout>>& layouts_,
+                         GlyphDependencies&,
+                         ImageDependencies&);
+    // Same as `parseLayerGroup`, but copies the group from the shared parsed tile cache if it's
+    // there, and stores it there once parsed otherwise
+    void parseLayerGroupCached(const LayerGroup& group,
+                               std::unique_ptr<GeometryTileLayer> geometryLayer,
+                               FeatureColumns* columns,
+                               std::unique_ptr<FeatureIndex>& featureIndex_,
+                               mbgl::unordered_map<std::string, LayerRenderData>& renderData_,
+                               std::vector<std::unique_ptr<Layout>>& layouts_,
+                               GlyphDependencies&,
+                               ImageDependencies&);
+    std::optional<ParsedTileCache::Key> getParsedTileKey(const LayerGroup&) const;
+    // Compiles the filters of layers which are new or changed, see `compiledFilters`
+    void compileFilters();
     void finalizeLayout();
 
     void coalesce();
@@ -89,9 +122,17 @@ private:
     const MapMode mode;
     const float pixelRatio;
 
+    // Parse the layer groups of a tile concurrently, see `platform::EXPERIMENTAL_PARALLEL_LAYER_PARSING`
+    const bool parallelParsing;
+
     std::unique_ptr<FeatureIndex> featureIndex;
     mbgl::unordered_map<std::string, LayerRenderData> renderData;
 
+    // Shared with other maps, see `platform::EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES`. Both are
+    // set up by `parse` and left unset if the cache is disabled or the tile can't be stored.
+    std::shared_ptr<ParsedTileCache> parsedTileCache;
+    std::optional<ParsedTileCache::Key> parsedTileKey;
+
     enum State {
         Idle,
         Coalescing,
@@ -107,6 +148,14 @@ private:
     std::optional<std::vector<Immutable<style::LayerProperties>>> layers;
     std::optional<std::unique_ptr<const GeometryTileData>> data;
 
+    // The columnar filters of the layers which aren't laid out, by layer ID, kept for as long as
+    // the filter of the layer stays the same. Nothing if the filter can't be compiled.
+    struct CompiledFilter {
+        style::Filter filter;
+        std::optional<ColumnarFilter> columnarFilter;
+    };
+    mbgl::unordered_map<std::string, CompiledFilter> compiledFilters;
+
     std::vector<std::unique_ptr<Layout>> layouts;
 
     GlyphDependencies pendingGlyphDependencies;
@@ -0,0 +1,139 @@
+#include <mbgl/tile/parsed_tile_cache.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+
+namespace {
+
+const std::shared_ptr<ParsedTileCache>& defaultCache() {
+    static const auto cache = std::make_shared<ParsedTileCache>();
+    return cache;
+}
+
+} // namespace
+
+std::shared_ptr<ParsedTileCache> ParsedTileCache::getDefault() {
+    const auto& cache = defaultCache();
+    return cache->getMaxBytes() ? cache : nullptr;
+}
+
+std::shared_ptr<ParsedTileCache> ParsedTileCache::updateDefault() {
+    const auto& cache = defaultCache();
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES);
+    if (const auto* uintValue = value.getUint()) {
+        cache->setMaxBytes(static_cast<std::size_t>(*uintValue));
+    } else if (const auto* intValue = value.getInt()) {
+        cache->setMaxBytes(static_cast<std::size_t>(std::max<int64_t>(*intValue, 0)));
+    } else {
+        cache->setMaxBytes(0);
+    }
+    return getDefault();
+}
+
+std::size_t ParsedTileCache::KeyHash::operator()(const Key& key) const {
+    return util::hash(key.sourceID,
+                      key.tileID,
+                      static_cast<uint32_t>(key.mode),
+                      key.pixelRatio,
+                      key.layers,
+                      key.dataVersion,
+                      key.data);
+}
+
+ParsedTileCache::ParsedTileCache(std::size_t maxBytes_)
+    : maxBytes(maxBytes_) {}
+
+ParsedTileCache::~ParsedTileCache() = default;
+
+std::shared_ptr<const ParsedTileCache::Entry> ParsedTileCache::get(const Key& key) {
+    std::scoped_lock lock(mutex);
+
+    const auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    items.splice(items.begin(), items, it->second);
+    return it->second->entry;
+}
+
+void ParsedTileCache::put(Key key, std::shared_ptr<const Entry> entry) {
+    assert(entry);
+    const std::size_t entryBytes = sizeof(Item) + (entry->bucket ? entry->bucket->getMemoryUsage() : 0) +
+                                   (entry->featureIndex ? entry->featureIndex->getMemoryUsage() : 0);
+
+    std::scoped_lock lock(mutex);
+    if (entryBytes + (key.data ? key.data->size() : 0) > maxBytes) {
+        return;
+    }
+
+    if (const auto it = index.find(key); it != index.end()) {
+        remove(it->second);
+    }
+    add(std::move(key), std::move(entry), entryBytes);
+    evict();
+}
+
+void ParsedTileCache::add(Key key, std::shared_ptr<const Entry> entry, std::size_t itemBytes) {
+    if (key.data && dataRefs[key.data.get()]++ == 0) {
+        bytes += key.data->size();
+    }
+    items.push_front({key, std::move(entry), itemBytes});
+    index.emplace(std::move(key), items.begin());
+    bytes += itemBytes;
+}
+
+void ParsedTileCache::remove(Items::iterator it) {
+    if (const auto& data = it->key.data) {
+        const auto ref = dataRefs.find(data.get());
+        assert(ref != dataRefs.end());
+        if (--ref->second == 0) {
+            bytes -= data->size();
+            dataRefs.erase(ref);
+        }
+    }
+    bytes -= it->bytes;
+    index.erase(it->key);
+    items.erase(it);
+}
+
+void ParsedTileCache::setMaxBytes(std::size_t maxBytes_) {
+    std::scoped_lock lock(mutex);
+    maxBytes = maxBytes_;
+    evict();
+}
+
+std::size_t ParsedTileCache::getMaxBytes() const {
+    std::scoped_lock lock(mutex);
+    return maxBytes;
+}
+
+ParsedTileCache::Stats ParsedTileCache::getStats() const {
+    std::scoped_lock lock(mutex);
+    return {.hits = hits, .misses = misses, .evictions = evictions, .entries = items.size(), .bytes = bytes};
+}
+
+void ParsedTileCache::clear() {
+    std::scoped_lock lock(mutex);
+    items.clear();
+    index.clear();
+    dataRefs.clear();
+    bytes = 0;
+}
+
+void ParsedTileCache::evict() {
+    while (bytes > maxBytes && !items.empty()) {
+        remove(std::prev(items.end()));
+        evictions++;
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <mbgl/map/mode.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Bucket;
+class FeatureIndex;
+
+/**
+ * @brief Parsed vector tile layers shared by all maps in the process.
+ *
+ * Maps rendering the same style over the same sources parse the same tiles into the same
+ * buckets. The bucket and feature index built for a layer group are stored here, keyed by the
+ * source, the tile, the fingerprints of the layers and the version of the encoded tile, so that
+ * other maps can copy them instead of parsing the tile again.
+ *
+ * Entries are immutable. Uploading a bucket attaches GPU resources of one renderer to it, so
+ * maps never render a stored bucket directly but a copy of it (see `Bucket::clone`). Only layer
+ * groups which are complete right after parsing are stored; symbol layers, and layers waiting
+ * for images, are laid out by each map.
+ *
+ * Memory is bounded by `maxBytes`, least recently used entries are evicted first. Thread safe.
+ */
+class ParsedTileCache {
+public:
+    struct Key {
+        std::string sourceID;
+        OverscaledTileID tileID;
+        MapMode mode;
+        float pixelRatio;
+        /// Combined fingerprint of the layers in the group, see `style::Layer::Impl::fingerprint`
+        std::size_t layers;
+        /// Version of the encoded tile, see `GeometryTileData::getVersion`
+        std::size_t dataVersion = 0;
+        /// The encoded tile itself if it has no version, compared by address. Entries for it are
+        /// only found for as long as the same data is parsed again.
+        std::shared_ptr<const std::string> data;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct Entry {
+        /// Shared by every layer in the group, null if none of the features passed the filter
+        std::shared_ptr<const Bucket> bucket;
+        /// Features of the group, to be merged into the feature index of the tile
+        std::shared_ptr<const FeatureIndex> featureIndex;
+    };
+
+    struct Stats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        /// Entries dropped to stay within `maxBytes`
+        std::size_t evictions = 0;
+        std::size_t entries = 0;
+        /// Memory held by the stored buckets and feature indexes, and by the encoded tiles kept
+        /// alive by the keys, each counted once however many layer groups were stored for it
+        std::size_t bytes = 0;
+    };
+
+    /// A cache of 0 bytes stores nothing
+    explicit ParsedTileCache(std::size_t maxBytes = 0);
+    ~ParsedTileCache();
+
+    /// The cache shared by all maps in the process, or null if it's disabled
+    static std::shared_ptr<ParsedTileCache> getDefault();
+    /// Sizes the default cache by `platform::EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES` and returns
+    /// it. Called when a style is loaded, along with fingerprinting its layers, so that tiles only
+    /// look up the cache if the layers they parse have fingerprints.
+    static std::shared_ptr<ParsedTileCache> updateDefault();
+
+    std::shared_ptr<const Entry> get(const Key&);
+
+    /// Stores the entry, replacing the one previously stored for the key
+    void put(Key, std::shared_ptr<const Entry>);
+
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const;
+
+    Stats getStats() const;
+    void clear();
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+    struct Item {
+        Key key;
+        std::shared_ptr<const Entry> entry;
+        /// Without the encoded tile, see `dataRefs`
+        std::size_t bytes;
+    };
+    using Items = std::list<Item>;
+
+    /// Drops least recently used entries until within `maxBytes`, must hold the lock
+    void evict();
+    /// Adds or drops an item, counting the encoded tile of its key along with the first or last
+    /// item referencing it. Must hold the lock.
+    void add(Key, std::shared_ptr<const Entry>, std::size_t itemBytes);
+    void remove(Items::iterator);
+
+    mutable std::mutex mutex;
+    std::size_t maxBytes;
+    std::size_t bytes = 0;
+    /// Most recently used first
+    Items items;
+    std::unordered_map<Key, Items::iterator, KeyHash> index;
+    /// The number of items referencing each encoded tile
+    std::unordered_map<const std::string*, std::size_t> dataRefs;
+
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+};
+
+} // namespace mbgl
@@ -123,18 +123,43 @@ void RasterDEMTile::backfillBorder(const RasterDEMTile& borderTile, const DEMTil
         }
     }
     const HillshadeBucket* borderBucket = borderTile.getBucket();
-    if (borderBucket) {
-        const DEMData& borderDEM = borderBucket->getDEMData();
-        DEMData& tileDEM = bucket->getDEMData();
-
-        tileDEM.backfillBorder(borderDEM, dx, dy);
+    // Tiles from the same source should always be of the same dimensions.
+    if (bucket && borderBucket && borderBucket->getDEMData().dim == bucket->getDEMData().dim) {
+        pendingBorders.push_back({borderBucket->getDEMData().getImagePtr(), static_cast<int8_t>(dx), dy});
         // update the bitmask to indicate that this tiles have been backfilled by flipping the relevant bit
         this->neighboringTiles = this->neighboringTiles | mask;
+    }
+}
+
+void RasterDEMTile::flushBackfill() {
+    if (backfilling || pendingBorders.empty() || !bucket) {
+        return;
+    }
+
+    backfilling = true;
+    const DEMData& dem = bucket->getDEMData();
+    worker.self().invoke(&RasterDEMTileWorker::backfill, dem.getImagePtr(), dem.dim, std::move(pendingBorders));
+    pendingBorders.clear();
+}
+
+void RasterDEMTile::onBackfilled(std::shared_ptr<const PremultipliedImage> original,
+                                 std::shared_ptr<PremultipliedImage> result) {
+    backfilling = false;
+    if (obsolete || !bucket) {
+        return;
+    }
+
+    // Drop the result if the tile was parsed again in the meantime
+    if (bucket->getDEMData().getImagePtr() == original) {
+        bucket->getDEMData().setImage(std::move(result));
         // mark HillshadeBucket.prepared as false so it runs through the prepare
         // render pass with the new texture data we just backfilled
         bucket->setPrepared(false);
         bucket->renderTargetPrepared = false;
     }
+
+    flushBackfill();
+    observer->onTileChanged(*this);
 }
 
 void RasterDEMTile::setMask(TileMask&& mask) {
@@ -155,6 +180,10 @@ void RasterDEMTile::cancel() {
     markObsolete();
 }
 
+std::size_t RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 void RasterDEMTile::markObsolete() {
     obsolete = true;
     if (pending) {
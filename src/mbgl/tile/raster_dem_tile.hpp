@@ -76,7 +76,11 @@ public:
     bool layerPropertiesUpdated(const Immutable<style::LayerProperties>& layerProperties) override;
 
     HillshadeBucket* getBucket() const;
+
+    // Queues backfilling the border from a neighbouring tile, which happens on the worker once
+    // `flushBackfill` is called
     void backfillBorder(const RasterDEMTile& borderTile, DEMTileNeighbors mask);
+    void flushBackfill();
 
     // neighboringTiles is a bitmask for which neighboring tiles have been backfilled
     // there are max 8 possible neighboring tiles, so each bit represents one neighbor
@@ -86,9 +90,12 @@ public:
 
     void onParsed(std::unique_ptr<HillshadeBucket> result, uint64_t correlationID);
     void onError(std::exception_ptr, uint64_t correlationID);
+    void onBackfilled(std::shared_ptr<const PremultipliedImage> original, std::shared_ptr<PremultipliedImage> result);
 
     void cancel() override;
 
+    std::size_t getMemoryUsage() const override;
+
 private:
     void markObsolete();
 
@@ -106,6 +113,11 @@ private:
     std::shared_ptr<HillshadeBucket> bucket;
 
     bool obsolete = false;
+
+    // Borders waiting for the backfill in progress to finish, so that it's always based on
+    // the previous result
+    std::vector<RasterDEMTileWorker::Border> pendingBorders;
+    bool backfilling = false;
 };
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 #include <mbgl/tile/raster_dem_tile.hpp>
 #include <mbgl/renderer/buckets/hillshade_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 namespace mbgl {
@@ -26,4 +27,14 @@ void RasterDEMTileWorker::parse(const std::shared_ptr<const std::string>& data,
     }
 }
 
+void RasterDEMTileWorker::backfill(const std::shared_ptr<const PremultipliedImage>& image,
+                                   int32_t dim,
+                                   std::vector<Border> borders) {
+    auto result = std::make_shared<PremultipliedImage>(image->clone());
+    for (const auto& border : borders) {
+        DEMData::backfillBorder(*result, *border.image, dim, border.dx, border.dy);
+    }
+    parent.invoke(&RasterDEMTile::onBackfilled, image, std::move(result));
+}
+
 } // namespace mbgl
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/image.hpp>
 #include <mbgl/util/tileset.hpp>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 
@@ -18,6 +20,16 @@ public:
                uint64_t correlationID,
                Tileset::RasterEncoding encoding);
 
+    // A neighbouring tile's DEM image and its position relative to the tile
+    struct Border {
+        std::shared_ptr<const PremultipliedImage> image;
+        int8_t dx;
+        int8_t dy;
+    };
+
+    // Stitches the borders into a copy of the tile's DEM image
+    void backfill(const std::shared_ptr<const PremultipliedImage>& image, int32_t dim, std::vector<Border> borders);
+
 private:
     ActorRef<RasterDEMTile> parent;
 };
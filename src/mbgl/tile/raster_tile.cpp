@@ -110,6 +110,10 @@ void RasterTile::cancel() {
     markObsolete();
 }
 
+std::size_t RasterTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 void RasterTile::markObsolete() {
     obsolete = true;
     if (pending) {
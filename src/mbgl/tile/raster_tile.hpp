@@ -38,6 +38,8 @@ public:
 
     void cancel() override;
 
+    std::size_t getMemoryUsage() const override;
+
 private:
     void markObsolete();
 
@@ -38,6 +38,10 @@ class UploadPass;
 struct TileUpdateParameters {
     Duration minimumUpdateInterval;
     bool isVolatile;
+
+    // See `LoadPriority`. Not compared, as changing it reorders a pending request rather than
+    // restarting it.
+    float loadPriority = 0.0f;
 };
 
 inline bool operator==(const TileUpdateParameters& a, const TileUpdateParameters& b) {
@@ -134,6 +138,10 @@ public:
 
     virtual void setFeatureState(const LayerFeatureStates&) {}
 
+    // Approximate memory held by the tile's render data: bucket geometry, images and the
+    // parts of shared texture atlases it uses. Used to weigh tiles against each other.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
     void dumpDebugLogs() const;
 
     // TileLoaderObserver
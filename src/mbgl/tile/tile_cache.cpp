@@ -1,12 +1,43 @@
 #include <mbgl/tile/tile_cache.hpp>
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/util/instrumentation.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace mbgl {
 
+namespace {
+
+// When over the memory budget, the largest of this many least recently used tiles is evicted
+// first, so that one heavy tile goes before several light ones of about the same age.
+constexpr std::size_t evictionCandidates = 4;
+
+} // namespace
+
+std::shared_ptr<TileCacheBudget> TileCacheBudget::getDefault() {
+    static const auto budget = std::make_shared<TileCacheBudget>();
+
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_TILE_CACHE_MAX_BYTES);
+    if (const auto* uintValue = value.getUint()) {
+        budget->setMaxBytes(static_cast<std::size_t>(*uintValue));
+    } else if (const auto* intValue = value.getInt()) {
+        budget->setMaxBytes(static_cast<std::size_t>(std::max<int64_t>(*intValue, 0)));
+    } else {
+        budget->setMaxBytes(0);
+    }
+    return budget;
+}
+
+TileCache::TileCache(const TaggedScheduler& threadPool_, size_t size_, std::shared_ptr<TileCacheBudget> budget_)
+    : threadPool(threadPool_),
+      size(size_),
+      budget(std::move(budget_)) {
+    assert(budget);
+}
+
 TileCache::~TileCache() {
     MLN_TRACE_FUNC();
 
@@ -21,20 +52,52 @@ void TileCache::setSize(size_t size_) {
     MLN_TRACE_FUNC();
 
     size = size_;
+    evict();
+
+    assert(orderedKeys.size() <= size);
+}
 
+bool TileCache::overBudget() const {
+    const std::size_t maxBytes = budget->getMaxBytes();
+    if (!maxBytes || budget->getBytes() <= maxBytes) {
+        return false;
+    }
+    // Caches under their share leave it to the others, which evict on their next add or update.
+    // Empty caches don't count, or every idle map would shrink the share of the busy ones.
+    return bytes > maxBytes / std::max<std::size_t>(budget->caches, 1);
+}
+
+void TileCache::evict() {
     while (orderedKeys.size() > size) {
-        const auto key = orderedKeys.front();
-        orderedKeys.remove(key);
-
-        auto hit = tiles.find(key);
-        if (hit != tiles.end()) {
-            auto tile = std::move(hit->second);
-            tiles.erase(hit);
-            deferredRelease(std::move(tile));
+        deferredRelease(remove(tiles.find(orderedKeys.front())));
+        evictions++;
+    }
+
+    while (!orderedKeys.empty() && overBudget()) {
+        auto victim = tiles.end();
+        std::size_t candidates = 0;
+        for (auto it = orderedKeys.begin(); it != orderedKeys.end() && candidates < evictionCandidates;
+             ++it, ++candidates) {
+            const auto entry = tiles.find(*it);
+            if (victim == tiles.end() || entry->second.bytes > victim->second.bytes) {
+                victim = entry;
+            }
         }
+        deferredRelease(remove(victim));
+        evictions++;
     }
+}
 
-    assert(orderedKeys.size() <= size);
+std::unique_ptr<Tile> TileCache::remove(Entries::iterator it) {
+    assert(it != tiles.end());
+    auto entry = std::move(tiles.extract(it).mapped());
+    orderedKeys.erase(entry.position);
+    bytes -= entry.bytes;
+    budget->bytes -= entry.bytes;
+    if (tiles.empty()) {
+        budget->caches--;
+    }
+    return std::move(entry.tile);
 }
 
 namespace {
@@ -107,33 +170,39 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile>&& tile) {
         return;
     }
 
-    const auto result = tiles.insert(std::make_pair(key, std::unique_ptr<Tile>{}));
+    const auto result = tiles.insert(std::make_pair(key, Entry{}));
+    auto& entry = result.first->second;
     if (result.second) {
         // inserted
-        result.first->second = std::move(tile);
+        entry.bytes = tile->getMemoryUsage();
+        entry.tile = std::move(tile);
+        bytes += entry.bytes;
+        budget->bytes += entry.bytes;
+        if (tiles.size() == 1) {
+            budget->caches++;
+        }
     } else {
         // already present
         // remove existing tile key to move it to the end
-        orderedKeys.remove(key);
+        orderedKeys.erase(entry.position);
         // release the newly-provided item
         deferredRelease(std::move(tile));
     }
 
     // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    entry.position = orderedKeys.insert(orderedKeys.end(), key);
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        deferredRelease(pop(orderedKeys.front()));
-    }
+    // purge oldest or heaviest tiles if necessary
+    evict();
 
     assert(orderedKeys.size() <= size);
+    MLN_ZONE_VALUE(bytes);
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
@@ -144,9 +213,11 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     const auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(tiles.extract(it).mapped());
-        orderedKeys.remove(key);
+        tile = remove(it);
         assert(tile->isRenderable());
+        hits++;
+    } else {
+        misses++;
     }
 
     return tile;
@@ -158,10 +229,19 @@ bool TileCache::has(const OverscaledTileID& key) {
 
 void TileCache::clear() {
     for (auto& item : tiles) {
-        deferredRelease(std::move(item.second));
+        deferredRelease(std::move(item.second.tile));
     }
+    if (!tiles.empty()) {
+        budget->caches--;
+    }
+    budget->bytes -= bytes;
+    bytes = 0;
     orderedKeys.clear();
     tiles.clear();
 }
 
+TileCache::Stats TileCache::getStats() const {
+    return {.hits = hits, .misses = misses, .evictions = evictions, .tiles = tiles.size(), .bytes = bytes};
+}
+
 } // namespace mbgl
@@ -13,11 +13,54 @@
 
 namespace mbgl {
 
+/// Memory budget shared by tile caches, possibly belonging to several maps.
+///
+/// Caches only ever evict their own tiles. Whenever the combined size of the caches exceeds the
+/// budget, a cache evicts until it's within its fair share, the budget split evenly between the
+/// caches holding any tiles, or the budget fits again. Caches check this when tiles are added and
+/// on every update, so the total converges as maps keep rendering.
+class TileCacheBudget {
+public:
+    /// A budget of 0 bytes means no limit
+    explicit TileCacheBudget(std::size_t maxBytes_ = 0)
+        : maxBytes(maxBytes_) {}
+
+    /// The budget shared by all maps in the process, sized by
+    /// `platform::EXPERIMENTAL_TILE_CACHE_MAX_BYTES`. The setting is re-read on every call.
+    static std::shared_ptr<TileCacheBudget> getDefault();
+
+    void setMaxBytes(std::size_t maxBytes_) { maxBytes = maxBytes_; }
+    std::size_t getMaxBytes() const { return maxBytes; }
+
+    /// Combined size of the tiles held by all attached caches
+    std::size_t getBytes() const { return bytes; }
+
+private:
+    friend class TileCache;
+
+    std::atomic<std::size_t> maxBytes;
+    std::atomic<std::size_t> bytes{0};
+    /// Attached caches which hold at least one tile
+    std::atomic<std::size_t> caches{0};
+};
+
 class TileCache {
 public:
-    TileCache(const TaggedScheduler& threadPool_, size_t size_ = 0)
-        : threadPool(threadPool_),
-          size(size_) {}
+    struct Stats {
+        /// Tiles which were requested and found
+        std::size_t hits = 0;
+        /// Tiles which were requested and not found
+        std::size_t misses = 0;
+        /// Tiles dropped to stay within the tile count or memory budget
+        std::size_t evictions = 0;
+        std::size_t tiles = 0;
+        /// Memory held by the cached tiles, as reported by `Tile::getMemoryUsage`
+        std::size_t bytes = 0;
+    };
+
+    TileCache(const TaggedScheduler& threadPool_,
+              size_t size_ = 0,
+              std::shared_ptr<TileCacheBudget> budget_ = TileCacheBudget::getDefault());
     ~TileCache();
 
     /// Change the maximum size of the cache.
@@ -35,6 +78,9 @@ public:
     bool has(const OverscaledTileID& key);
     void clear();
 
+    const TileCacheBudget& getBudget() const { return *budget; }
+    Stats getStats() const;
+
     /// Set aside a tile to be destroyed later, without blocking
     void deferredRelease(std::unique_ptr<Tile>&&);
 
@@ -42,7 +88,19 @@ public:
     void deferPendingReleases();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        std::list<OverscaledTileID>::iterator position;
+        std::size_t bytes = 0;
+    };
+    using Entries = std::map<OverscaledTileID, Entry>;
+
+    std::unique_ptr<Tile> remove(Entries::iterator);
+    /// Evict tiles until both the tile count and the memory budget are satisfied
+    void evict();
+    bool overBudget() const;
+
+    Entries tiles;
     std::list<OverscaledTileID> orderedKeys;
     TaggedScheduler threadPool;
     std::vector<std::unique_ptr<Tile>> pendingReleases;
@@ -50,6 +108,12 @@ private:
     std::mutex deferredSignalLock;
     std::condition_variable deferredSignal;
     size_t size;
+
+    const std::shared_ptr<TileCacheBudget> budget;
+    std::size_t bytes = 0;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
 };
 
 } // namespace mbgl
@@ -42,6 +42,10 @@ private:
     void loadedData(const Response&, Resource::LoadingMethod);
     void loadFromNetwork();
 
+    // Loads from the network unless the tile's load priority exceeds `maxLoadPriority`, in which
+    // case the request is deferred until it no longer does.
+    void loadFromNetworkIfNear();
+
     bool hasPendingNetworkRequest() const {
         return resource.loadingMethod == Resource::LoadingMethod::NetworkOnly && request;
     }
@@ -52,6 +56,8 @@ private:
     std::shared_ptr<FileSource> fileSource;
     std::unique_ptr<AsyncRequest> request;
     TileUpdateParameters updateParameters{.minimumUpdateInterval = Duration::zero(), .isVolatile = false};
+    const float maxLoadPriority;
+    bool deferredNetworkRequest = false;
 
     /// @brief It's possible for async requests in flight to mess with the request
     /// object at the same time as the loader's destructor. This construct is shared
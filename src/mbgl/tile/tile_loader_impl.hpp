@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/tile/tile_loader.hpp>
@@ -7,6 +8,7 @@
 #include <mbgl/util/tileset.hpp>
 
 #include <cassert>
+#include <limits>
 
 namespace mbgl {
 
@@ -14,6 +16,23 @@ inline std::exception_ptr getCantLoadTileError() {
     return std::make_exception_ptr(std::runtime_error("Can't load tile."));
 }
 
+inline float getMaxLoadPriority(MapMode mode) {
+    // Still and tile renders wait for every tile to load
+    if (mode != MapMode::Continuous) {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_TILE_REQUEST_MAX_PRIORITY);
+    if (const auto* doubleValue = value.getDouble()) {
+        return static_cast<float>(*doubleValue);
+    } else if (const auto* uintValue = value.getUint()) {
+        return static_cast<float>(*uintValue);
+    } else if (const auto* intValue = value.getInt()) {
+        return static_cast<float>(*intValue);
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
 template <typename T>
 TileLoader<T>::TileLoader(T& tile_,
                           const OverscaledTileID& id,
@@ -28,9 +47,12 @@ TileLoader<T>::TileLoader(T& tile_,
                               id.canonical.z,
                               tileset.scheme,
                               Resource::LoadingMethod::CacheOnly)),
-      fileSource(parameters.fileSource) {
+      fileSource(parameters.fileSource),
+      maxLoadPriority(getMaxLoadPriority(parameters.mode)) {
     assert(!request);
 
+    resource.loadPriority = std::make_shared<LoadPriority>();
+
     shared = std::make_shared<Shared>();
 
     if (!fileSource) {
@@ -87,13 +109,20 @@ void TileLoader<T>::setNecessity(TileNecessity newNecessity) {
 
 template <typename T>
 void TileLoader<T>::setUpdateParameters(const TileUpdateParameters& params) {
-    if (updateParameters != params) {
-        updateParameters = params;
-        if (hasPendingNetworkRequest()) {
-            // Update the pending request.
-            request.reset();
-            loadFromNetwork();
-        }
+    resource.loadPriority->set(params.loadPriority);
+
+    const bool changed = updateParameters != params;
+    updateParameters = params;
+    if (changed && hasPendingNetworkRequest()) {
+        // Update the pending request.
+        request.reset();
+        loadFromNetworkIfNear();
+    } else if (hasPendingNetworkRequest() && params.loadPriority > maxLoadPriority) {
+        // The tile moved too far from the center of the viewport, don't hold up other requests.
+        request.reset();
+        deferredNetworkRequest = true;
+    } else if (deferredNetworkRequest && !request) {
+        loadFromNetworkIfNear();
     }
 }
 
@@ -133,7 +162,7 @@ void TileLoader<T>::loadFromCache() {
                 }
 
                 if (necessity == TileNecessity::Required) {
-                    loadFromNetwork();
+                    loadFromNetworkIfNear();
                 }
                 break;
             }
@@ -144,12 +173,13 @@ void TileLoader<T>::loadFromCache() {
 template <typename T>
 void TileLoader<T>::makeRequired() {
     if (!request) {
-        loadFromNetwork();
+        loadFromNetworkIfNear();
     }
 }
 
 template <typename T>
 void TileLoader<T>::makeOptional() {
+    deferredNetworkRequest = false;
     if (hasPendingNetworkRequest()) {
         // Abort the current request, but only when we know that we're
         // specifically querying for a network resource only.
@@ -184,6 +214,14 @@ void TileLoader<T>::loadedData(const Response& res, Resource::LoadingMethod meth
     }
 }
 
+template <typename T>
+void TileLoader<T>::loadFromNetworkIfNear() {
+    deferredNetworkRequest = updateParameters.loadPriority > maxLoadPriority;
+    if (!deferredNetworkRequest) {
+        loadFromNetwork();
+    }
+}
+
 template <typename T>
 void TileLoader<T>::loadFromNetwork() {
     assert(!request);
@@ -26,7 +26,7 @@ VectorMVTTile::~VectorMVTTile() {
 
 void VectorMVTTile::setData(const std::shared_ptr<const std::string>& data_) {
     if (!obsolete) {
-        GeometryTile::setData(data_ ? std::make_unique<VectorMVTTileData>(data_) : nullptr);
+        GeometryTile::setData(data_ ? std::make_unique<VectorMVTTileData>(data_, getDataVersion()) : nullptr);
     }
 }
 
@@ -78,11 +78,12 @@ std::string VectorMVTTileLayer::getName() const {
     return layer.getName();
 }
 
-VectorMVTTileData::VectorMVTTileData(std::shared_ptr<const std::string> data_)
-    : data(std::move(data_)) {}
+VectorMVTTileData::VectorMVTTileData(std::shared_ptr<const std::string> data_, std::size_t version_)
+    : data(std::move(data_)),
+      version(version_) {}
 
 std::unique_ptr<GeometryTileData> VectorMVTTileData::clone() const {
-    return std::make_unique<VectorMVTTileData>(data);
+    return std::make_unique<VectorMVTTileData>(data, version);
 }
 
 std::unique_ptr<GeometryTileLayer> VectorMVTTileData::getLayer(const std::string& name) const {
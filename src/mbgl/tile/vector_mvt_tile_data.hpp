@@ -51,15 +51,18 @@ private:
 
 class VectorMVTTileData : public GeometryTileData {
 public:
-    VectorMVTTileData(std::shared_ptr<const std::string> data);
+    VectorMVTTileData(std::shared_ptr<const std::string> data, std::size_t version = 0);
 
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
+    std::shared_ptr<const std::string> getRawData() const override { return data; }
+    std::size_t getVersion() const override { return version; }
 
     std::vector<std::string> layerNames() const;
 
 private:
     std::shared_ptr<const std::string> data;
+    const std::size_t version;
     mutable bool parsed = false;
     mutable std::map<std::string, const protozero::data_view> layers;
 };
@@ -2,18 +2,33 @@
 
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/util/hash.hpp>
+#include <mbgl/util/tileset.hpp>
 
+#include <algorithm>
 #include <utility>
 
 namespace mbgl {
 
+namespace {
+std::size_t hashTileset(const Tileset& tileset) {
+    std::size_t seed = util::hash(static_cast<bool>(tileset.scheme),
+                                  tileset.vectorEncoding ? static_cast<int>(*tileset.vectorEncoding) : -1);
+    for (const auto& url : tileset.tiles) {
+        util::hash_combine(seed, url);
+    }
+    return seed;
+}
+} // namespace
+
 VectorTile::VectorTile(const OverscaledTileID& id_,
                        std::string sourceID_,
                        const TileParameters& parameters_,
                        const Tileset& tileset,
                        TileObserver* observer_)
     : GeometryTile(id_, std::move(sourceID_), parameters_, observer_),
-      loader(std::make_unique<TileLoader<VectorTile>>(*this, id_, parameters_, tileset)) {}
+      loader(std::make_unique<TileLoader<VectorTile>>(*this, id_, parameters_, tileset)),
+      tilesetHash(hashTileset(tileset)) {}
 
 VectorTile::~VectorTile() {}
 
@@ -30,4 +45,12 @@ void VectorTile::setMetadata(std::optional<Timestamp> modified_, std::optional<T
     expires = std::move(expires_);
 }
 
+std::size_t VectorTile::getDataVersion() const {
+    if (!modified) {
+        return 0;
+    }
+    // Zero means unknown
+    return std::max<std::size_t>(util::hash(tilesetHash, modified->time_since_epoch().count()), 1);
+}
+
 } // namespace mbgl
@@ -24,9 +24,16 @@ public:
     virtual void setData(const std::shared_ptr<const std::string>&) = 0;
 
 protected:
+    /// Version of the data last loaded, for `GeometryTileData::getVersion`. Made of the
+    /// tileset the tile is loaded from and its modification time, zero if that's not known.
+    std::size_t getDataVersion() const;
+
     // this needs to be explicitly deleted in the most-derived destructor
     // see `~VectorMVTTile`
     std::unique_ptr<TileLoader<VectorTile>> loader;
+
+private:
+    const std::size_t tilesetHash;
 };
 
 } // namespace mbgl
@@ -4,13 +4,13 @@
 #include <mapbox/geometry/box.hpp>
 #include <mbgl/math/minmax.hpp>
 
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <optional>
-#include <unordered_set>
+#include <limits>
+#include <span>
 #include <vector>
 
 namespace mbgl {
@@ -51,6 +51,9 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs) {
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+ The elements of each cell are listed in fixed-size blocks taken from
+ a single pool, so that inserting doesn't allocate for every cell and
+ queries read the entries of a cell from contiguous memory.
 */
 
 template <class T>
@@ -61,8 +64,10 @@ public:
     using BBox = mapbox::geometry::box<float>;
     using BCircle = geometry::circle<float>;
 
-    /// Set the expected number of elements per cell to avoid small re-allocations for populated cells
-    void reserve(std::size_t value) { estimatedElementsPerCell = value; }
+    /// Set the expected number of box elements per cell to reserve room for them up front
+    void reserve(std::size_t value) {
+        cellBlocks.reserve(boxCells.size() * ((value + cellBlockSize - 1) / cellBlockSize));
+    }
 
     void insert(T&& t, const BBox&);
     void insert(T&& t, const BCircle&);
@@ -70,31 +75,85 @@ public:
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T, BBox>> queryWithBoxes(const BBox&) const;
 
-    bool hitTest(const BBox&, std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const;
-    bool hitTest(const BCircle&, std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const;
+    bool hitTest(const BBox& queryBBox) const { return hitTest(queryBBox, AcceptAll{}); }
+    bool hitTest(const BCircle& queryBCircle) const { return hitTest(queryBCircle, AcceptAll{}); }
+
+    /// Only elements for which `predicate` returns true are considered
+    template <typename Predicate>
+    bool hitTest(const BBox&, const Predicate& predicate) const;
+    template <typename Predicate>
+    bool hitTest(const BCircle&, const Predicate& predicate) const;
+
+    /// Whether any of the circles hits an element, e.g. the collision circles of a line label.
+    /// Each cell is visited once, and every element in it is tested against all of the circles together.
+    bool hitTestAny(std::span<const BCircle> queryBCircles) const { return hitTestAny(queryBCircles, AcceptAll{}); }
+    template <typename Predicate>
+    bool hitTestAny(std::span<const BCircle>, const Predicate& predicate) const;
 
     bool empty() const;
 
+    /// Box elements in insertion order
+    const std::vector<std::pair<T, BBox>>& getBoxElements() const { return boxElements; }
+    /// Circle elements in insertion order
+    const std::vector<std::pair<T, BCircle>>& getCircleElements() const { return circleElements; }
+
 private:
+    struct AcceptAll {
+        bool operator()(const T&) const { return true; }
+    };
+
+    static constexpr uint32_t noBlock = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t cellBlockSize = 6;
+
+    // 32 bytes, two blocks to a cache line
+    struct CellBlock {
+        uint32_t next = noBlock;
+        uint32_t size = 0;
+        std::array<uint32_t, cellBlockSize> uids;
+    };
+
+    struct Cell {
+        uint32_t first = noBlock;
+        uint32_t last = noBlock;
+    };
+
+    struct CellRange {
+        std::size_t x1, y1, x2, y2;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
 
-    void query(const BBox&, std::function<bool(const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool(const T&, const BBox&)>) const;
+    /// Calls `resultFn` with every element colliding with the query once, in the order of the
+    /// first cell they share with it, until it returns true.
+    template <typename ResultFn>
+    void query(const BBox&, ResultFn&& resultFn) const;
+    template <typename ResultFn>
+    void query(const BCircle&, ResultFn&& resultFn) const;
+
+    template <typename Fn>
+    bool forEachInCell(const Cell&, Fn&& fn) const;
+    void addToCell(Cell&, uint32_t uid);
 
     std::size_t convertToXCellCoord(float x) const;
     std::size_t convertToYCellCoord(float y) const;
+    CellRange convertToCellRange(const BBox&) const;
 
     bool boxesCollide(const BBox&, const BBox&) const;
     bool circlesCollide(const BCircle&, const BCircle&) const;
     bool circleAndBoxCollide(const BCircle&, const BBox&) const;
 
+    // Branch-free tests of one element against `count` circles given as separate coordinate
+    // arrays, written so that the compiler vectorizes them.
+    static bool anyCircleCollidesWithBox(
+        const float* xs, const float* ys, const float* radii, std::size_t count, const BBox&);
+    static bool anyCircleCollidesWithCircle(
+        const float* xs, const float* ys, const float* radii, std::size_t count, const BCircle&);
+
     const float width;
     const float height;
 
-    std::size_t estimatedElementsPerCell = 0;
-
     const std::size_t xCellCount;
     const std::size_t yCellCount;
     const double xScale;
@@ -103,8 +162,9 @@ private:
     std::vector<std::pair<T, BBox>> boxElements;
     std::vector<std::pair<T, BCircle>> circleElements;
 
-    std::vector<std::vector<uint32_t>> boxCells;
-    std::vector<std::vector<uint32_t>> circleCells;
+    std::vector<Cell> boxCells;
+    std::vector<Cell> circleCells;
+    std::vector<CellBlock> cellBlocks;
 };
 
 template <class T>
@@ -126,18 +186,10 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
     assert(boxElements.size() < std::numeric_limits<uint32_t>::max());
     const auto uid = static_cast<uint32_t>(boxElements.size());
 
-    const auto cx1 = convertToXCellCoord(bbox.min.x);
-    const auto cy1 = convertToYCellCoord(bbox.min.y);
-    const auto cx2 = convertToXCellCoord(bbox.max.x);
-    const auto cy2 = convertToYCellCoord(bbox.max.y);
-
-    for (std::size_t x = cx1; x <= cx2; ++x) {
-        for (std::size_t y = cy1; y <= cy2; ++y) {
-            auto& cell = boxCells[xCellCount * y + x];
-            if (estimatedElementsPerCell && cell.empty()) {
-                cell.reserve(estimatedElementsPerCell);
-            }
-            cell.push_back(uid);
+    const auto cells = convertToCellRange(bbox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            addToCell(boxCells[xCellCount * y + x], uid);
         }
     }
 
@@ -149,24 +201,49 @@ void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
     assert(circleElements.size() < std::numeric_limits<uint32_t>::max());
     const auto uid = static_cast<uint32_t>(circleElements.size());
 
-    const auto cx1 = convertToXCellCoord(bcircle.center.x - bcircle.radius);
-    const auto cy1 = convertToYCellCoord(bcircle.center.y - bcircle.radius);
-    const auto cx2 = convertToXCellCoord(bcircle.center.x + bcircle.radius);
-    const auto cy2 = convertToYCellCoord(bcircle.center.y + bcircle.radius);
-
-    for (std::size_t x = cx1; x <= cx2; ++x) {
-        for (std::size_t y = cy1; y <= cy2; ++y) {
-            auto& cell = circleCells[xCellCount * y + x];
-            if (estimatedElementsPerCell && cell.empty()) {
-                cell.reserve(estimatedElementsPerCell);
-            }
-            cell.push_back(uid);
+    const auto cells = convertToCellRange(convertToBox(bcircle));
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            addToCell(circleCells[xCellCount * y + x], uid);
         }
     }
 
     circleElements.emplace_back(std::move(t), bcircle);
 }
 
+template <class T>
+void GridIndex<T>::addToCell(Cell& cell, const uint32_t uid) {
+    if (cell.last == noBlock || cellBlocks[cell.last].size == cellBlockSize) {
+        assert(cellBlocks.size() < noBlock);
+        const auto index = static_cast<uint32_t>(cellBlocks.size());
+        cellBlocks.emplace_back();
+        if (cell.last == noBlock) {
+            cell.first = index;
+        } else {
+            cellBlocks[cell.last].next = index;
+        }
+        cell.last = index;
+    }
+
+    auto& block = cellBlocks[cell.last];
+    block.uids[block.size++] = uid;
+}
+
+template <class T>
+template <typename Fn>
+bool GridIndex<T>::forEachInCell(const Cell& cell, Fn&& fn) const {
+    for (auto index = cell.first; index != noBlock;) {
+        const auto& block = cellBlocks[index];
+        for (uint32_t i = 0; i < block.size; ++i) {
+            if (fn(block.uids[i])) {
+                return true;
+            }
+        }
+        index = block.next;
+    }
+    return false;
+}
+
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
@@ -188,33 +265,93 @@ std::vector<std::pair<T, typename GridIndex<T>::BBox>> GridIndex<T>::queryWithBo
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BBox& queryBBox, std::optional<std::function<bool(const T&)>> predicate) const {
+template <typename Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, const Predicate& predicate) const {
     bool hit = false;
     query(queryBBox, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
+        hit = predicate(t);
+        return hit;
     });
     return hit;
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BCircle& queryBCircle, std::optional<std::function<bool(const T&)>> predicate) const {
+template <typename Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, const Predicate& predicate) const {
     bool hit = false;
     query(queryBCircle, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
+        hit = predicate(t);
+        return hit;
     });
     return hit;
 }
 
+template <class T>
+template <typename Predicate>
+bool GridIndex<T>::hitTestAny(std::span<const BCircle> queryBCircles, const Predicate& predicate) const {
+    // Circle coordinates, one array after the other. They fit on the stack for most line labels.
+    constexpr std::size_t stackCapacity = 32;
+    std::array<float, stackCapacity * 3> stackCoordinates;
+    std::vector<float> heapCoordinates;
+    const std::size_t capacity = util::max(queryBCircles.size(), stackCapacity);
+    float* xs = stackCoordinates.data();
+    if (capacity > stackCapacity) {
+        heapCoordinates.resize(capacity * 3);
+        xs = heapCoordinates.data();
+    }
+    float* const ys = xs + capacity;
+    float* const radii = ys + capacity;
+
+    std::size_t count = 0;
+    for (const auto& queryBCircle : queryBCircles) {
+        const BBox queryBBox = convertToBox(queryBCircle);
+        if (noIntersection(queryBBox)) {
+            continue;
+        } else if (completeIntersection(queryBBox)) {
+            // Hits everything, no use going through the cells
+            if (hitTest(queryBCircle, predicate)) {
+                return true;
+            }
+            continue;
+        }
+        xs[count] = queryBCircle.center.x;
+        ys[count] = queryBCircle.center.y;
+        radii[count] = queryBCircle.radius;
+        ++count;
+    }
+
+    // Go through the cells of each circle in turn, so that collisions with the first ones are found
+    // early. Consecutive circles overlap, so the cells the previous circle already looked up are
+    // skipped. Elements may still be tested more than once, which doesn't change the result.
+    CellRange previous{1, 1, 0, 0};
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto cells = convertToCellRange(convertToBox({{xs[i], ys[i]}, radii[i]}));
+        for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+            for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+                if (previous.x1 <= x && x <= previous.x2 && previous.y1 <= y && y <= previous.y2) {
+                    continue;
+                }
+                const std::size_t cellIndex = xCellCount * y + x;
+                if (forEachInCell(boxCells[cellIndex],
+                                  [&](const uint32_t uid) {
+                                      const auto& pair = boxElements[uid];
+                                      return anyCircleCollidesWithBox(xs, ys, radii, count, pair.second) &&
+                                             predicate(pair.first);
+                                  }) ||
+                    forEachInCell(circleCells[cellIndex], [&](const uint32_t uid) {
+                        const auto& pair = circleElements[uid];
+                        return anyCircleCollidesWithCircle(xs, ys, radii, count, pair.second) &&
+                               predicate(pair.first);
+                    })) {
+                    return true;
+                }
+            }
+        }
+        previous = cells;
+    }
+    return false;
+}
+
 template <class T>
 bool GridIndex<T>::noIntersection(const BBox& queryBBox) const {
     return queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height;
@@ -232,10 +369,8 @@ typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) co
 }
 
 template <class T>
-void GridIndex<T>::query(const BBox& queryBBox, std::function<bool(const T&, const BBox&)> resultFn) const {
-    std::unordered_set<uint32_t> seenBoxes;
-    std::unordered_set<uint32_t> seenCircles;
-
+template <typename ResultFn>
+void GridIndex<T>::query(const BBox& queryBBox, ResultFn&& resultFn) const {
     if (noIntersection(queryBBox)) {
         return;
     } else if (completeIntersection(queryBBox)) {
@@ -252,56 +387,42 @@ void GridIndex<T>::query(const BBox& queryBBox, std::function<bool(const T&, con
         return;
     }
 
-    auto cx1 = convertToXCellCoord(queryBBox.min.x);
-    auto cy1 = convertToYCellCoord(queryBBox.min.y);
-    auto cx2 = convertToXCellCoord(queryBBox.max.x);
-    auto cy2 = convertToYCellCoord(queryBBox.max.y);
-
-    std::size_t x;
-    std::size_t y;
-    std::size_t cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
+    const auto cells = convertToCellRange(queryBBox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            const std::size_t cellIndex = xCellCount * y + x;
+            // An element is only looked at in the first cell of the query it's in
+            auto firstSeenHere = [&](const BBox& bbox) {
+                return x == util::max(cells.x1, convertToXCellCoord(bbox.min.x)) &&
+                       y == util::max(cells.y1, convertToYCellCoord(bbox.min.y));
+            };
+
             // Look up other boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (!seenBoxes.contains(uid)) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (boxesCollide(queryBBox, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
+            if (forEachInCell(boxCells[cellIndex], [&](const uint32_t uid) {
+                    const auto& pair = boxElements[uid];
+                    const auto& bbox = pair.second;
+                    return firstSeenHere(bbox) && boxesCollide(queryBBox, bbox) && resultFn(pair.first, bbox);
+                })) {
+                return;
             }
 
             // Look up circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (!seenCircles.contains(uid)) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circleAndBoxCollide(bcircle, queryBBox)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
+            if (forEachInCell(circleCells[cellIndex], [&](const uint32_t uid) {
+                    const auto& pair = circleElements[uid];
+                    const auto bbox = convertToBox(pair.second);
+                    return firstSeenHere(bbox) && circleAndBoxCollide(pair.second, queryBBox) &&
+                           resultFn(pair.first, bbox);
+                })) {
+                return;
             }
         }
     }
 }
 
 template <class T>
-void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool(const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-
-    BBox queryBBox = convertToBox(queryBCircle);
+template <typename ResultFn>
+void GridIndex<T>::query(const BCircle& queryBCircle, ResultFn&& resultFn) const {
+    const BBox queryBBox = convertToBox(queryBCircle);
     if (noIntersection(queryBBox)) {
         return;
     } else if (completeIntersection(queryBBox)) {
@@ -315,47 +436,37 @@ void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool(const T
                 return;
             }
         }
+        return;
     }
 
-    auto cx1 = convertToXCellCoord(queryBCircle.center.x - queryBCircle.radius);
-    auto cy1 = convertToYCellCoord(queryBCircle.center.y - queryBCircle.radius);
-    auto cx2 = convertToXCellCoord(queryBCircle.center.x + queryBCircle.radius);
-    auto cy2 = convertToYCellCoord(queryBCircle.center.y + queryBCircle.radius);
-
-    std::size_t x;
-    std::size_t y;
-    std::size_t cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
+    const auto cells = convertToCellRange(queryBBox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            const std::size_t cellIndex = xCellCount * y + x;
+            // An element is only looked at in the first cell of the query it's in
+            auto firstSeenHere = [&](const BBox& bbox) {
+                return x == util::max(cells.x1, convertToXCellCoord(bbox.min.x)) &&
+                       y == util::max(cells.y1, convertToYCellCoord(bbox.min.y));
+            };
+
             // Look up boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (!seenBoxes.contains(uid)) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (circleAndBoxCollide(queryBCircle, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
+            if (forEachInCell(boxCells[cellIndex], [&](const uint32_t uid) {
+                    const auto& pair = boxElements[uid];
+                    const auto& bbox = pair.second;
+                    return firstSeenHere(bbox) && circleAndBoxCollide(queryBCircle, bbox) &&
+                           resultFn(pair.first, bbox);
+                })) {
+                return;
             }
 
             // Look up other circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (!seenCircles.contains(uid)) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circlesCollide(queryBCircle, bcircle)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
+            if (forEachInCell(circleCells[cellIndex], [&](const uint32_t uid) {
+                    const auto& pair = circleElements[uid];
+                    const auto bbox = convertToBox(pair.second);
+                    return firstSeenHere(bbox) && circlesCollide(queryBCircle, pair.second) &&
+                           resultFn(pair.first, bbox);
+                })) {
+                return;
             }
         }
     }
@@ -371,6 +482,14 @@ std::size_t GridIndex<T>::convertToYCellCoord(const float y) const {
     return static_cast<size_t>(util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale))));
 }
 
+template <class T>
+typename GridIndex<T>::CellRange GridIndex<T>::convertToCellRange(const BBox& bbox) const {
+    return {convertToXCellCoord(bbox.min.x),
+            convertToYCellCoord(bbox.min.y),
+            convertToXCellCoord(bbox.max.x),
+            convertToYCellCoord(bbox.max.y)};
+}
+
 template <class T>
 bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) const {
     return first.min.x <= second.max.x && first.min.y <= second.max.y && first.max.x >= second.min.x &&
@@ -408,6 +527,40 @@ bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) c
     return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
 }
 
+template <class T>
+bool GridIndex<T>::anyCircleCollidesWithBox(
+    const float* xs, const float* ys, const float* radii, const std::size_t count, const BBox& box) {
+    const float halfRectWidth = (box.max.x - box.min.x) / 2;
+    const float halfRectHeight = (box.max.y - box.min.y) / 2;
+    const float centerX = box.min.x + halfRectWidth;
+    const float centerY = box.min.y + halfRectHeight;
+
+    int collides = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        // Distance from the circle's center to the closest point of the box, clamped at zero
+        // without a branch, which would keep the loop from being vectorized.
+        const float distX = std::abs(xs[i] - centerX) - halfRectWidth;
+        const float distY = std::abs(ys[i] - centerY) - halfRectHeight;
+        const float dx = (distX + std::abs(distX)) / 2;
+        const float dy = (distY + std::abs(distY)) / 2;
+        collides |= (dx * dx + dy * dy) <= (radii[i] * radii[i]);
+    }
+    return collides != 0;
+}
+
+template <class T>
+bool GridIndex<T>::anyCircleCollidesWithCircle(
+    const float* xs, const float* ys, const float* radii, const std::size_t count, const BCircle& circle) {
+    int collides = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const float dx = circle.center.x - xs[i];
+        const float dy = circle.center.y - ys[i];
+        const float bothRadii = radii[i] + circle.radius;
+        collides |= (bothRadii * bothRadii) > (dx * dx + dy * dy);
+    }
+    return collides != 0;
+}
+
 template <class T>
 bool GridIndex<T>::empty() const {
     return boxElements.empty() && circleElements.empty();
@@ -0,0 +1,83 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+void parallelFor(Scheduler& scheduler,
+                 const std::optional<util::SimpleIdentity> tag,
+                 const std::size_t count,
+                 std::function<void(std::size_t)> fn) {
+    if (count == 0) {
+        return;
+    }
+
+    struct State {
+        std::function<void(std::size_t)> fn;
+        std::size_t count;
+        std::atomic<std::size_t> next{0};
+        std::size_t completed = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    auto state = std::make_shared<State>();
+    state->fn = std::move(fn);
+    state->count = count;
+
+    auto work = [state] {
+        for (std::size_t i = state->next++; i < state->count; i = state->next++) {
+            try {
+                state->fn(i);
+            } catch (...) {
+                std::scoped_lock lock(state->mutex);
+                if (!state->error) {
+                    state->error = std::current_exception();
+                }
+            }
+
+            std::scoped_lock lock(state->mutex);
+            if (++state->completed == state->count) {
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    // The calling thread takes a share of the work too
+    const auto helpers = std::min(count, std::max<std::size_t>(scheduler.getThreadCount(), 1)) - 1;
+    for (std::size_t i = 0; i < helpers; ++i) {
+        if (tag) {
+            scheduler.schedule(*tag, work);
+        } else {
+            scheduler.schedule(work);
+        }
+    }
+    work();
+
+    std::unique_lock lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->completed == state->count; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace
+
+void parallelFor(const std::shared_ptr<Scheduler>& scheduler, std::size_t count, std::function<void(std::size_t)> fn) {
+    parallelFor(*scheduler, std::nullopt, count, std::move(fn));
+}
+
+void parallelFor(const TaggedScheduler& scheduler, std::size_t count, std::function<void(std::size_t)> fn) {
+    parallelFor(*scheduler.get(), scheduler.tag, count, std::move(fn));
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace mbgl {
+namespace util {
+
+/**
+ * @brief Calls `fn` with every index in [0, count), on the calling thread and on as many
+ * tasks scheduled on `scheduler` as it has threads to spare.
+ *
+ * Indices are claimed one at a time by whichever thread gets there first. Tasks that start
+ * after everything has been claimed return without calling `fn`, so the calling thread only
+ * ever waits for indices which are actively being worked on, and `fn` may refer to the
+ * caller's stack. Returns once every index is done, rethrowing the first exception `fn`
+ * threw, if any.
+ */
+void parallelFor(const std::shared_ptr<Scheduler>& scheduler, std::size_t count, std::function<void(std::size_t)> fn);
+
+/// Same as above, with the helper tasks scheduled under the tag of `scheduler`
+void parallelFor(const TaggedScheduler& scheduler, std::size_t count, std::function<void(std::size_t)> fn);
+
+} // namespace util
+} // namespace mbgl
@@ -7,8 +7,140 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <cstdint>
+#include <deque>
+
 namespace mbgl {
 
+struct ThreadedSchedulerBase::Task {
+    std::function<void()> fn;
+    std::shared_ptr<Queue> queue;
+};
+
+/// Chase-Lev style deque.  Only the owning worker pushes, at the bottom.  Every
+/// worker, including the owner, takes from the top with a CAS, so tasks run in
+/// roughly FIFO order and stealing never takes a lock.
+class ThreadedSchedulerBase::StealingDeque {
+public:
+    StealingDeque() {
+        buffers.push_back(std::make_unique<Buffer>(initialCapacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    ~StealingDeque() {
+        auto* buf = buffer.load(std::memory_order_relaxed);
+        for (auto i = top.load(std::memory_order_relaxed); i < bottom.load(std::memory_order_relaxed); ++i) {
+            delete buf->get(i);
+        }
+    }
+
+    /// Must only be called from the owning worker thread
+    void push(Task* task) {
+        const auto b = bottom.load(std::memory_order_relaxed);
+        const auto t = top.load(std::memory_order_acquire);
+        auto* buf = buffer.load(std::memory_order_relaxed);
+        if (b - t >= buf->capacity) {
+            buf = grow(buf, t, b);
+        }
+        buf->put(b, task);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /// May be called from any thread
+    Task* steal() {
+        auto t = top.load(std::memory_order_acquire);
+        while (true) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+            auto* task = buffer.load(std::memory_order_acquire)->get(t);
+            if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_acquire)) {
+                return task;
+            }
+            // Lost the race, `t` now holds the updated top
+        }
+    }
+
+private:
+    static constexpr int64_t initialCapacity = 256;
+
+    struct Buffer {
+        explicit Buffer(int64_t capacity_)
+            : capacity(capacity_),
+              mask(capacity_ - 1),
+              slots(std::make_unique<std::atomic<Task*>[]>(capacity_)) {
+            assert((capacity & mask) == 0);
+        }
+
+        Task* get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Task* task) { slots[i & mask].store(task, std::memory_order_relaxed); }
+
+        const int64_t capacity;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+        buffers.push_back(std::make_unique<Buffer>(old->capacity * 2));
+        auto* buf = buffers.back().get();
+        for (auto i = t; i < b; ++i) {
+            buf->put(i, old->get(i));
+        }
+        // Thieves may still be reading the old buffer, so it is retired rather than freed
+        buffer.store(buf, std::memory_order_release);
+        return buf;
+    }
+
+    std::atomic<int64_t> top{0};
+    std::atomic<int64_t> bottom{0};
+    std::atomic<Buffer*> buffer{nullptr};
+    std::vector<std::unique_ptr<Buffer>> buffers; // owner only
+};
+
+struct ThreadedSchedulerBase::Worker {
+    ~Worker() {
+        for (auto* task : inbox) {
+            delete task;
+        }
+    }
+
+    Task* popInbox(bool wait) {
+        std::unique_lock<std::mutex> lock(inboxLock, std::defer_lock);
+        if (wait) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            return nullptr;
+        }
+        if (inbox.empty()) {
+            return nullptr;
+        }
+        auto* task = inbox.front();
+        inbox.pop_front();
+        return task;
+    }
+
+    // Tasks scheduled from the worker itself
+    StealingDeque deque;
+
+    // Tasks scheduled from threads outside the pool, spread over the workers
+    std::mutex inboxLock;
+    std::deque<Task*> inbox;
+};
+
+ThreadedSchedulerBase::ThreadedSchedulerBase(std::size_t threadCount_, SchedulerStrategy strategy_)
+    : strategy(strategy_),
+      threadCount(threadCount_) {
+    if (strategy == SchedulerStrategy::WorkStealing) {
+        assert(threadCount > 0);
+        workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+    }
+}
+
 ThreadedSchedulerBase::~ThreadedSchedulerBase() = default;
 
 void ThreadedSchedulerBase::terminate() {
@@ -34,75 +166,190 @@ std::thread ThreadedSchedulerBase::makeSchedulerThread(size_t index) {
 
         owningThreadPool.set(this);
 
-        while (true) {
-            std::unique_lock<std::mutex> conditionLock(workerMutex);
-            if (!terminated && taskCount == 0) {
-                cvAvailable.wait(conditionLock);
-            }
+        if (strategy == SchedulerStrategy::WorkStealing) {
+            runWorkStealingWorker(index);
+        } else {
+            runSharedQueueWorker();
+        }
+    });
+}
 
-            if (terminated) {
-                platform::detachThread();
-                break;
-            }
+void ThreadedSchedulerBase::runSharedQueueWorker() {
+    while (true) {
+        std::unique_lock<std::mutex> conditionLock(workerMutex);
+        if (!terminated && taskCount == 0) {
+            cvAvailable.wait(conditionLock);
+        }
 
-            // Let other threads run
-            conditionLock.unlock();
+        if (terminated) {
+            platform::detachThread();
+            break;
+        }
+
+        // Let other threads run
+        conditionLock.unlock();
+
+        std::vector<std::shared_ptr<Queue>> pending;
+        {
+            // 1. Gather buckets for us to visit this iteration
+            std::scoped_lock lock(taggedQueueLock);
+            for (const auto& [tag, queue] : taggedQueue) {
+                pending.push_back(queue);
+            }
+        }
 
-            std::vector<std::shared_ptr<Queue>> pending;
+        // 2. Visit a task from each
+        for (auto& q : pending) {
+            std::function<void()> tasklet;
             {
-                // 1. Gather buckets for us to visit this iteration
-                std::scoped_lock lock(taggedQueueLock);
-                for (const auto& [tag, queue] : taggedQueue) {
-                    pending.push_back(queue);
+                std::scoped_lock lock(q->lock);
+                if (q->queue.size()) {
+                    q->runningCount++;
+                    tasklet = std::move(q->queue.front());
+                    q->queue.pop();
                 }
+                if (!tasklet) continue;
             }
 
-            // 2. Visit a task from each
-            for (auto& q : pending) {
-                std::function<void()> tasklet;
-                {
+            assert(taskCount > 0);
+            taskCount--;
+
+            try {
+                tasklet();
+                tasklet = {}; // destroy the function and release its captures before unblocking `waitForEmpty`
+
+                if (!--q->runningCount) {
                     std::scoped_lock lock(q->lock);
-                    if (q->queue.size()) {
-                        q->runningCount++;
-                        tasklet = std::move(q->queue.front());
-                        q->queue.pop();
+                    if (q->queue.empty()) {
+                        q->cv.notify_all();
                     }
-                    if (!tasklet) continue;
+                }
+            } catch (...) {
+                std::scoped_lock lock(q->lock);
+                if (handler) {
+                    handler(std::current_exception());
                 }
 
-                assert(taskCount > 0);
-                taskCount--;
+                tasklet = {};
 
-                try {
-                    tasklet();
-                    tasklet = {}; // destroy the function and release its captures before unblocking `waitForEmpty`
+                if (!--q->runningCount && q->queue.empty()) {
+                    q->cv.notify_all();
+                }
 
-                    if (!--q->runningCount) {
-                        std::scoped_lock lock(q->lock);
-                        if (q->queue.empty()) {
-                            q->cv.notify_all();
-                        }
-                    }
-                } catch (...) {
-                    std::scoped_lock lock(q->lock);
-                    if (handler) {
-                        handler(std::current_exception());
-                    }
+                if (handler) {
+                    continue;
+                }
+                throw;
+            }
+        }
+    }
+}
 
-                    tasklet = {};
+void ThreadedSchedulerBase::runWorkStealingWorker(size_t index) {
+    currentWorker.set(workers[index].get());
 
-                    if (!--q->runningCount && q->queue.empty()) {
-                        q->cv.notify_all();
-                    }
+    while (!terminated) {
+        if (auto* task = findTask(index)) {
+            assert(taskCount > 0);
+            taskCount--;
+            runTask(*task);
+            continue;
+        }
 
-                    if (handler) {
-                        continue;
-                    }
-                    throw;
-                }
+        std::unique_lock<std::mutex> conditionLock(workerMutex);
+        if (terminated) {
+            break;
+        }
+
+        if (taskCount == 0) {
+            // `idleCount` and `taskCount` are both sequentially consistent, so either we observe the new
+            // task here or the scheduling thread observes us as idle and takes `workerMutex` to notify.
+            idleCount++;
+            if (taskCount == 0) {
+                cvAvailable.wait(conditionLock);
             }
+            idleCount--;
+        } else {
+            // A task is being published but isn't visible yet
+            conditionLock.unlock();
+            std::this_thread::yield();
         }
-    });
+    }
+
+    platform::detachThread();
+}
+
+ThreadedSchedulerBase::Task* ThreadedSchedulerBase::findTask(size_t index) {
+    auto& self = *workers[index];
+    if (auto* task = self.deque.steal()) {
+        return task;
+    }
+    if (auto* task = self.popInbox(/*wait=*/true)) {
+        return task;
+    }
+
+    // Nothing local, try the other workers starting with our neighbour
+    for (size_t i = 1; i < workers.size(); ++i) {
+        auto& victim = *workers[(index + i) % workers.size()];
+        if (auto* task = victim.deque.steal()) {
+            return task;
+        }
+        if (auto* task = victim.popInbox(/*wait=*/false)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadedSchedulerBase::runTask(Task& task) {
+    std::unique_ptr<Task> owned(&task);
+    auto q = std::move(task.queue);
+
+    std::exception_ptr error;
+    try {
+        task.fn();
+    } catch (...) {
+        if (handler) {
+            handler(std::current_exception());
+        } else {
+            error = std::current_exception();
+        }
+    }
+    owned.reset(); // destroy the function and release its captures before unblocking `waitForEmpty`
+
+    if (!--q->runningCount) {
+        std::scoped_lock lock(q->lock);
+        q->cv.notify_all();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadedSchedulerBase::scheduleWorkStealing(std::shared_ptr<Queue> q, std::function<void()>&& fn) {
+    MLN_TRACE_FUNC();
+    // Tasks never sit in `Queue::queue` in this mode, so `runningCount` covers both
+    // pending and running tasks and `waitForEmpty` needs no changes.
+    q->runningCount++;
+    auto* task = new Task{std::move(fn), std::move(q)};
+
+    // Counted before publishing so that a worker taking it right away never observes zero
+    taskCount++;
+
+    if (auto* worker = currentWorker.get()) {
+        // Scheduled from one of our own workers, keep it local
+        worker->deque.push(task);
+    } else {
+        auto& target = *workers[nextInbox++ % workers.size()];
+        std::scoped_lock lock(target.inboxLock);
+        target.inbox.push_back(task);
+    }
+
+    if (idleCount > 0) {
+        std::scoped_lock workerLock(workerMutex);
+        cvAvailable.notify_one();
+    }
 }
 
 void ThreadedSchedulerBase::schedule(std::function<void()>&& fn) {
@@ -130,6 +377,11 @@ void ThreadedSchedulerBase::schedule(const util::SimpleIdentity tag, std::functi
         MLN_ZONE_VALUE(taggedQueue.size());
     }
 
+    if (strategy == SchedulerStrategy::WorkStealing) {
+        scheduleWorkStealing(std::move(q), std::move(fn));
+        return;
+    }
+
     {
         MLN_TRACE_ZONE(push);
         std::scoped_lock lock(q->lock);
@@ -15,6 +15,14 @@
 
 namespace mbgl {
 
+/// @brief Selects how a threaded scheduler hands tasks to its worker threads
+enum class SchedulerStrategy : uint8_t {
+    /// All workers pull from shared per-tag queues, woken through a single condition variable
+    SharedQueue,
+    /// Each worker owns a deque of tasks; idle workers steal from the others without locking
+    WorkStealing,
+};
+
 class ThreadedSchedulerBase : public Scheduler {
 public:
     /// @brief Schedule a generic task not assigned to any particular owner.
@@ -28,8 +36,13 @@ public:
     void schedule(const util::SimpleIdentity tag, std::function<void()>&& fn) override;
     const util::SimpleIdentity uniqueID;
 
+    SchedulerStrategy getStrategy() const { return strategy; }
+    std::size_t getThreadCount() const override { return threadCount; }
+
 protected:
-    ThreadedSchedulerBase() = default;
+    /// @param threadCount Number of worker threads the derived class will start
+    /// @param strategy How tasks are distributed to those threads
+    ThreadedSchedulerBase(std::size_t threadCount = 0, SchedulerStrategy strategy = SchedulerStrategy::SharedQueue);
     ~ThreadedSchedulerBase() override;
 
     void terminate();
@@ -50,7 +63,7 @@ protected:
     std::mutex taggedQueueLock;
     util::ThreadLocal<ThreadedSchedulerBase> owningThreadPool;
     std::atomic<size_t> taskCount{0};
-    bool terminated{false};
+    std::atomic<bool> terminated{false};
 
     // Task queues bucketed by tag address
     struct Queue {
@@ -60,6 +73,26 @@ protected:
         std::queue<std::function<void()>> queue; /* pending task queue */
     };
     mbgl::unordered_map<util::SimpleIdentity, std::shared_ptr<Queue>> taggedQueue;
+
+    const SchedulerStrategy strategy;
+    const std::size_t threadCount;
+
+private:
+    struct Task;
+    class StealingDeque;
+    struct Worker;
+
+    void runSharedQueueWorker();
+    void runWorkStealingWorker(size_t index);
+    void scheduleWorkStealing(std::shared_ptr<Queue>, std::function<void()>&&);
+    Task* findTask(size_t index);
+    void runTask(Task&);
+
+    // Work-stealing state, only populated with `SchedulerStrategy::WorkStealing`
+    std::vector<std::unique_ptr<Worker>> workers;
+    util::ThreadLocal<Worker> currentWorker;
+    std::atomic<size_t> nextInbox{0};
+    std::atomic<size_t> idleCount{0};
 };
 
 /**
@@ -72,8 +105,9 @@ protected:
  */
 class ThreadedScheduler : public ThreadedSchedulerBase {
 public:
-    ThreadedScheduler(std::size_t n)
-        : threads(n) {
+    ThreadedScheduler(std::size_t n, SchedulerStrategy strategy_ = SchedulerStrategy::SharedQueue)
+        : ThreadedSchedulerBase(n, strategy_),
+          threads(n) {
         for (std::size_t i = 0u; i < threads.size(); ++i) {
             threads[i] = makeSchedulerThread(i);
         }
@@ -171,15 +205,15 @@ public:
 
 class ParallelScheduler : public ThreadedScheduler {
 public:
-    ParallelScheduler(std::size_t extra)
-        : ThreadedScheduler(1 + extra) {}
+    ParallelScheduler(std::size_t extra, SchedulerStrategy strategy_ = SchedulerStrategy::SharedQueue)
+        : ThreadedScheduler(1 + extra, strategy_) {}
     ~ParallelScheduler() override { invalidateWeakPtrsEarly(); }
 };
 
 class ThreadPool final : public ParallelScheduler {
 public:
-    ThreadPool()
-        : ParallelScheduler(3) {}
+    ThreadPool(SchedulerStrategy strategy_ = SchedulerStrategy::SharedQueue)
+        : ParallelScheduler(3, strategy_) {}
     ~ThreadPool() override { invalidateWeakPtrsEarly(); }
 };
 
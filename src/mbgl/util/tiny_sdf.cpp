@@ -3,6 +3,7 @@
 #include <mbgl/util/math.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 namespace util {
@@ -64,9 +65,116 @@ void edt(std::vector<double>& data,
     }
 }
 
+// Rasters up to this size in either dimension go through the float transform below. It compares
+// every pixel with every other one in its column, and then its row, which is more work than the
+// transform above but has no dependencies between neighbouring pixels, so that the compiler can
+// vectorize it across a whole row. That's faster for glyph sized rasters, but not much larger ones.
+constexpr uint32_t kMaxDirectDimension = 64;
+constexpr float kInfinity = 1e20f;
+
+// Temporary buffers of the float transform, reused from one raster to the next
+struct Buffers {
+    std::vector<float> outer;
+    std::vector<float> inner;
+    std::vector<float> columns;
+    std::vector<float> transposed;
+};
+
+// 1D squared distance transform of every column at once: the distance of each pixel is the
+// smallest of the distances of the pixels in its column plus the squared distance to them.
+// Computes four rows per pass over the input, so each input row is loaded once for all four.
+void edtColumns(const float* input, float* output, uint32_t width, uint32_t height) {
+    constexpr uint32_t kBlockRows = 4;
+    uint32_t y = 0;
+    for (; y + kBlockRows <= height; y += kBlockRows) {
+        float* __restrict out0 = output + std::size_t(y) * width;
+        float* __restrict out1 = out0 + width;
+        float* __restrict out2 = out1 + width;
+        float* __restrict out3 = out2 + width;
+        std::fill(out0, out0 + std::size_t(kBlockRows) * width, kInfinity);
+        for (uint32_t y2 = 0; y2 < height; ++y2) {
+            const float* __restrict in = input + std::size_t(y2) * width;
+            const float dy = static_cast<float>(y) - static_cast<float>(y2);
+            const float dy0 = dy * dy;
+            const float dy1 = (dy + 1) * (dy + 1);
+            const float dy2 = (dy + 2) * (dy + 2);
+            const float dy3 = (dy + 3) * (dy + 3);
+            for (uint32_t x = 0; x < width; ++x) {
+                const float value = in[x];
+                out0[x] = std::min(out0[x], value + dy0);
+                out1[x] = std::min(out1[x], value + dy1);
+                out2[x] = std::min(out2[x], value + dy2);
+                out3[x] = std::min(out3[x], value + dy3);
+            }
+        }
+    }
+    for (; y < height; ++y) {
+        float* __restrict out = output + std::size_t(y) * width;
+        std::fill(out, out + width, kInfinity);
+        for (uint32_t y2 = 0; y2 < height; ++y2) {
+            const float* __restrict in = input + std::size_t(y2) * width;
+            const float dy = static_cast<float>(y) - static_cast<float>(y2);
+            const float dy0 = dy * dy;
+            for (uint32_t x = 0; x < width; ++x) {
+                out[x] = std::min(out[x], in[x] + dy0);
+            }
+        }
+    }
+}
+
+void transpose(const float* input, float* output, uint32_t width, uint32_t height) {
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            output[std::size_t(x) * height + y] = input[std::size_t(y) * width + x];
+        }
+    }
+}
+
+// 2D squared distance transform, the rows being transformed as the columns of the transposed grid.
+// Leaves the grid transposed.
+void edtDirect(std::vector<float>& grid, uint32_t width, uint32_t height, Buffers& buffers) {
+    edtColumns(grid.data(), buffers.columns.data(), width, height);
+    transpose(buffers.columns.data(), buffers.transposed.data(), width, height);
+    edtColumns(buffers.transposed.data(), grid.data(), height, width);
+}
+
+// Gives the same results as transformRasterToSDF(), but writes the SDF into the raster itself
+void transformDirect(AlphaImage& raster, double radius, double cutoff, Buffers& buffers) {
+    const uint32_t width = raster.size.width;
+    const uint32_t height = raster.size.height;
+    const std::size_t size = std::size_t(width) * height;
+    buffers.outer.resize(size);
+    buffers.inner.resize(size);
+    buffers.columns.resize(size);
+    buffers.transposed.resize(size);
+
+    for (std::size_t i = 0; i < size; i++) {
+        const float a = static_cast<float>(raster.data[i]) / 255; // alpha value
+        const float outside = std::max(0.0f, 0.5f - a);
+        const float inside = std::max(0.0f, a - 0.5f);
+        buffers.outer[i] = a == 1.0f ? 0.0f : a == 0.0f ? kInfinity : outside * outside;
+        buffers.inner[i] = a == 1.0f ? kInfinity : a == 0.0f ? 0.0f : inside * inside;
+    }
+
+    edtDirect(buffers.outer, width, height, buffers);
+    edtDirect(buffers.inner, width, height, buffers);
+
+    const auto scale = static_cast<float>(255.0 / radius);
+    const auto offset = static_cast<float>(255.0 - 255.0 * cutoff);
+    for (uint32_t x = 0; x < width; x++) {
+        const float* outer = buffers.outer.data() + std::size_t(x) * height;
+        const float* inner = buffers.inner.data() + std::size_t(x) * height;
+        for (uint32_t y = 0; y < height; y++) {
+            const float distance = std::sqrt(outer[y]) - std::sqrt(inner[y]);
+            raster.data[std::size_t(y) * width + x] = static_cast<uint8_t>(
+                std::lround(std::clamp(offset - distance * scale, 0.0f, 255.0f)));
+        }
+    }
+}
+
 } // namespace tinysdf
 
-AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
+AlphaImage transformRasterToSDFScalar(const AlphaImage& rasterInput, double radius, double cutoff) {
     uint32_t size = rasterInput.size.width * rasterInput.size.height;
     uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
 
@@ -98,5 +206,26 @@ AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, do
     return sdf;
 }
 
+AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
+    AlphaImage sdf = rasterInput.clone();
+    AlphaImage* rasters[] = {&sdf};
+    transformRastersToSDF(rasters, radius, cutoff);
+    return sdf;
+}
+
+void transformRastersToSDF(std::span<AlphaImage* const> rasters, double radius, double cutoff) {
+    tinysdf::Buffers buffers;
+    for (AlphaImage* raster : rasters) {
+        if (!raster->valid()) {
+            continue;
+        }
+        if (std::max(raster->size.width, raster->size.height) <= tinysdf::kMaxDirectDimension) {
+            tinysdf::transformDirect(*raster, radius, cutoff, buffers);
+        } else {
+            *raster = transformRasterToSDFScalar(*raster, radius, cutoff);
+        }
+    }
+}
+
 } // namespace util
 } // namespace mbgl
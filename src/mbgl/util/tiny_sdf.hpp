@@ -2,6 +2,8 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <span>
+
 namespace mbgl {
 namespace util {
 
@@ -17,5 +19,16 @@ namespace util {
 */
 AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff);
 
+/*
+    Transforms each of the rasters into an SDF in place, with the same results as
+    transformRasterToSDF(). Glyph sized rasters go through a float transform the
+    compiler can vectorize, reusing the same temporary buffers for all of them.
+*/
+void transformRastersToSDF(std::span<AlphaImage* const> rasters, double radius, double cutoff);
+
+// The double precision Felzenszwalb/Huttenlocher transform, which transformRastersToSDF()
+// falls back to for larger rasters. Exposed for benchmarks.
+AlphaImage transformRasterToSDFScalar(const AlphaImage& rasterInput, double radius, double cutoff);
+
 } // namespace util
 } // namespace mbgl
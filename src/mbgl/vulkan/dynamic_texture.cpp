@@ -72,13 +72,9 @@ void DynamicTexture::uploadDeferredImages() {
     texturesToBlit.clear();
 }
 
-bool DynamicTexture::removeTexture(const gfx::TextureHandle& texHandle) {
-    if (gfx::DynamicTexture::removeTexture(texHandle)) {
-        std::scoped_lock lock(mutex);
-        texturesToBlit.erase(texHandle);
-        return true;
-    }
-    return false;
+void DynamicTexture::discardUpload(const gfx::TextureHandle& texHandle) {
+    std::scoped_lock lock(mutex);
+    texturesToBlit.erase(texHandle);
 }
 #else
 
@@ -150,13 +146,9 @@ void DynamicTexture::uploadDeferredImages() {
     textureBuffersToUpload.clear();
 }
 
-bool DynamicTexture::removeTexture(const gfx::TextureHandle& texHandle) {
-    if (gfx::DynamicTexture::removeTexture(texHandle)) {
-        std::scoped_lock lock(mutex);
-        textureBuffersToUpload.erase(texHandle);
-        return true;
-    }
-    return false;
+void DynamicTexture::discardUpload(const gfx::TextureHandle& texHandle) {
+    std::scoped_lock lock(mutex);
+    textureBuffersToUpload.erase(texHandle);
 }
 #endif
 
@@ -4,11 +4,13 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -235,6 +237,49 @@ TEST(Actor, OrderedMailbox) {
     endedFuture.wait();
 }
 
+TEST(Actor, OrderedMailboxMultipleSenders) {
+    // Messages from each sending thread are processed in the order they were sent.
+
+    constexpr int senders = 4;
+    constexpr int messages = 10000;
+
+    struct TestActor {
+        std::array<int, senders> last{};
+        int received = 0;
+        std::promise<void> promise;
+
+        TestActor(ActorRef<TestActor>, std::promise<void> promise_)
+            : promise(std::move(promise_)) {}
+
+        void receive(int sender, int i) {
+            EXPECT_EQ(i, last[sender] + 1);
+            last[sender] = i;
+            if (++received == senders * messages) {
+                promise.set_value();
+            }
+        }
+    };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<TestActor> test(Scheduler::GetBackground(), std::move(endedPromise));
+    auto ref = test.self();
+
+    std::vector<std::thread> threads;
+    for (int sender = 0; sender < senders; ++sender) {
+        threads.emplace_back([ref, sender] {
+            for (int i = 1; i <= messages; ++i) {
+                ref.invoke(&TestActor::receive, sender, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(std::future_status::ready, endedFuture.wait_for(std::chrono::seconds(10)));
+}
+
 TEST(Actor, NonConcurrentMailbox) {
     // An individual actor is never itself concurrent.
 
@@ -388,6 +388,35 @@ TEST(Annotations, QueryRenderedFeatures) {
     EXPECT_EQ(features2[0].id, uint64_t(1));
 }
 
+TEST(Annotations, UpdateSymbolAnnotationInOtherTile) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    test.map.jumpTo(CameraOptions().withCenter(LatLng{0, 0}).withZoom(2.0));
+    AnnotationID west = test.map.addAnnotation(SymbolAnnotation{Point<double>{-20, 10}, "default_marker"});
+    AnnotationID east = test.map.addAnnotation(SymbolAnnotation{Point<double>{20, 10}, "default_marker"});
+
+    test.frontend.render(test.map);
+
+    // Only the tiles of the western marker are regenerated
+    test.map.updateAnnotation(west, SymbolAnnotation{Point<double>{-20, -10}, "default_marker"});
+    test.frontend.render(test.map);
+
+    const auto query = [&](const LatLng& latLng) {
+        return test.frontend.getRenderer()->queryRenderedFeatures(test.map.pixelForLatLng(latLng));
+    };
+    EXPECT_TRUE(query({10, -20}).empty());
+
+    auto features = query({-10, -20});
+    ASSERT_EQ(1u, features.size());
+    EXPECT_EQ(features[0].id, west);
+
+    features = query({10, 20});
+    ASSERT_EQ(1u, features.size());
+    EXPECT_EQ(features[0].id, east);
+}
+
 TEST(Annotations, QueryFractionalZoomLevels) {
     AnnotationTest test;
 
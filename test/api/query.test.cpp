@@ -1,13 +1,17 @@
 #include <mbgl/test/map_adapter.hpp>
 
 #include <mbgl/map/map_options.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/test/scoped_setting.hpp>
 #include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_map_observer.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
@@ -15,6 +19,8 @@
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace mbgl::style::expression;
@@ -24,7 +30,14 @@ namespace {
 
 class QueryTest {
 public:
-    QueryTest() {
+    QueryTest(bool crossSourceCollisions = true)
+        : map{frontend,
+              MapObserver::nullObserver(),
+              fileSource,
+              MapOptions()
+                  .withMapMode(MapMode::Static)
+                  .withSize(frontend.getSize())
+                  .withCrossSourceCollisions(crossSourceCollisions)} {
         map.getStyle().loadJSON(util::read_file("test/fixtures/api/query_style.json"));
         map.getStyle().addImage(std::make_unique<style::Image>(
             "test-icon", decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0f));
@@ -35,10 +48,7 @@ public:
     util::RunLoop loop;
     std::shared_ptr<StubFileSource> fileSource = std::make_shared<StubFileSource>();
     HeadlessFrontend frontend{1};
-    MapAdapter map{frontend,
-                   MapObserver::nullObserver(),
-                   fileSource,
-                   MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize())};
+    MapAdapter map;
 };
 
 std::vector<Feature> getTopClusterFeature(QueryTest& test) {
@@ -95,6 +105,104 @@ TEST(Query, QueryRenderedFeatures) {
     EXPECT_EQ(features2.size(), 0u);
 }
 
+TEST(Query, QueryRenderedFeaturesParallelPlacement) {
+    // Without cross source collisions every source is a collision group of its own, and its
+    // layer is placed concurrently with the others.
+    auto querySources = [](bool parallel) {
+        test::ScopedSetting parallelPlacement(platform::EXPERIMENTAL_PARALLEL_PLACEMENT, parallel);
+        QueryTest test(false);
+
+        const auto point = test.map.pixelForLatLng({0, 0});
+        std::vector<std::string> sources;
+        for (const auto& feature : test.frontend.getRenderer()->queryRenderedFeatures(point)) {
+            sources.push_back(feature.source);
+        }
+        return sources;
+    };
+
+    const auto serial = querySources(false);
+    EXPECT_EQ(serial.size(), 4u);
+    EXPECT_EQ(serial, querySources(true));
+}
+
+TEST(Query, QueryRenderedFeaturesIncrementalPlacement) {
+    // Small pans reuse the previous placement, other camera changes place everything again
+    const std::vector<CameraOptions> cameras{CameraOptions().withCenter(LatLng{0, 0}).withZoom(4.0),
+                                             CameraOptions().withCenter(LatLng{0.3, 0.2}),
+                                             CameraOptions().withCenter(LatLng{0.5, -0.1}),
+                                             CameraOptions().withZoom(4.3),
+                                             CameraOptions().withCenter(LatLng{0.2, 0.1}),
+                                             CameraOptions().withBearing(20.0),
+                                             CameraOptions().withCenter(LatLng{-0.2, 0.3}),
+                                             CameraOptions().withPitch(30.0),
+                                             CameraOptions().withPitch(0.0).withBearing(0.0),
+                                             CameraOptions().withCenter(LatLng{0, 0})};
+
+    // The symbols placed in each cell of a grid over the screen, after each camera change
+    auto placeSymbols = [&](bool incremental) {
+        test::ScopedSetting incrementalPlacement(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT, incremental);
+
+        util::RunLoop loop;
+        auto fileSource = std::make_shared<StubFileSource>();
+        HeadlessFrontend frontend{1};
+        StubMapObserver observer;
+        MapAdapter map{frontend,
+                       observer,
+                       fileSource,
+                       MapOptions().withMapMode(MapMode::Continuous).withSize(frontend.getSize())};
+        map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+        // Without fading, every frame is placed and shows the final opacities
+        map.getStyle().setTransitionOptions(TransitionOptions(std::nullopt, std::nullopt, false));
+        map.getStyle().addImage(std::make_unique<style::Image>(
+            "test-icon", decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0f));
+
+        // Close enough together for most of them to collide
+        mapbox::feature::feature_collection<double> points;
+        for (int x = -20; x <= 20; ++x) {
+            for (int y = -20; y <= 20; ++y) {
+                mapbox::feature::feature<double> point{mapbox::geometry::point<double>(x * 0.5, y * 0.5)};
+                point.id = static_cast<uint64_t>(points.size());
+                points.push_back(std::move(point));
+            }
+        }
+        auto source = std::make_unique<GeoJSONSource>("points");
+        source->setGeoJSON(mapbox::geojson::geojson{points});
+        map.getStyle().addSource(std::move(source));
+        auto layer = std::make_unique<SymbolLayer>("symbols", "points");
+        layer->setIconImage({"test-icon"});
+        map.getStyle().addLayer(std::move(layer));
+
+        observer.didBecomeIdleCallback = [&] {
+            loop.stop();
+        };
+
+        constexpr double cellSize = 32;
+        const auto size = frontend.getSize();
+        std::vector<std::vector<uint64_t>> placed;
+        for (const auto& camera : cameras) {
+            map.jumpTo(camera);
+            loop.run();
+
+            for (double y = 0; y < size.height; y += cellSize) {
+                for (double x = 0; x < size.width; x += cellSize) {
+                    std::vector<uint64_t> ids;
+                    for (const auto& feature : frontend.getRenderer()->queryRenderedFeatures(
+                             ScreenBox{{x, y}, {x + cellSize, y + cellSize}}, {{{"symbols"}}, {}})) {
+                        ids.push_back(feature.id.get<uint64_t>());
+                    }
+                    std::ranges::sort(ids);
+                    placed.push_back(std::move(ids));
+                }
+            }
+        }
+        return placed;
+    };
+
+    const auto full = placeSymbols(false);
+    EXPECT_TRUE(std::ranges::any_of(full, [](const auto& ids) { return !ids.empty(); }));
+    EXPECT_EQ(full, placeSymbols(true));
+}
+
 TEST(Query, QueryRenderedFeaturesFilterLayer) {
     QueryTest test;
 
@@ -16,6 +16,8 @@
 
 #include <mbgl/map/mode.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 
 bool operator==(const SegmentBase& lhs, const SegmentBase& rhs) {
@@ -136,6 +138,43 @@ TEST(Buckets, LineBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, Clone) {
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    FillBucket::PossiblyEvaluatedLayoutProperties layout;
+
+    gl::Context context{backend};
+    FillBucket bucket{layout, {}, 5.0f, 1};
+
+    GeometryCollection polygon{{{0, 0}, {0, 1}, {1, 1}}};
+    bucket.addFeature(StubGeometryTileFeature{{}, FeatureType::Polygon, polygon, properties},
+                      polygon,
+                      {},
+                      PatternLayerMap(),
+                      0,
+                      CanonicalTileID(0, 0, 0));
+
+    auto commandEncoder = context.createCommandEncoder();
+    auto uploadPass = commandEncoder->createUploadPass("upload", backend.getDefaultRenderable());
+    bucket.upload(*uploadPass);
+    ASSERT_FALSE(bucket.needsUpload());
+
+    const auto clone = std::static_pointer_cast<FillBucket>(bucket.clone());
+    ASSERT_TRUE(clone);
+    EXPECT_FALSE(bucket.getID() == clone->getID());
+    EXPECT_TRUE(clone->needsUpload());
+    EXPECT_EQ(bucket.getMemoryUsage(), clone->getMemoryUsage());
+
+    // The copy has its own vertex data, which isn't uploaded yet
+    EXPECT_NE(bucket.sharedVertices, clone->sharedVertices);
+    ASSERT_EQ(bucket.vertices.elements(), clone->vertices.elements());
+    EXPECT_EQ(0, std::memcmp(bucket.vertices.data(), clone->vertices.data(), bucket.vertices.bytes()));
+    EXPECT_EQ(nullptr, clone->vertices.getBuffer());
+    EXPECT_EQ(bucket.triangles.vector(), clone->triangles.vector());
+    EXPECT_EQ(bucket.triangleSegments, clone->triangleSegments);
+    EXPECT_EQ(bucket.basicLineSegments, clone->basicLineSegments);
+}
+
 TEST(Buckets, SymbolBucket) {
     gl::HeadlessBackend backend({512, 256});
     gfx::BackendScope scope{backend};
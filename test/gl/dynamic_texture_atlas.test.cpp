@@ -0,0 +1,145 @@
+#if MLN_RENDER_BACKEND_OPENGL
+
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gfx/dynamic_texture_atlas.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+
+#include <numeric>
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+GlyphMap makeGlyphs(const std::vector<char16_t>& chars) {
+    Glyphs glyphs;
+    for (const auto ch : chars) {
+        auto glyph = makeMutable<Glyph>();
+        glyph->id = ch;
+        glyph->bitmap = AlphaImage({12, 16});
+        glyph->bitmap.fill(static_cast<uint8_t>(ch));
+        glyphs.emplace(ch, Immutable<Glyph>(std::move(glyph)));
+    }
+    return {{FontStackHasher()({"Test"}), std::move(glyphs)}};
+}
+
+std::vector<char16_t> glyphRange(char16_t first, std::size_t count) {
+    std::vector<char16_t> chars(count);
+    std::iota(chars.begin(), chars.end(), first);
+    return chars;
+}
+
+} // namespace
+
+TEST(DynamicTextureAtlas, SharedGlyphs) {
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+    gfx::DynamicTextureAtlas atlas(context);
+
+    const auto first = atlas.uploadGlyphs(makeGlyphs({u'a', u'b', u'c'}));
+    const auto second = atlas.uploadGlyphs(makeGlyphs({u'b', u'c', u'd'}));
+    ASSERT_TRUE(first.dynamicTexture);
+    EXPECT_EQ(first.dynamicTexture, second.dynamicTexture);
+
+    // Glyphs in both tiles are stored once, at the same place
+    const auto fontStack = FontStackHasher()({"Test"});
+    EXPECT_EQ(first.glyphPositions.at(fontStack).at(u'b').rect, second.glyphPositions.at(fontStack).at(u'b').rect);
+    EXPECT_EQ(first.glyphPositions.at(fontStack).at(u'c').rect, second.glyphPositions.at(fontStack).at(u'c').rect);
+    EXPECT_NE(first.glyphPositions.at(fontStack).at(u'a').rect, second.glyphPositions.at(fontStack).at(u'd').rect);
+
+    auto stats = atlas.getStats();
+    EXPECT_EQ(1u, stats.textures);
+    EXPECT_EQ(4u, stats.images);
+    EXPECT_EQ(4u * (12 + 4) * (16 + 4), stats.usedArea);
+    EXPECT_LE(stats.usedArea, stats.slotArea);
+    // All on one shelf, as high as the padded glyphs
+    EXPECT_EQ(512u * (16 + 4), stats.shelfArea);
+    EXPECT_EQ(512u * 512u, stats.textureArea);
+
+    // Removing one tile keeps the glyphs the other one still uses
+    atlas.removeTextures(first.textureHandles, first.dynamicTexture);
+    stats = atlas.getStats();
+    EXPECT_EQ(1u, stats.textures);
+    EXPECT_EQ(3u, stats.images);
+
+    atlas.removeTextures(second.textureHandles, second.dynamicTexture);
+    EXPECT_TRUE(second.dynamicTexture->isEmpty());
+    EXPECT_EQ(0u, atlas.getStats().textures);
+
+    // Tiles which got the texture before it was dropped can't add images to it anymore
+    EXPECT_FALSE(second.dynamicTexture->addImage(AlphaImage({12, 16}), 1));
+    const auto third = atlas.uploadGlyphs(makeGlyphs({u'a'}));
+    EXPECT_NE(second.dynamicTexture, third.dynamicTexture);
+    EXPECT_EQ(1u, atlas.getStats().textures);
+}
+
+TEST(DynamicTextureAtlas, ConcurrentUploads) {
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+    gfx::DynamicTextureAtlas atlas(context);
+
+    // Tiles which don't find a texture at the same time share the one created for the first of them
+    std::vector<gfx::GlyphAtlas> glyphAtlases(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < glyphAtlases.size(); ++i) {
+        threads.emplace_back([&, i] {
+            glyphAtlases[i] = atlas.uploadGlyphs(makeGlyphs(glyphRange(static_cast<char16_t>(1 + i * 10), 10)));
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(1u, atlas.getStats().textures);
+    EXPECT_EQ(80u, atlas.getStats().images);
+    for (const auto& glyphAtlas : glyphAtlases) {
+        EXPECT_EQ(glyphAtlases.front().dynamicTexture, glyphAtlas.dynamicTexture);
+    }
+}
+
+TEST(DynamicTextureAtlas, Compaction) {
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+    gfx::DynamicTextureAtlas atlas(context);
+
+    // 800 padded glyphs fill a texture, the second tile doesn't fit in what's left and gets its own
+    auto first = std::make_optional(atlas.uploadGlyphs(makeGlyphs(glyphRange(1, 700))));
+    const auto second = atlas.uploadGlyphs(makeGlyphs(glyphRange(701, 300)));
+    auto third = std::make_optional(atlas.uploadGlyphs(makeGlyphs(glyphRange(1001, 20))));
+    ASSERT_NE(first->dynamicTexture, second.dynamicTexture);
+    ASSERT_EQ(first->dynamicTexture, third->dynamicTexture);
+    const auto fragmented = first->dynamicTexture;
+
+    // Not fragmented yet
+    atlas.compact(0.5);
+    EXPECT_EQ(0u, atlas.getStats().retiredTextures);
+
+    atlas.removeTextures(first->textureHandles, first->dynamicTexture);
+    first.reset();
+    atlas.compact(1.0);
+    EXPECT_EQ(0u, atlas.getStats().retiredTextures);
+    atlas.compact(0.5);
+    EXPECT_TRUE(fragmented->isRetired());
+    EXPECT_FALSE(second.dynamicTexture->isRetired());
+    EXPECT_EQ(1u, atlas.getStats().retiredTextures);
+
+    // New tiles go elsewhere, even with glyphs in the retired texture
+    const auto fourth = atlas.uploadGlyphs(makeGlyphs(glyphRange(1001, 20)));
+    EXPECT_EQ(second.dynamicTexture, fourth.dynamicTexture);
+
+    // Freed once the last tile using it is gone
+    atlas.removeTextures(third->textureHandles, third->dynamicTexture);
+    third.reset();
+    EXPECT_EQ(1u, atlas.getStats().textures);
+    atlas.compact(0.5);
+    EXPECT_EQ(1, context.renderingStats().numCompactedAtlasTextures);
+    EXPECT_EQ(512u * 512u * fragmented->getTexture()->getPixelStride(), context.renderingStats().atlasCompactionBytes);
+}
+
+#endif
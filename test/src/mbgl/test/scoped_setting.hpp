@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mbgl/platform/settings.hpp>
+
+#include <string>
+#include <utility>
+
+namespace mbgl {
+namespace test {
+
+/**
+ * Sets a platform setting for as long as it's alive, and puts back whatever value the
+ * setting had before when it goes out of scope, so a failing test can't leak it.
+ */
+class ScopedSetting {
+public:
+    ScopedSetting(std::string key_, mapbox::base::Value value)
+        : key(std::move(key_)),
+          previous(platform::Settings::getInstance().get(key)) {
+        platform::Settings::getInstance().set(key, std::move(value));
+    }
+
+    ~ScopedSetting() { platform::Settings::getInstance().set(key, std::move(previous)); }
+
+    ScopedSetting(const ScopedSetting&) = delete;
+    ScopedSetting& operator=(const ScopedSetting&) = delete;
+
+private:
+    const std::string key;
+    mapbox::base::Value previous;
+};
+
+} // namespace test
+} // namespace mbgl
@@ -1,5 +1,7 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/test/scoped_setting.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/exception.hpp>
@@ -7,6 +9,10 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/storage/resource_options.hpp>
 
+#if TEST_HAS_CURL
+#include <curl/curl.h>
+#endif
+
 using namespace mbgl;
 
 TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Cancel)) {
@@ -228,3 +234,59 @@ TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Load)) {
 
     loop.run();
 }
+
+#if TEST_HAS_CURL
+TEST(HTTPFileSource, TEST_REQUIRES_SERVER(HTTP2)) {
+    if (!(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        GTEST_SKIP() << "libcurl was built without HTTP/2 support";
+    }
+
+    // The server on port 3002 only speaks cleartext HTTP/2
+    test::ScopedSetting priorKnowledge(platform::EXPERIMENTAL_HTTP2_PRIOR_KNOWLEDGE, true);
+
+    util::RunLoop loop;
+    HTTPFileSource fs(ResourceOptions::Default(), ClientOptions());
+
+    auto req = fs.request({Resource::Unknown, "http://127.0.0.1:3002/test"}, [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+        ASSERT_TRUE(res.timing);
+        EXPECT_EQ(2, res.timing->httpVersion);
+        EXPECT_EQ(1u, res.timing->newConnections);
+        EXPECT_LE(res.timing->connect, res.timing->firstByte);
+        EXPECT_LE(res.timing->firstByte, res.timing->total);
+        // Cleartext, the skipped TLS handshake is reported as done along with the connection
+        EXPECT_EQ(res.timing->connect, res.timing->tlsHandshake);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(HTTPFileSource, TEST_REQUIRES_SERVER(ConnectionReuse)) {
+    util::RunLoop loop;
+    HTTPFileSource fs(ResourceOptions::Default(), ClientOptions());
+
+    std::vector<uint32_t> newConnections;
+    std::unique_ptr<AsyncRequest> req;
+    std::function<void()> request = [&] {
+        req = fs.request({Resource::Unknown, "http://127.0.0.1:3000/test"}, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.timing);
+            EXPECT_EQ(1, res.timing->httpVersion);
+            newConnections.push_back(res.timing->newConnections);
+            if (newConnections.size() < 3) {
+                request();
+            } else {
+                loop.stop();
+            }
+        });
+    };
+
+    request();
+    loop.run();
+
+    EXPECT_EQ(std::vector<uint32_t>({1, 0, 0}), newConnections);
+}
+#endif // TEST_HAS_CURL
@@ -1,6 +1,7 @@
 #include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/storage/sqlite3.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/run_loop.hpp>
 
@@ -124,3 +125,37 @@ TEST(MBTilesFileSource, NonExistentTile) {
 
     loop.run();
 }
+
+// Tiles read through the memory mapped database are the ones stored in it
+TEST(MBTilesFileSource, TilesMatchDatabase) {
+    util::RunLoop loop;
+
+    MBTilesFileSource mbtiles(ResourceOptions::Default(), ClientOptions());
+    const auto url = toAbsoluteURL("geography-class-png.mbtiles?file={z}/{x}/{y}.png");
+    const auto path = (std::filesystem::current_path() / "test/fixtures/storage/mbtiles/geography-class-png.mbtiles")
+                          .string();
+
+    auto db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt(db, "SELECT zoom_level, tile_column, tile_row, tile_data FROM tiles");
+
+    int tiles = 0;
+    for (mapbox::sqlite::Query q(stmt); q.run(); ++tiles) {
+        const auto z = q.get<int>(0);
+        const auto x = q.get<int>(1);
+        // Rows are counted from the bottom
+        const auto y = (1 << z) - 1 - q.get<int>(2);
+        const auto expected = q.get<std::string>(3);
+
+        std::unique_ptr<AsyncRequest> req = mbtiles.request(
+            Resource::tile(url, 1.0, x, y, static_cast<int8_t>(z), Tileset::Scheme::XYZ), [&](Response res) {
+                req.reset();
+                loop.stop();
+                EXPECT_EQ(nullptr, res.error);
+                ASSERT_TRUE(res.data.get());
+                EXPECT_EQ(expected, *res.data) << "tile " << z << "/" << x << "/" << y;
+            });
+
+        loop.run();
+    }
+    EXPECT_EQ(5, tiles);
+}
@@ -1,6 +1,8 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/fixture_log_observer.hpp>
+#include <mbgl/test/scoped_setting.hpp>
 #include <mbgl/test/sqlite3_test_fs.hpp>
+#include <mbgl/platform/settings.hpp>
 
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
@@ -396,6 +398,103 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, PutTileCompressed) {
+    std::string data;
+    for (int i = 0; i < 1000; ++i) {
+        data += "compressible";
+    }
+
+    // zstd falls back to zlib when it isn't available, either way the tile reads back
+    for (const char* codec : {"zlib", "zstd"}) {
+        SCOPED_TRACE(codec);
+        test::ScopedSetting compression(platform::EXPERIMENTAL_OFFLINE_DATABASE_COMPRESSION, std::string(codec));
+        OfflineDatabase db(":memory:", fixture::tileServerOptions);
+
+        Resource resource{Resource::Tile, "http://example.com/"};
+        resource.tileData = Resource::TileData{
+            .urlTemplate = "http://example.com/", .pixelRatio = 1, .x = 0, .y = 0, .z = 0};
+        Response response;
+        response.data = std::make_shared<std::string>(data);
+
+        auto putResult = db.put(resource, response);
+        EXPECT_TRUE(putResult.first);
+        EXPECT_GT(data.size(), putResult.second);
+
+        auto getResult = db.get(resource);
+        ASSERT_TRUE(getResult && getResult->data);
+        EXPECT_EQ(data, *getResult->data);
+    }
+}
+
+TEST(OfflineDatabase, BatchedWrites) {
+    using namespace std::chrono_literals;
+
+    FixtureLog log;
+    OfflineDatabase db(":memory:", fixture::tileServerOptions);
+    db.setWriteBatchSize(3);
+
+    auto tile = [](int32_t x) {
+        return Resource::tile("http://example.com/{z}-{x}-{y}", 1.0, x, 0, 1, Tileset::Scheme::XYZ);
+    };
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+
+    // Pending writes are read back before they're written
+    EXPECT_EQ(std::make_pair(false, uint64_t(0)), db.put(tile(0), response));
+    db.put(tile(1), response);
+    EXPECT_TRUE(db.hasPendingWrites());
+    ASSERT_TRUE(db.get(tile(0)));
+    EXPECT_EQ("first", *db.get(tile(0))->data);
+    EXPECT_FALSE(db.get(tile(2)));
+
+    // The last of them is returned
+    response.data = std::make_shared<std::string>("second");
+    db.put(tile(0), response);
+    EXPECT_FALSE(db.hasPendingWrites()) << "A full batch is written right away";
+
+    ASSERT_TRUE(db.get(tile(0)));
+    EXPECT_EQ("second", *db.get(tile(0))->data);
+    EXPECT_TRUE(db.hasPendingWrites()) << "Access times are batched as well";
+
+    db.put(tile(2), response);
+    db.flush();
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    db.setWriteBatchSize(0);
+    for (int32_t x : {0, 1, 2}) {
+        auto result = db.get(tile(x));
+        ASSERT_TRUE(result && result->data);
+        EXPECT_EQ(x == 1 ? "first" : "second", *result->data);
+    }
+
+    // 304 responses only refresh the expiration, of pending and stored entries alike
+    db.setWriteBatchSize(3);
+    response.data = std::make_shared<std::string>("third");
+    db.put(tile(3), response);
+    Response notModified;
+    notModified.notModified = true;
+    notModified.mustRevalidate = true;
+    notModified.expires = util::now() + 1h;
+    db.put(tile(3), notModified);
+    db.put(tile(0), notModified);
+    EXPECT_TRUE(db.hasPendingWrites());
+
+    for (const bool pending : {true, false}) {
+        SCOPED_TRACE(pending);
+        for (int32_t x : {3, 0}) {
+            auto result = db.get(tile(x));
+            ASSERT_TRUE(result && result->data);
+            EXPECT_FALSE(result->notModified);
+            EXPECT_EQ(x == 3 ? "third" : "second", *result->data);
+            EXPECT_EQ(notModified.expires, result->expires);
+            EXPECT_TRUE(result->mustRevalidate);
+        }
+        db.flush();
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutResourceNoContent) {
     FixtureLog log;
     OfflineDatabase db(":memory:", fixture::tileServerOptions);
@@ -11,6 +11,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 #ifdef WIN32
@@ -603,6 +605,46 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(LowHighPriorityRequestsMany)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(LoadPriority)) {
+    util::RunLoop loop;
+    std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>(ResourceOptions::Default(), ClientOptions());
+    const std::size_t NUM_REQUESTS = 6;
+
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+    fs->setProperty(MAX_CONCURRENT_REQUESTS_KEY, 1u);
+    fs->pause();
+
+    std::vector<std::shared_ptr<LoadPriority>> priorities;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    std::vector<float> responded;
+
+    for (std::size_t i = 0; i < NUM_REQUESTS; ++i) {
+        Resource resource{Resource::Unknown, "http://127.0.0.1:3000/delayed?request=" + util::toString(i)};
+        resource.loadPriority = std::make_shared<LoadPriority>(static_cast<float>(i));
+        priorities.push_back(resource.loadPriority);
+        requests.push_back(fs->request(resource, [&, i](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            responded.push_back(priorities[i]->get());
+            if (responded.size() == NUM_REQUESTS) {
+                loop.stop();
+            }
+        }));
+    }
+
+    fs->resume();
+    NetworkStatus::Set(NetworkStatus::Status::Online);
+
+    // While the first request is in flight, the least urgent request becomes the most urgent one
+    util::Timer reprioritize;
+    reprioritize.start(Milliseconds(50), Duration::zero(), [&] { priorities.back()->set(-1.0f); });
+
+    loop.run();
+
+    // Whichever request went first, the others were made in order of their current priority
+    ASSERT_EQ(NUM_REQUESTS, responded.size());
+    EXPECT_TRUE(std::is_sorted(responded.begin() + 1, responded.end()));
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(MaximumConcurrentRequests)) {
     util::RunLoop loop;
     std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>(ResourceOptions::Default(), ClientOptions());
@@ -1,10 +1,26 @@
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/storage/file_source_manager.hpp>
+#include <mbgl/storage/pmtiles_directory_cache.hpp>
 #include <mbgl/storage/pmtiles_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/client_options.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <pmtiles.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
+#include <thread>
 
 #include <climits>
 #include <gtest/gtest.h>
@@ -16,6 +32,137 @@ std::string toAbsoluteURL(const std::string &fileName) {
     return std::string(mbgl::util::PMTILES_PROTOCOL) + std::string(mbgl::util::FILE_PROTOCOL) + path.string();
 }
 
+using Range = std::pair<uint64_t, uint64_t>;
+
+// Uncompressed archive of the four tiles at zoom 1, each listed in a leaf directory of its own
+// and holding `prefix` followed by its tile ID. With `zlibTiles`, the tiles are zlib streams in an
+// archive marked as gzip compressed, as written by some tools.
+struct LeafArchive {
+    std::string data;
+    std::vector<Range> leaves;
+
+    explicit LeafArchive(const std::string& prefix = "tile", bool zlibTiles = false) {
+        std::string leafData;
+        std::string tileData;
+        std::vector<pmtiles::entryv3> rootEntries;
+        for (uint64_t tileID = 1; tileID <= 4; ++tileID) {
+            const auto tile = zlibTiles ? mbgl::util::compress(prefix + std::to_string(tileID))
+                                        : prefix + std::to_string(tileID);
+            const auto leaf = pmtiles::serialize_directory(
+                {pmtiles::entryv3(tileID, tileData.size(), static_cast<uint32_t>(tile.size()), 1)});
+            rootEntries.emplace_back(tileID, leafData.size(), static_cast<uint32_t>(leaf.size()), 0);
+            leaves.emplace_back(leafData.size(), leaf.size());
+            leafData += leaf;
+            tileData += tile;
+        }
+        const auto root = pmtiles::serialize_directory(rootEntries);
+
+        pmtiles::headerv3 header{};
+        header.root_dir_offset = 127;
+        header.root_dir_bytes = root.size();
+        header.leaf_dirs_offset = header.root_dir_offset + root.size();
+        header.leaf_dirs_bytes = leafData.size();
+        header.tile_data_offset = header.leaf_dirs_offset + leafData.size();
+        header.tile_data_bytes = tileData.size();
+        header.addressed_tiles_count = 4;
+        header.tile_entries_count = 4;
+        header.tile_contents_count = 4;
+        header.clustered = true;
+        header.internal_compression = pmtiles::COMPRESSION_NONE;
+        header.tile_compression = zlibTiles ? pmtiles::COMPRESSION_GZIP : pmtiles::COMPRESSION_NONE;
+        header.tile_type = pmtiles::TILETYPE_MVT;
+        header.min_zoom = 0;
+        header.max_zoom = 1;
+
+        // Leaf ranges as requested from the file source, with inclusive ends
+        for (auto& leaf : leaves) {
+            leaf = {header.leaf_dirs_offset + leaf.first, header.leaf_dirs_offset + leaf.first + leaf.second - 1};
+        }
+        data = header.serialize() + root + leafData + tileData;
+    }
+};
+
+// Requests the tile with the given PMTiles tile ID and runs the loop until it's loaded
+mbgl::Response requestTile(mbgl::util::RunLoop& loop,
+                           mbgl::PMTilesFileSource& pmtiles,
+                           const std::string& url,
+                           uint64_t tileID) {
+    const auto zxy = pmtiles::tileid_to_zxy(tileID);
+    mbgl::Response response;
+    const auto resource = mbgl::Resource::tile(url,
+                                               1.0,
+                                               static_cast<int32_t>(zxy.x),
+                                               static_cast<int32_t>(zxy.y),
+                                               static_cast<int8_t>(zxy.z),
+                                               mbgl::Tileset::Scheme::XYZ);
+    std::unique_ptr<mbgl::AsyncRequest> req = pmtiles.request(resource, [&](mbgl::Response res) {
+        response = res;
+        loop.stop();
+    });
+    loop.run();
+    return response;
+}
+
+// Serves byte ranges of an archive on the thread requesting them, and records every range served
+class ArchiveFileSource : public mbgl::FileSource {
+public:
+    struct State {
+        explicit State(std::string data_)
+            : data(std::move(data_)) {}
+
+        std::size_t count(const Range& range) {
+            std::scoped_lock lock(mutex);
+            return std::count(served.begin(), served.end(), range);
+        }
+
+        void waitFor(const Range& range) {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] { return std::find(served.begin(), served.end(), range) != served.end(); });
+        }
+
+        const std::string data;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<Range> served;
+    };
+
+    explicit ArchiveFileSource(std::shared_ptr<State> state_)
+        : state(std::move(state_)) {}
+
+    std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource& resource, Callback callback) override {
+        struct Request : mbgl::AsyncRequest {
+            ~Request() override { *cancelled = true; }
+            std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+        };
+        auto request = std::make_unique<Request>();
+
+        mbgl::Scheduler::GetCurrent()->schedule(
+            [state_ = state, range = *resource.dataRange, cancelled = request->cancelled, callback] {
+                if (*cancelled) {
+                    return;
+                }
+                mbgl::Response response;
+                response.data = std::make_shared<std::string>(
+                    state_->data.substr(range.first, range.second - range.first + 1));
+                callback(response);
+
+                std::scoped_lock lock(state_->mutex);
+                state_->served.push_back(range);
+                state_->cv.notify_all();
+            });
+        return request;
+    }
+
+    bool canRequest(const mbgl::Resource&) const override { return true; }
+    void setResourceOptions(mbgl::ResourceOptions) override {}
+    mbgl::ResourceOptions getResourceOptions() override { return {}; }
+    void setClientOptions(mbgl::ClientOptions) override {}
+    mbgl::ClientOptions getClientOptions() override { return {}; }
+
+private:
+    const std::shared_ptr<State> state;
+};
+
 } // namespace
 
 using namespace mbgl;
@@ -103,3 +250,213 @@ TEST(PMTilesFileSource, NonExistentTile) {
 
     loop.run();
 }
+
+// Tiles requested again are served from the cached header and directories
+TEST(PMTilesFileSource, TileTwice) {
+    util::RunLoop loop;
+
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+    const auto resource = Resource::tile(
+        toAbsoluteURL("geography-class-png.pmtiles"), 1.0, 0, 0, 1, Tileset::Scheme::XYZ);
+
+    int responses = 0;
+    std::unique_ptr<AsyncRequest> req;
+    std::function<void(Response)> callback = [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        ASSERT_EQ(res.noContent, false);
+        if (++responses == 2) {
+            req.reset();
+            loop.stop();
+            return;
+        }
+        req = pmtiles.request(resource, callback);
+    };
+    req = pmtiles.request(resource, callback);
+
+    loop.run();
+    EXPECT_EQ(2, responses);
+}
+
+TEST(PMTilesFileSource, DirectoryCacheEvictsLeastRecentlyUsed) {
+    const std::string url = "file:///archive.pmtiles";
+    const auto directoryBytes = PMTilesDirectoryCache::getDirectoryBytes(url, 1);
+    PMTilesDirectoryCache cache(directoryBytes * 2);
+
+    const PMTilesDirectoryKey first{url, 0, 10};
+    const PMTilesDirectoryKey second{url, 10, 10};
+    const PMTilesDirectoryKey third{url, 20, 10};
+    cache.put(first, {pmtiles::entryv3(1, 0, 10, 1)});
+    cache.put(second, {pmtiles::entryv3(2, 10, 10, 1)});
+    EXPECT_EQ(directoryBytes * 2, cache.getBytes());
+
+    // Looking up the first directory leaves the second as the least recently used one
+    ASSERT_TRUE(cache.get(first));
+    cache.put(third, {pmtiles::entryv3(3, 20, 10, 1)});
+    EXPECT_TRUE(cache.contains(first));
+    EXPECT_FALSE(cache.contains(second));
+    EXPECT_TRUE(cache.contains(third));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(directoryBytes * 2, cache.getBytes());
+
+    // Directories larger than the budget are kept until the next one is stored
+    const auto directory = cache.put(second, std::vector<pmtiles::entryv3>(100, pmtiles::entryv3(2, 10, 10, 1)));
+    EXPECT_EQ(100u, directory->size());
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_TRUE(cache.contains(second));
+    EXPECT_EQ(PMTilesDirectoryCache::getDirectoryBytes(url, 100), cache.getBytes());
+}
+
+// Looking up consecutive leaf directories fetches the next one ahead, and the tiles listed in it
+// are then found without fetching it again
+TEST(PMTilesFileSource, PrefetchesLeafDirectories) {
+    util::RunLoop loop;
+
+    const LeafArchive archive;
+    auto state = std::make_shared<ArchiveFileSource::State>(archive.data);
+
+    auto* manager = FileSourceManager::get();
+    auto previousFactory = manager->unRegisterFileSourceFactory(FileSourceType::ResourceLoader);
+    manager->registerFileSourceFactory(FileSourceType::ResourceLoader,
+                                       [state](const ResourceOptions&, const ClientOptions&) {
+                                           return std::make_unique<ArchiveFileSource>(state);
+                                       });
+
+    {
+        // Options no other test uses, so that the file source is created by the factory above
+        PMTilesFileSource pmtiles(ResourceOptions::Default().withApiKey("pmtiles-prefetch"), ClientOptions());
+        const std::string url = std::string(util::PMTILES_PROTOCOL) + "http://example.com/archive.pmtiles";
+
+        auto response = requestTile(loop, pmtiles, url, 1);
+        ASSERT_TRUE(response.data);
+        EXPECT_EQ("tile1", *response.data);
+        EXPECT_EQ(0u, state->count(archive.leaves[2]));
+
+        response = requestTile(loop, pmtiles, url, 2);
+        ASSERT_TRUE(response.data);
+        EXPECT_EQ("tile2", *response.data);
+
+        // The leaf directory of the third tile was requested ahead of it
+        state->waitFor(archive.leaves[2]);
+
+        response = requestTile(loop, pmtiles, url, 3);
+        ASSERT_TRUE(response.data);
+        EXPECT_EQ("tile3", *response.data);
+        EXPECT_EQ(1u, state->count(archive.leaves[0]));
+        EXPECT_EQ(1u, state->count(archive.leaves[1]));
+        EXPECT_EQ(1u, state->count(archive.leaves[2]));
+    }
+
+    manager->unRegisterFileSourceFactory(FileSourceType::ResourceLoader);
+    if (previousFactory) {
+        manager->registerFileSourceFactory(FileSourceType::ResourceLoader, std::move(previousFactory));
+    }
+}
+
+// Local archives are read from their mapping, which is dropped once the file is replaced
+TEST(PMTilesFileSource, MappedArchiveReplaced) {
+    util::RunLoop loop;
+
+    const auto path = (std::filesystem::temp_directory_path() / "mbgl-mapped-archive.pmtiles").string();
+    const auto url = std::string(util::PMTILES_PROTOCOL) + std::string(util::FILE_PROTOCOL) + path;
+    // Replaced the way archives are usually updated, by moving a new file over the old one
+    const auto writeArchive = [&](const std::string& data) {
+        util::write_file(path + ".new", data);
+        std::filesystem::rename(path + ".new", path);
+    };
+
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+
+    writeArchive(LeafArchive("tile").data);
+    auto response = requestTile(loop, pmtiles, url, 1);
+    EXPECT_EQ(nullptr, response.error);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile1", *response.data);
+
+    response = requestTile(loop, pmtiles, url, 4);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile4", *response.data);
+
+    // Tile requests look for a replaced archive at most once per second
+    writeArchive(LeafArchive("next").data);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    response = requestTile(loop, pmtiles, url, 1);
+    EXPECT_EQ(nullptr, response.error);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("next1", *response.data);
+
+    util::deleteFile(path);
+}
+
+// Ranges past the end of a mapped archive fail instead of reading outside of the mapping
+TEST(PMTilesFileSource, MappedArchiveTruncated) {
+    util::RunLoop loop;
+
+    const auto path = (std::filesystem::temp_directory_path() / "mbgl-truncated-archive.pmtiles").string();
+    const auto url = std::string(util::PMTILES_PROTOCOL) + std::string(util::FILE_PROTOCOL) + path;
+    const LeafArchive archive;
+    // The last tile is cut off, its directories are still whole
+    util::write_file(path, archive.data.substr(0, archive.data.size() - 2));
+
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+
+    auto response = requestTile(loop, pmtiles, url, 3);
+    EXPECT_EQ(nullptr, response.error);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile3", *response.data);
+
+    response = requestTile(loop, pmtiles, url, 4);
+    ASSERT_TRUE(response.error);
+    EXPECT_NE(std::string::npos, response.error->message.find("Range outside of the PMTiles archive"));
+    EXPECT_FALSE(response.data);
+
+    util::deleteFile(path);
+}
+
+// Archives truncated while mapped are read from the file instead of faulting on the mapping
+TEST(PMTilesFileSource, MappedArchiveTruncatedInPlace) {
+    util::RunLoop loop;
+
+    const auto path = (std::filesystem::temp_directory_path() / "mbgl-truncated-in-place.pmtiles").string();
+    const auto url = std::string(util::PMTILES_PROTOCOL) + std::string(util::FILE_PROTOCOL) + path;
+    const LeafArchive archive;
+    util::write_file(path, archive.data);
+
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+
+    auto response = requestTile(loop, pmtiles, url, 4);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile4", *response.data);
+
+    // The last tile is cut off, reading it from the mapping would raise SIGBUS
+    std::filesystem::resize_file(path, archive.data.size() - 2);
+
+    response = requestTile(loop, pmtiles, url, 4);
+    ASSERT_TRUE(response.error);
+    EXPECT_NE(std::string::npos, response.error->message.find("Range outside of the PMTiles archive"));
+
+    response = requestTile(loop, pmtiles, url, 3);
+    EXPECT_EQ(nullptr, response.error);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile3", *response.data);
+
+    util::deleteFile(path);
+}
+
+// Tiles of archives marked as gzip compressed are read whether they're gzip or zlib streams
+TEST(PMTilesFileSource, ZlibTilesInGzipArchive) {
+    util::RunLoop loop;
+
+    const auto path = (std::filesystem::temp_directory_path() / "mbgl-zlib-archive.pmtiles").string();
+    const auto url = std::string(util::PMTILES_PROTOCOL) + std::string(util::FILE_PROTOCOL) + path;
+    util::write_file(path, LeafArchive("tile", true).data);
+
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+
+    const auto response = requestTile(loop, pmtiles, url, 2);
+    EXPECT_EQ(nullptr, response.error);
+    ASSERT_TRUE(response.data);
+    EXPECT_EQ("tile2", *response.data);
+
+    util::deleteFile(path);
+}
@@ -1,4 +1,5 @@
 import express from "express";
+import http2 from "node:http2";
 import path from "node:path";
 
 if (!import.meta.dirname) throw new Error("Could not get import.meta.dirname. Use Node.js 20.11 or newer.");
@@ -180,7 +181,23 @@ app.get('/online/:style(*)', function(req, res) {
     // res.send('Request ' + req.params.style);
 });
 
-var server = app.listen(3000, function () {
-    // Tell parent that we're now listening.
-    process.stdout.write("OK");
+// Cleartext HTTP/2 without an upgrade from HTTP/1.1, for clients connecting with prior knowledge.
+var h2Server = http2.createServer(function (req, res) {
+    if (req.url === '/test') {
+        res.end('Hello World!');
+    } else {
+        res.writeHead(404);
+        res.end();
+    }
 });
+
+var listening = 0;
+function onListening() {
+    // Tell parent that we're now listening.
+    if (++listening === 2) {
+        process.stdout.write("OK");
+    }
+}
+
+var server = app.listen(3000, onListening);
+h2Server.listen(3002, onListening);
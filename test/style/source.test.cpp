@@ -1013,6 +1013,156 @@ TEST(Source, GeoJSONSourceTilesAfterDataReset) {
     EXPECT_TRUE(renderSource.isLoaded()); // Tiles are reset in static mode.
 }
 
+TEST(Source, GeoJSONSourceFeatureDiff) {
+    SourceTest test;
+
+    const auto point = [](uint64_t id, double lon, double lat) {
+        mapbox::feature::feature<double> feature{mapbox::geometry::point<double>(lon, lat)};
+        feature.id = id;
+        return feature;
+    };
+    const auto featureCount = [](GeoJSONData& data, const CanonicalTileID& tileID) {
+        std::size_t count = 0;
+        data.getTile(tileID, [&](const GeoJSONData::TileFeatures& features) { count = features.size(); }, true);
+        return count;
+    };
+
+    Mutable<GeoJSONOptions> options = makeMutable<GeoJSONOptions>();
+    options->incrementalUpdates = true;
+    const Immutable<GeoJSONOptions> incremental(std::move(options));
+
+    GeoJSONSource source("source", incremental);
+    GeoJSONFeatureDiff diff;
+    diff.add = {point(1, -100, 40), point(2, 100, 40)};
+    source.updateGeoJSON(diff);
+    const auto data = source.impl().getData().lock();
+    ASSERT_TRUE(data);
+    EXPECT_EQ(1u, featureCount(*data, {1, 0, 0}));
+    EXPECT_EQ(1u, featureCount(*data, {1, 1, 0}));
+
+    diff = {};
+    diff.add = {point(3, -90, 40)};
+    source.updateGeoJSON(diff);
+    const auto added = source.impl().getData().lock();
+    ASSERT_NE(data, added);
+    EXPECT_TRUE(added->isTileAffected({1, 0, 0}, *data));
+    EXPECT_FALSE(added->isTileAffected({1, 1, 0}, *data));
+    EXPECT_EQ(2u, featureCount(*added, {1, 0, 0}));
+    EXPECT_EQ(1u, featureCount(*added, {1, 1, 0}));
+
+    // Removes a feature in the north east and adds one in the south west
+    diff = {};
+    diff.remove = {uint64_t(2)};
+    diff.add = {point(4, -100, -40)};
+    source.updateGeoJSON(diff);
+    const auto moved = source.impl().getData().lock();
+    EXPECT_FALSE(moved->isTileAffected({1, 0, 0}, *added));
+    EXPECT_TRUE(moved->isTileAffected({1, 1, 0}, *added));
+    EXPECT_TRUE(moved->isTileAffected({1, 0, 1}, *added));
+    EXPECT_FALSE(moved->isTileAffected({1, 1, 1}, *added));
+    EXPECT_TRUE(moved->isTileAffected({1, 0, 0}, *data));
+    EXPECT_EQ(2u, featureCount(*moved, {1, 0, 0}));
+    EXPECT_EQ(0u, featureCount(*moved, {1, 1, 0}));
+    EXPECT_EQ(1u, featureCount(*moved, {1, 0, 1}));
+
+    // Features with the same id are replaced
+    diff = {};
+    diff.add = {point(1, 100, 40)};
+    source.updateGeoJSON(diff);
+    const auto replaced = source.impl().getData().lock();
+    EXPECT_TRUE(replaced->isTileAffected({1, 0, 0}, *moved));
+    EXPECT_EQ(1u, featureCount(*replaced, {1, 0, 0}));
+    EXPECT_EQ(1u, featureCount(*replaced, {1, 1, 0}));
+
+    // Data which handed its id index to the update replacing it can still be updated again
+    diff = {};
+    diff.remove = {uint64_t(1)};
+    const auto stale = moved->update(diff);
+    EXPECT_EQ(1u, featureCount(*stale, {1, 0, 0}));
+    EXPECT_EQ(1u, featureCount(*stale, {1, 0, 1}));
+
+    diff = {};
+    diff.removeAll = true;
+    source.updateGeoJSON(diff);
+    const auto cleared = source.impl().getData().lock();
+    EXPECT_TRUE(cleared->isTileAffected({1, 1, 1}, *replaced));
+    EXPECT_EQ(0u, featureCount(*cleared, {1, 0, 0}));
+    EXPECT_EQ(0u, featureCount(*cleared, {1, 1, 0}));
+
+    // Once the data updated from is gone, other data taking its place in memory isn't mistaken for it
+    auto base = cleared->update({});
+    const auto next = base->update({});
+    EXPECT_FALSE(next->isTileAffected({1, 0, 0}, *base));
+    base.reset();
+    const auto other = cleared->update({});
+    EXPECT_TRUE(next->isTileAffected({1, 0, 0}, *other));
+
+    // Of the features with the same id, the last one is kept
+    GeoJSONSource duplicates("duplicates", incremental);
+    diff = {};
+    diff.add = {point(5, -100, 40), point(5, 100, 40)};
+    duplicates.updateGeoJSON(diff);
+    diff = {};
+    diff.add = {point(6, 100, -40)};
+    duplicates.updateGeoJSON(diff);
+    const auto deduplicated = duplicates.impl().getData().lock();
+    EXPECT_EQ(0u, featureCount(*deduplicated, {1, 0, 0}));
+    EXPECT_EQ(1u, featureCount(*deduplicated, {1, 1, 0}));
+    EXPECT_EQ(1u, featureCount(*deduplicated, {1, 1, 1}));
+}
+
+TEST(Source, GeoJSONSourceFeatureDiffWithoutIncrementalUpdates) {
+    FixtureLog log;
+
+    mapbox::feature::feature<double> feature{mapbox::geometry::point<double>(0, 0)};
+    feature.id = uint64_t(1);
+    GeoJSONSource source("source");
+    source.setGeoJSON(mapbox::feature::feature_collection<double>{feature});
+    const auto data = source.impl().getData().lock();
+
+    // GeoJSON-VT data only keeps its tiles, so it can't be changed feature by feature
+    GeoJSONFeatureDiff diff;
+    diff.remove = {uint64_t(1)};
+    source.updateGeoJSON(diff);
+    EXPECT_EQ(data, source.impl().getData().lock());
+    EXPECT_EQ(1u,
+              log.count({EventSeverity::Warning,
+                         Event::Style,
+                         -1,
+                         "GeoJSON source \"source\" doesn't support incremental updates"}));
+
+    // But it can be replaced
+    diff = {};
+    diff.removeAll = true;
+    diff.add = {feature};
+    source.updateGeoJSON(diff);
+    const auto replaced = source.impl().getData().lock();
+    ASSERT_NE(data, replaced);
+    diff = {};
+    diff.remove = {uint64_t(1)};
+    source.updateGeoJSON(diff);
+    EXPECT_NE(replaced, source.impl().getData().lock());
+}
+
+TEST(Source, GeoJSONSourceFeatureDiffBeforeLoad) {
+    FixtureLog log;
+
+    // The data loaded from the URL would replace the update, which is rejected instead
+    GeoJSONSource source("source");
+    source.setURL("http://127.0.0.1:3000/test.geojson");
+    GeoJSONFeatureDiff diff;
+    diff.remove = {uint64_t(1)};
+    diff.add = {mapbox::feature::feature<double>{mapbox::geometry::point<double>(0, 0)}};
+    source.updateGeoJSON(diff);
+
+    EXPECT_FALSE(source.impl().getData().lock());
+    EXPECT_EQ(1u,
+              log.count({EventSeverity::Warning,
+                         Event::Style,
+                         -1,
+                         "GeoJSON source \"source\" can't be updated before its data loaded"}));
+}
+
 TEST(Source, SetMaxParentOverscaleFactor) {
     SourceTest test;
     test.transform.jumpTo(CameraOptions().withCenter(LatLng()).withZoom(8.0));
@@ -287,6 +287,28 @@ TEST(Layer, Observer) {
     EXPECT_FALSE(layoutPropertyChanged);
 }
 
+TEST(Layer, Fingerprint) {
+    auto layer = std::make_unique<LineLayer>("line", "source");
+    EXPECT_EQ(0u, layer->baseImpl->fingerprint.value);
+
+    Layer::Impl::updateFingerprint(*layer);
+    const auto fingerprint = layer->baseImpl->fingerprint.value;
+    EXPECT_NE(0u, fingerprint);
+
+    auto other = std::make_unique<LineLayer>("line", "source");
+    Layer::Impl::updateFingerprint(*other);
+    EXPECT_EQ(fingerprint, other->baseImpl->fingerprint.value);
+
+    // Modified layers get a copy of their implementation, which isn't fingerprinted
+    layer->setLineColor(color);
+    EXPECT_EQ(0u, layer->baseImpl->fingerprint.value);
+    EXPECT_EQ("line", layer->baseImpl->id);
+
+    Layer::Impl::updateFingerprint(*layer);
+    EXPECT_NE(0u, layer->baseImpl->fingerprint.value);
+    EXPECT_NE(fingerprint, layer->baseImpl->fingerprint.value);
+}
+
 TEST(Layer, DuplicateLayer) {
     util::RunLoop loop;
 
@@ -441,3 +441,70 @@ TEST(CrossTileSymbolLayerIndex, offscreenSymbols) {
     EXPECT_EQ(symbolBucket.symbolInstances.at(0).getCrossTileID(), 1u);
     EXPECT_EQ(symbolBucket.symbolInstances.at(1).getCrossTileID(), 2u);
 }
+
+TEST(CrossTileSymbolLayerIndex, keyHashCollision) {
+    uint32_t maxCrossTileID = 0;
+    uint32_t maxBucketInstanceId = 0;
+    CrossTileSymbolLayerIndex index(maxCrossTileID);
+
+    Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+    bool iconsNeedLinear = false;
+    bool sortFeaturesByY = false;
+    std::string bucketLeaderID = "test";
+
+    // Two different keys with the same 64-bit FNV-1a hash
+    const std::u16string key{char16_t(0x640f), char16_t(0x2d25), char16_t(0x2a96), char16_t(0x7b18)};
+    const std::u16string collidingKey{char16_t(0x587f), char16_t(0xf282), char16_t(0xb6e7), char16_t(0x13b4)};
+    ASSERT_NE(key, collidingKey);
+    ASSERT_EQ(makeSymbolInstance(0, 0, key).getKeyHash(), makeSymbolInstance(0, 0, collidingKey).getKeyHash());
+
+    OverscaledTileID mainID(6, 0, 6, 8, 8);
+    std::vector<SymbolInstance> mainInstances;
+    std::vector<SortKeyRange> mainRanges;
+    mainInstances.push_back(makeSymbolInstance(1000, 1000, key));
+    SymbolBucket mainBucket{layout,
+                            {},
+                            16.0f,
+                            1.0f,
+                            0,
+                            iconsNeedLinear,
+                            sortFeaturesByY,
+                            bucketLeaderID,
+                            std::move(mainInstances),
+                            std::move(mainRanges),
+                            1.0f,
+                            false,
+                            {},
+                            false /*iconsInText*/};
+    mainBucket.bucketInstanceId = ++maxBucketInstanceId;
+    index.addBucket(mainID, mat4{}, mainBucket);
+    ASSERT_EQ(mainBucket.symbolInstances.at(0).getCrossTileID(), 1u);
+
+    // The child tile has a symbol with the colliding key and one with the same key, both at the same position
+    OverscaledTileID childID(7, 0, 7, 16, 16);
+    std::vector<SymbolInstance> childInstances;
+    std::vector<SortKeyRange> childRanges;
+    childInstances.push_back(makeSymbolInstance(2000, 2000, collidingKey));
+    childInstances.push_back(makeSymbolInstance(2000, 2000, key));
+    SymbolBucket childBucket{layout,
+                             {},
+                             16.0f,
+                             1.0f,
+                             0,
+                             iconsNeedLinear,
+                             sortFeaturesByY,
+                             bucketLeaderID,
+                             std::move(childInstances),
+                             std::move(childRanges),
+                             1.0f,
+                             false,
+                             {},
+                             false /*iconsInText*/};
+    childBucket.bucketInstanceId = ++maxBucketInstanceId;
+    index.addBucket(childID, mat4{}, childBucket);
+
+    // Only the symbol with the same key matches the parent tile
+    EXPECT_EQ(childBucket.symbolInstances.at(0).getCrossTileID(), 2u);
+    EXPECT_EQ(childBucket.symbolInstances.at(1).getCrossTileID(), 1u);
+}
@@ -1,7 +1,11 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/scoped_setting.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 
+#include <mbgl/platform/settings.hpp>
+
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/util/async_request.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/i18n.hpp>
@@ -142,10 +146,38 @@ public:
     std::function<void(GlyphMap)> glyphsAvailable;
 };
 
+// Keeps what's forwarded to it, and answers cache-only glyph requests with it
+class CachingFileSource : public StubFileSource {
+public:
+    CachingFileSource() {
+        glyphsResponse = [this](const Resource& resource) {
+            EXPECT_EQ(Resource::LoadingMethod::CacheOnly, resource.loadingMethod);
+            Response response;
+            if (auto it = cache.find(resource.url); it != cache.end()) {
+                response.data = it->second;
+            } else {
+                response.noContent = true;
+            }
+            return std::optional<Response>(std::move(response));
+        };
+    }
+
+    bool supportsCacheOnlyRequests() const override { return true; }
+    void forward(const Resource& resource, const Response& response, std::function<void()>) override {
+        cache[resource.url] = response.data;
+        ++writes;
+        if (written) written();
+    }
+
+    std::map<std::string, std::shared_ptr<const std::string>> cache;
+    int writes = 0;
+    std::function<void()> written;
+};
+
 class GlyphManagerTest {
 public:
     util::RunLoop loop;
-    StubFileSource fileSource;
+    std::shared_ptr<StubFileSource> fileSource = std::make_shared<StubFileSource>();
     StubGlyphManagerObserver observer;
     StubGlyphRequestor requestor;
     GlyphManager glyphManager{std::make_unique<StubLocalGlyphRasterizer>()};
@@ -167,7 +199,7 @@ public:
 TEST(GlyphManager, LoadingSuccess) {
     GlyphManagerTest test;
 
-    test.fileSource.glyphsResponse = [&](const Resource& resource) {
+    test.fileSource->glyphsResponse = [&](const Resource& resource) {
         EXPECT_EQ(Resource::Kind::Glyphs, resource.kind);
         Response response;
         response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
@@ -203,7 +235,7 @@ TEST(GlyphManager, LoadingSuccess) {
 TEST(GlyphManager, LoadingFail) {
     GlyphManagerTest test;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         Response response;
         response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, "Failed by the test case");
         return response;
@@ -232,7 +264,7 @@ TEST(GlyphManager, LoadingFail) {
 TEST(GlyphManager, LoadingCorrupted) {
     GlyphManagerTest test;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         Response response;
         response.data = std::make_unique<std::string>("CORRUPTED");
         return response;
@@ -261,7 +293,7 @@ TEST(GlyphManager, LoadingCorrupted) {
 TEST(GlyphManager, LoadingCancel) {
     GlyphManagerTest test;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         test.end();
         return std::optional<Response>();
     };
@@ -278,7 +310,7 @@ TEST(GlyphManager, LoadLocalCJKGlyph) {
     GlyphManagerTest test;
     int glyphResponses = 0;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         glyphResponses++;
         return std::optional<Response>();
     };
@@ -321,7 +353,7 @@ TEST(GlyphManager, LoadLocalCJKGlyphAfterLoadingRangeFromURL) {
     GlyphManagerTest test;
     bool firstGlyphResponse = false;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         firstGlyphResponse = true;
         Response response;
         response.data = std::make_shared<std::string>(
@@ -369,7 +401,7 @@ TEST(GlyphManager, LoadLocalCJKGlyphAfterLoadingRangeFromURL) {
 TEST(GlyphManager, LoadingInvalid) {
     GlyphManagerTest test;
 
-    test.fileSource.glyphsResponse = [&](const Resource& resource) {
+    test.fileSource->glyphsResponse = [&](const Resource& resource) {
         EXPECT_EQ(Resource::Kind::Glyphs, resource.kind);
         Response response;
         response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/fake_glyphs-0-255.pbf"));
@@ -404,7 +436,8 @@ TEST(GlyphManager, ImmediateFileSource) {
     class GlyphManagerTestSynchronous {
     public:
         util::RunLoop loop;
-        StubFileSource fileSource = {StubFileSource::ResponseType::Synchronous};
+        std::shared_ptr<StubFileSource> fileSource = std::make_shared<StubFileSource>(
+            StubFileSource::ResponseType::Synchronous);
         StubGlyphManagerObserver observer;
         StubGlyphRequestor requestor;
         GlyphManager glyphManager;
@@ -425,7 +458,7 @@ TEST(GlyphManager, ImmediateFileSource) {
 
     GlyphManagerTestSynchronous test;
 
-    test.fileSource.glyphsResponse = [&](const Resource&) {
+    test.fileSource->glyphsResponse = [&](const Resource&) {
         Response response;
         response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
         return response;
@@ -443,3 +476,120 @@ TEST(GlyphManager, ImmediateFileSource) {
     test.run("test/fixtures/resources/glyphs.pbf",
              GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {u'a', u'å', u' '}}}, .shapes = {}});
 }
+
+TEST(GlyphManager, LoadLocalCJKGlyphFromCache) {
+    class CountingGlyphRasterizer : public StubLocalGlyphRasterizer {
+    public:
+        CountingGlyphRasterizer(int& rasterized_)
+            : rasterized(rasterized_) {}
+
+        Glyph rasterizeGlyph(const FontStack& fontStack, GlyphID glyphID) override {
+            ++rasterized;
+            return StubLocalGlyphRasterizer::rasterizeGlyph(fontStack, glyphID);
+        }
+
+        int& rasterized;
+    };
+
+    test::ScopedSetting glyphCache(platform::EXPERIMENTAL_GLYPH_SDF_CACHE, true);
+
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<CachingFileSource>();
+
+    int rasterized = 0;
+    StubGlyphRequestor requestor;
+    auto load = [&] {
+        GlyphManager glyphManager(std::make_unique<CountingGlyphRasterizer>(rasterized), "Test Family");
+        requestor.glyphsAvailable = [&](GlyphMap glyphs) {
+            const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+            ASSERT_EQ(testPositions.count(u'中'), 1u);
+
+            Immutable<Glyph> glyph = *testPositions.at(u'中');
+            EXPECT_EQ(glyph->metrics.width, 24ul);
+            EXPECT_EQ(glyph->metrics.top, -8);
+            ASSERT_EQ(glyph->bitmap.size, Size(30, 30));
+            const uint8_t* pixels = glyph->bitmap.data.get();
+            EXPECT_TRUE(std::equal(pixels, pixels + glyph->bitmap.bytes(), sdfBitmap));
+            loop.stop();
+        };
+        glyphManager.getGlyphs(
+            requestor, GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {u'中'}}}, .shapes = {}}, fileSource);
+        loop.run();
+    };
+
+    // Generated, and stored in the cache
+    load();
+    EXPECT_EQ(1, rasterized);
+    EXPECT_EQ(1u, fileSource->cache.size());
+
+    // Read back from the cache, as after a restart
+    load();
+    EXPECT_EQ(1, rasterized);
+}
+
+TEST(GlyphManager, CoalesceGlyphCacheWrites) {
+    test::ScopedSetting glyphCache(platform::EXPERIMENTAL_GLYPH_SDF_CACHE, true);
+
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<CachingFileSource>();
+    StubGlyphRequestor requestor;
+    GlyphManager glyphManager(std::make_unique<StubLocalGlyphRasterizer>(), "Test Family");
+    auto getGlyphs = [&](char16_t glyphID) {
+        std::size_t available = 0;
+        requestor.glyphsAvailable = [&](GlyphMap glyphs) {
+            available = glyphs.at(FontStackHasher()({{"Test Stack"}})).count(glyphID);
+            loop.stop();
+        };
+        glyphManager.getGlyphs(
+            requestor, GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {glyphID}}}, .shapes = {}}, fileSource);
+        if (!available) {
+            loop.run();
+        }
+        EXPECT_EQ(1u, available);
+    };
+
+    // New glyphs of one range, one after the other, don't write the range every time
+    getGlyphs(u'中');
+    getGlyphs(u'丰');
+    getGlyphs(u'乐');
+    EXPECT_EQ(0, fileSource->writes);
+
+    // All of them are written together a moment later
+    fileSource->written = [&] { loop.stop(); };
+    loop.run();
+    EXPECT_EQ(1, fileSource->writes);
+    ASSERT_EQ(1u, fileSource->cache.size());
+    EXPECT_EQ(3u * (8 * sizeof(uint32_t) + stubBitmapLength), fileSource->cache.begin()->second->size());
+}
+
+TEST(GlyphManager, GlyphCacheOutlivedByFileSource) {
+    class SynchronousCachingFileSource : public CachingFileSource {
+    public:
+        std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) override {
+            callback(*glyphsResponse(resource));
+            return nullptr;
+        }
+    };
+
+    test::ScopedSetting glyphCache(platform::EXPERIMENTAL_GLYPH_SDF_CACHE, true);
+
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<SynchronousCachingFileSource>();
+    bool written = false;
+    fileSource->written = [&] { written = true; };
+    StubGlyphRequestor requestor;
+    bool available = false;
+    requestor.glyphsAvailable = [&](GlyphMap) {
+        available = true;
+    };
+
+    auto glyphManager = std::make_unique<GlyphManager>(std::make_unique<StubLocalGlyphRasterizer>(), "Test Family");
+    glyphManager->getGlyphs(
+        requestor, GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {u'中'}}}, .shapes = {}}, fileSource);
+    EXPECT_TRUE(available);
+
+    // The range isn't written yet when the tiles and the map let go of the file source
+    fileSource.reset();
+    glyphManager.reset();
+    EXPECT_FALSE(written);
+}
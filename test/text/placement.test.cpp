@@ -0,0 +1,53 @@
+#include <mbgl/map/transform.hpp>
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/placement.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+TransformState makeState(const CameraOptions& camera, Size size = {512, 512}) {
+    Transform transform;
+    transform.resize(size);
+    transform.jumpTo(CameraOptions().withCenter(LatLng{10, 20}).withZoom(4.0));
+    transform.jumpTo(camera);
+    return transform.getState();
+}
+
+} // namespace
+
+TEST(Placement, PanOffset) {
+    const auto state = makeState({});
+
+    const auto unchanged = Placement::getPanOffset(state, makeState({}));
+    ASSERT_TRUE(unchanged);
+    EXPECT_EQ(0.0f, unchanged->x);
+    EXPECT_EQ(0.0f, unchanged->y);
+
+    // Everything on screen moves by the offset, in screen coordinates with y pointing down
+    const auto panned = makeState(CameraOptions().withCenter(LatLng{10.5, 19.2}));
+    const auto offset = Placement::getPanOffset(state, panned);
+    ASSERT_TRUE(offset);
+    const LatLng point{12, 21};
+    const auto before = state.latLngToScreenCoordinate(point);
+    const auto after = panned.latLngToScreenCoordinate(point);
+    EXPECT_NE(0.0f, offset->x);
+    EXPECT_NE(0.0f, offset->y);
+    EXPECT_NEAR(after.x - before.x, offset->x, 0.01);
+    EXPECT_NEAR(after.y - before.y, offset->y, 0.01);
+}
+
+TEST(Placement, PanOffsetFallsBackOnOtherChanges) {
+    const auto state = makeState({});
+
+    EXPECT_FALSE(Placement::getPanOffset(state, makeState(CameraOptions().withZoom(4.01))));
+    EXPECT_FALSE(Placement::getPanOffset(state, makeState(CameraOptions().withBearing(10.0))));
+    EXPECT_FALSE(Placement::getPanOffset(state, makeState(CameraOptions().withPitch(30.0))));
+    EXPECT_FALSE(Placement::getPanOffset(state, makeState({}, {512, 256})));
+
+    // Panning a tilted view moves what's near and far by different amounts
+    const auto tilted = makeState(CameraOptions().withPitch(30.0));
+    EXPECT_FALSE(Placement::getPanOffset(
+        tilted, makeState(CameraOptions().withPitch(30.0).withCenter(LatLng{10.5, 19.2}))));
+    EXPECT_FALSE(Placement::getPanOffset(tilted, tilted));
+}
@@ -4,6 +4,7 @@
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/text/tagged_string.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/constants.hpp>
 
 using namespace mbgl;
@@ -104,6 +105,77 @@ TEST(Shaping, ZWSP) {
     }
 }
 
+TEST(Shaping, Cache) {
+    GlyphPosition glyphPosition;
+    glyphPosition.rect = {10, 10, 24, 24};
+    glyphPosition.metrics.width = 18;
+    glyphPosition.metrics.height = 18;
+    glyphPosition.metrics.left = 2;
+    glyphPosition.metrics.top = -8;
+    glyphPosition.metrics.advance = 21;
+
+    Glyph glyph;
+    glyph.id = u'中';
+    glyph.metrics = glyphPosition.metrics;
+
+    BiDi bidi;
+    auto immutableGlyph = Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph)));
+    const std::vector<std::string> fontStack{{"font-stack"}};
+    const SectionOptions sectionOptions(1.0f, fontStack, GlyphIDType::FontPBF, 0);
+    GlyphMap glyphs = {{FontStackHasher()(fontStack), {{u'中', std::move(immutableGlyph)}}}};
+    GlyphPositions glyphPositions = {{FontStackHasher()(fontStack), {{u'中', glyphPosition}}}};
+    ImagePositions imagePositions;
+
+    ShapingCache cache(2);
+    const auto testGetShaping = [&](const TaggedString& string, unsigned maxWidthInChars) {
+        return cache.getShaping(string,
+                                maxWidthInChars * ONE_EM,
+                                ONE_EM, // lineHeight
+                                style::SymbolAnchorType::Center,
+                                style::TextJustifyType::Center,
+                                0,              // spacing
+                                {{0.0f, 0.0f}}, // translate
+                                WritingModeType::Horizontal,
+                                bidi,
+                                glyphs,
+                                glyphPositions,
+                                imagePositions,
+                                16.0f,
+                                16.0f,
+                                /*allowVerticalPlacement*/ false);
+    };
+
+    const TaggedString string(u"中中\u200b中", sectionOptions);
+    const auto shaping = testGetShaping(string, 1);
+    ASSERT_EQ(shaping.positionedLines.size(), 2);
+    EXPECT_EQ(cache.getStats().misses, 1u);
+
+    // Same text and layout in another tile, whose atlas has the glyph somewhere else
+    glyphPositions.begin()->second.begin()->second.rect = {40, 40, 24, 24};
+    const auto cached = testGetShaping(TaggedString(u"中中\u200b中", sectionOptions), 1);
+    EXPECT_EQ(cache.getStats().hits, 1u);
+    ASSERT_EQ(cached.positionedLines.size(), 2);
+    EXPECT_EQ(cached.top, shaping.top);
+    EXPECT_EQ(cached.bottom, shaping.bottom);
+    EXPECT_EQ(cached.left, shaping.left);
+    EXPECT_EQ(cached.right, shaping.right);
+    const auto& cachedGlyph = cached.positionedLines[1].positionedGlyphs.front();
+    EXPECT_EQ(cachedGlyph.x, shaping.positionedLines[1].positionedGlyphs.front().x);
+    EXPECT_EQ(cachedGlyph.rect, Rect<uint16_t>(40, 40, 24, 24));
+
+    // Other layout parameters are shaped again
+    const auto narrow = testGetShaping(string, 5);
+    EXPECT_EQ(cache.getStats().misses, 2u);
+
+    // So are glyphs with other metrics, like those of another font with the same name
+    glyphPositions.begin()->second.begin()->second.metrics.advance = 24;
+    const auto wider = testGetShaping(string, 5);
+    EXPECT_EQ(cache.getStats().misses, 3u);
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+    EXPECT_EQ(cache.getStats().entries, 2u);
+    EXPECT_GT(wider.positionedLines[0].positionedGlyphs.back().x, narrow.positionedLines[0].positionedGlyphs.back().x);
+}
+
 void setupShapedText(Shaping& shapedText, float textSize) {
     const auto glyph = PositionedGlyph(32,
                                        0.0f,
@@ -0,0 +1,109 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fake_file_source.hpp>
+#include <mbgl/test/stub_tile_observer.hpp>
+
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/gfx/dynamic_texture_atlas.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+class AnnotationTileTest {
+public:
+    util::SimpleIdentity uniqueID;
+    std::shared_ptr<FileSource> fileSource = std::make_shared<FakeFileSource>();
+    TransformState transformState;
+    util::RunLoop loop;
+    std::shared_ptr<ImageManager> imageManager = std::make_shared<ImageManager>();
+    std::shared_ptr<GlyphManager> glyphManager = std::make_shared<GlyphManager>();
+    gfx::DynamicTextureAtlasPtr dynamicTextureAtlas;
+    TileParameters tileParameters;
+    style::Style style;
+    AnnotationManager annotationManager{style};
+
+    AnnotationTileTest()
+        : tileParameters{.pixelRatio = 1.0,
+                         .debugOptions = MapDebugOptions(),
+                         .transformState = transformState,
+                         .fileSource = fileSource,
+                         .mode = MapMode::Continuous,
+                         .annotationManager = {},
+                         .imageManager = imageManager,
+                         .glyphManager = glyphManager,
+                         .prefetchZoomDelta = 0,
+                         .threadPool = {Scheduler::GetBackground(), uniqueID},
+                         .dynamicTextureAtlas = dynamicTextureAtlas},
+          style{fileSource, 1, tileParameters.threadPool} {
+        tileParameters.annotationManager = annotationManager.makeWeakPtr();
+    }
+};
+
+namespace {
+
+// Counts how often each tile starts parsing new data
+class ParseCountingTileObserver : public StubTileObserver {
+public:
+    void onTileAction(OverscaledTileID tileID, std::string, TileOperation operation) override {
+        if (operation == TileOperation::StartParse) {
+            ++parses[tileID];
+        }
+    }
+
+    std::map<OverscaledTileID, int> parses;
+};
+
+} // namespace
+
+TEST(AnnotationTile, UpdateOnlyRegeneratesTouchedTiles) {
+    AnnotationTileTest test;
+
+    CircleLayer layer("circle", AnnotationManager::SourceID);
+    layer.setSourceLayer(AnnotationManager::PointLayerID);
+    std::vector<Immutable<LayerProperties>> layers{
+        makeMutable<CircleLayerProperties>(staticImmutableCast<CircleLayer::Impl>(layer.baseImpl))};
+
+    const AnnotationID west = test.annotationManager.addAnnotation(SymbolAnnotation{Point<double>{-20, 10}});
+    test.annotationManager.addAnnotation(SymbolAnnotation{Point<double>{20, 10}});
+    test.annotationManager.updateData();
+
+    ParseCountingTileObserver observer;
+    const OverscaledTileID northWestID(1, 0, 0);
+    const OverscaledTileID southWestID(1, 0, 1);
+    const OverscaledTileID northEastID(1, 1, 0);
+    std::vector<std::unique_ptr<AnnotationTile>> tiles;
+    for (const auto& tileID : {northWestID, southWestID, northEastID}) {
+        tiles.push_back(std::make_unique<AnnotationTile>(tileID, test.tileParameters, &observer));
+        tiles.back()->setLayers(layers);
+    }
+    const auto complete = [&] {
+        return std::ranges::all_of(tiles, [](const auto& tile) { return tile->isComplete(); });
+    };
+    while (!complete()) {
+        test.loop.runOnce();
+    }
+    observer.parses.clear();
+
+    // Moving the western marker south reloads the western tiles only
+    test.annotationManager.updateAnnotation(west, SymbolAnnotation{Point<double>{-20, -10}});
+    test.annotationManager.updateData();
+    while (!complete()) {
+        test.loop.runOnce();
+    }
+
+    EXPECT_EQ(1, observer.parses[northWestID]);
+    EXPECT_EQ(1, observer.parses[southWestID]);
+    EXPECT_EQ(0, observer.parses[northEastID]);
+}
@@ -0,0 +1,72 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/tile/columnar_filter.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+style::Filter parseFilter(const char* json) {
+    style::conversion::Error error;
+    auto filter = style::conversion::convertJSON<style::Filter>(json, error);
+    EXPECT_TRUE(bool(filter)) << error.message;
+    return *filter;
+}
+
+} // namespace
+
+TEST(ColumnarFilter, MatchesPerFeatureEvaluation) {
+    VectorMVTTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+    auto layer = data.getLayer("admin");
+    ASSERT_TRUE(bool(layer));
+    FeatureColumns columns(*layer);
+    const CanonicalTileID canonical(0, 0, 0);
+
+    for (const char* json : {
+             R"(["==", "admin_level", 2])",
+             R"(["all", ["==", "maritime", 0], ["<=", "admin_level", 4]])",
+             R"(["in", "admin_level", 3, 4])",
+             R"(["!has", "disputed"])",
+             R"(["==", "$type", "LineString"])",
+             R"(["has", "$id"])",
+             R"(["==", ["get", "admin_level"], ["case", [">", ["zoom"], 1], 4, 2]])",
+             R"(["match", ["geometry-type"], "LineString", ["to-boolean", ["get", "disputed"]], false])",
+             R"([">", ["zoom"], 1])",
+         }) {
+        SCOPED_TRACE(json);
+        const auto filter = parseFilter(json);
+        const auto columnar = ColumnarFilter::compile(filter);
+        ASSERT_TRUE(bool(columnar));
+
+        for (const float zoom : {0.0f, 3.0f}) {
+            const auto selection = columnar->select(columns, zoom, canonical);
+            ASSERT_EQ(layer->featureCount(), selection.size());
+            for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                const auto feature = layer->getFeature(i);
+                auto context = style::expression::EvaluationContext(zoom, feature.get());
+                EXPECT_EQ(filter(context.withCanonicalTileID(&canonical)), selection[i]);
+            }
+        }
+    }
+}
+
+TEST(ColumnarFilter, Unsupported) {
+    EXPECT_FALSE(bool(ColumnarFilter::compile(style::Filter())));
+    EXPECT_FALSE(bool(ColumnarFilter::compile(parseFilter(R"(["has", "admin_level", ["properties"]])"))));
+    EXPECT_FALSE(bool(ColumnarFilter::compile(parseFilter(R"(["==", ["get", ["concat", "admin", "_level"]], 2])"))));
+    EXPECT_FALSE(bool(ColumnarFilter::compile(
+        parseFilter(R"(["within", {"type": "Polygon", "coordinates": [[[0, 0], [0, 5], [5, 5], [5, 0], [0, 0]]]}])"))));
+
+    const auto filter = ColumnarFilter::compile(parseFilter(R"(["all", ["==", "class", "a"], ["has", "$id"]])"));
+    ASSERT_TRUE(bool(filter));
+    EXPECT_EQ(std::vector<std::string>{"class"}, filter->getKeys());
+    EXPECT_FALSE(filter->readsType());
+    EXPECT_TRUE(filter->readsID());
+}
@@ -0,0 +1,77 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/tile/feature_decode_cache.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+
+#include <mbgl/util/io.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+VectorMVTTileData loadTile() {
+    return VectorMVTTileData(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+}
+
+} // namespace
+
+TEST(FeatureDecodeCache, SharesDecodedFeatures) {
+    auto data = loadTile();
+    FeatureDecodeCache cache;
+
+    auto first = cache.getLayer(data, "admin");
+    auto second = cache.getLayer(data, "admin");
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(first->getName(), "admin");
+    EXPECT_EQ(first->featureCount(), second->featureCount());
+    EXPECT_FALSE(cache.getLayer(data, "invalid"));
+
+    auto feature = first->getFeature(0);
+    auto same = second->getFeature(0);
+    EXPECT_EQ(&feature->getGeometries(), &same->getGeometries());
+    EXPECT_EQ(&feature->getProperties(), &same->getProperties());
+    EXPECT_EQ(feature->getValue("disputed"), same->getValue("disputed"));
+    EXPECT_EQ(feature->getType(), FeatureType::LineString);
+
+    // Matches what the tile data returns without the cache
+    auto uncached = data.getLayer("admin")->getFeature(0);
+    EXPECT_EQ(uncached->getGeometries(), feature->getGeometries());
+    EXPECT_EQ(uncached->getProperties(), feature->getProperties());
+    EXPECT_EQ(uncached->getID(), feature->getID());
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.features);
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_LT(0u, stats.bytes);
+}
+
+TEST(FeatureDecodeCache, OutlivesCache) {
+    auto data = loadTile();
+    std::unique_ptr<GeometryTileFeature> feature;
+    {
+        FeatureDecodeCache cache;
+        feature = cache.getLayer(data, "water")->getFeature(0);
+    }
+    // Features keep their shared data alive, as symbol layouts hold on to them after parsing
+    EXPECT_FALSE(feature->getGeometries().empty());
+}
+
+TEST(FeatureDecodeCache, Budget) {
+    auto data = loadTile();
+    FeatureDecodeCache cache(1);
+
+    auto layer = cache.getLayer(data, "admin");
+    auto feature = layer->getFeature(0);
+    EXPECT_FALSE(feature->getGeometries().empty());
+
+    // The budget is used up, further features are decoded without being retained
+    auto other = cache.getLayer(data, "admin")->getFeature(1);
+    EXPECT_FALSE(other->getGeometries().empty());
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.features);
+    EXPECT_EQ(1u, stats.misses);
+}
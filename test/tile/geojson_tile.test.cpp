@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/fake_file_source.hpp>
+#include <mbgl/test/scoped_setting.hpp>
 #include <mbgl/test/stub_tile_observer.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
@@ -14,6 +15,7 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/gfx/dynamic_texture_atlas.hpp>
 
 #include <memory>
@@ -126,6 +128,38 @@ TEST(GeoJSONTile, Issue7648) {
     }
 }
 
+TEST(GeoJSONTile, ParallelLayerParsing) {
+    GeoJSONTileTest test;
+    test::ScopedSetting parallelParsing(platform::EXPERIMENTAL_PARALLEL_LAYER_PARSING, true);
+
+    mapbox::feature::feature_collection<int16_t> features;
+    for (int16_t i = 0; i < 100; ++i) {
+        features.push_back(mapbox::feature::feature<int16_t>{mapbox::geometry::point<int16_t>(i * 40, i * 40)});
+    }
+    auto data = std::make_shared<FakeGeoJSONData>(std::move(features));
+    GeoJSONTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, data);
+
+    // Distinct zoom ranges put every layer in its own layout group
+    std::vector<std::unique_ptr<CircleLayer>> styleLayers;
+    std::vector<Immutable<LayerProperties>> layers;
+    for (int i = 0; i < 8; ++i) {
+        auto layer = std::make_unique<CircleLayer>("circle" + util::toString(i), "source");
+        layer->setMinZoom(static_cast<float>(i) / 10.0f);
+        layers.push_back(makeMutable<CircleLayerProperties>(staticImmutableCast<CircleLayer::Impl>(layer->baseImpl)));
+        styleLayers.push_back(std::move(layer));
+    }
+    tile.setLayers(layers);
+
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+
+    ASSERT_TRUE(tile.isRenderable());
+    for (const auto& layerProperties : layers) {
+        EXPECT_TRUE(tile.layerPropertiesUpdated(layerProperties));
+    }
+}
+
 // Tests that tiles remain renderable if they have been renderable and then had
 // an error sent to them, e.g. when revalidating/refreshing the request.
 TEST(GeoJSONTile, Issue9927) {
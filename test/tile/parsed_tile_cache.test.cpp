@@ -0,0 +1,168 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/scoped_setting.hpp>
+
+#include <mbgl/tile/parsed_tile_cache.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+ParsedTileCache::Key makeKey(std::size_t layers) {
+    return {.sourceID = "source",
+            .tileID = OverscaledTileID(1, 0, 0),
+            .mode = MapMode::Static,
+            .pixelRatio = 1.0f,
+            .layers = layers,
+            .dataVersion = 1,
+            .data = nullptr};
+}
+
+std::shared_ptr<const ParsedTileCache::Entry> makeEntry(std::size_t features) {
+    auto featureIndex = std::make_shared<FeatureIndex>(nullptr);
+    featureIndex->setBucketLayerIDs("layer", {"layer"});
+    for (std::size_t i = 0; i < features; ++i) {
+        featureIndex->insert({{{0, 0}, {10, 10}}}, i, "source-layer", "layer");
+    }
+    return std::make_shared<const ParsedTileCache::Entry>(
+        ParsedTileCache::Entry{.bucket = nullptr, .featureIndex = std::move(featureIndex)});
+}
+
+} // namespace
+
+TEST(ParsedTileCache, Key) {
+    ParsedTileCache cache(1024 * 1024);
+    const auto entry = makeEntry(1);
+    cache.put(makeKey(1), entry);
+    EXPECT_EQ(entry, cache.get(makeKey(1)));
+
+    EXPECT_FALSE(cache.get(makeKey(2)));
+
+    auto key = makeKey(1);
+    key.sourceID = "other";
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(1);
+    key.tileID = OverscaledTileID(2, 1, 0);
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(1);
+    key.pixelRatio = 2.0f;
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(1);
+    key.dataVersion = 2;
+    EXPECT_FALSE(cache.get(key));
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(5u, stats.misses);
+    EXPECT_EQ(1u, stats.entries);
+}
+
+TEST(ParsedTileCache, UnversionedDataKey) {
+    ParsedTileCache cache(1024 * 1024);
+    const auto entry = makeEntry(1);
+    const auto data = std::make_shared<const std::string>("tile");
+
+    auto key = makeKey(1);
+    key.dataVersion = 0;
+    key.data = data;
+    cache.put(key, entry);
+    EXPECT_EQ(entry, cache.get(key));
+
+    // Equal bytes loaded again aren't known to be the same tile
+    key.data = std::make_shared<const std::string>("tile");
+    EXPECT_FALSE(cache.get(key));
+
+    // The stored tile counts towards the size of the cache
+    cache.clear();
+    key.data = std::make_shared<const std::string>(std::string(4096, 'x'));
+    cache.put(key, entry);
+    const auto largeBytes = cache.getStats().bytes;
+    cache.clear();
+    key.data = data;
+    cache.put(key, entry);
+    EXPECT_EQ(4092u, largeBytes - cache.getStats().bytes);
+
+    // Layer groups of the same tile count its data once
+    cache.clear();
+    key.data = std::make_shared<const std::string>(std::string(4096, 'x'));
+    cache.put(key, entry);
+    const auto oneGroupBytes = cache.getStats().bytes;
+    auto otherGroup = key;
+    otherGroup.layers = 2;
+    cache.put(otherGroup, entry);
+    EXPECT_EQ(oneGroupBytes * 2 - 4096, cache.getStats().bytes);
+
+    // The data is counted until the last group using it is gone
+    cache.setMaxBytes(oneGroupBytes);
+    EXPECT_EQ(1u, cache.getStats().entries);
+    EXPECT_EQ(oneGroupBytes, cache.getStats().bytes);
+    cache.setMaxBytes(0);
+    EXPECT_EQ(0u, cache.getStats().bytes);
+}
+
+TEST(ParsedTileCache, EvictsLeastRecentlyUsed) {
+    ParsedTileCache cache;
+    cache.put(makeKey(1), makeEntry(100));
+    EXPECT_EQ(0u, cache.getStats().entries) << "A cache of 0 bytes stores nothing";
+
+    cache.setMaxBytes(1024 * 1024);
+    cache.put(makeKey(1), makeEntry(100));
+    const auto entryBytes = cache.getStats().bytes;
+    ASSERT_LT(0u, entryBytes);
+
+    // Room for two entries
+    cache.setMaxBytes(entryBytes * 2 + entryBytes / 2);
+    cache.put(makeKey(2), makeEntry(100));
+    EXPECT_TRUE(cache.get(makeKey(1)));
+    cache.put(makeKey(3), makeEntry(100));
+
+    EXPECT_TRUE(cache.get(makeKey(1)));
+    EXPECT_FALSE(cache.get(makeKey(2)));
+    EXPECT_TRUE(cache.get(makeKey(3)));
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(2u, stats.entries);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(entryBytes * 2, stats.bytes);
+
+    // Entries larger than the whole cache aren't stored
+    cache.put(makeKey(4), makeEntry(1000));
+    EXPECT_FALSE(cache.get(makeKey(4)));
+    EXPECT_EQ(2u, cache.getStats().entries);
+
+    cache.setMaxBytes(entryBytes);
+    stats = cache.getStats();
+    EXPECT_EQ(1u, stats.entries);
+    EXPECT_TRUE(cache.get(makeKey(3)));
+
+    cache.clear();
+    stats = cache.getStats();
+    EXPECT_EQ(0u, stats.entries);
+    EXPECT_EQ(0u, stats.bytes);
+}
+
+TEST(ParsedTileCache, DefaultSizedWhenStyleLoads) {
+    EXPECT_FALSE(ParsedTileCache::updateDefault());
+
+    {
+        // Only read along with fingerprinting the layers of a style, tiles don't pick it up before
+        test::ScopedSetting maxBytes(platform::EXPERIMENTAL_PARSED_TILE_CACHE_MAX_BYTES, uint64_t(1) << 20);
+        EXPECT_FALSE(ParsedTileCache::getDefault());
+        const auto cache = ParsedTileCache::updateDefault();
+        ASSERT_TRUE(cache);
+        EXPECT_EQ(1u << 20, cache->getMaxBytes());
+        EXPECT_EQ(cache, ParsedTileCache::getDefault());
+    }
+
+    // Neither is turning it off again
+    EXPECT_TRUE(ParsedTileCache::getDefault());
+    EXPECT_FALSE(ParsedTileCache::updateDefault());
+    EXPECT_FALSE(ParsedTileCache::getDefault());
+}
@@ -95,3 +95,37 @@ TEST(RasterDEMTile, onParsedEmpty) {
     EXPECT_TRUE(tile.isLoaded());
     EXPECT_TRUE(tile.isComplete());
 }
+
+TEST(RasterDEMTile, BackfillBorder) {
+    RasterDEMTileTest test;
+    const auto makeBucket = [](uint8_t value) {
+        PremultipliedImage image({4, 4});
+        std::fill(image.data.get(), image.data.get() + image.bytes(), value);
+        return std::make_unique<HillshadeBucket>(std::move(image), Tileset::RasterEncoding::Mapbox);
+    };
+
+    RasterDEMTile left(OverscaledTileID(1, 0, 0), "testSource", test.tileParameters, test.tileset);
+    RasterDEMTile right(OverscaledTileID(1, 1, 0), "testSource", test.tileParameters, test.tileset);
+    left.onParsed(makeBucket(1), 0);
+    right.onParsed(makeBucket(2), 0);
+
+    const DEMData& dem = left.getBucket()->getDEMData();
+    const auto original = dem.getImagePtr();
+    const int32_t before = dem.get(4, 0);
+
+    left.getBucket()->setPrepared(true);
+    left.backfillBorder(right, DEMTileNeighbors::Right);
+    EXPECT_TRUE((left.neighboringTiles & DEMTileNeighbors::Right) == DEMTileNeighbors::Right);
+    left.flushBackfill();
+
+    // The border is stitched into a copy on the worker
+    while (dem.getImagePtr() == original) {
+        test.loop.runOnce();
+    }
+    EXPECT_EQ(before, left.getBucket()->getDEMData().get(3, 0)) << "The tile itself is unchanged";
+    for (int32_t y = 0; y < 4; y++) {
+        EXPECT_EQ(right.getBucket()->getDEMData().get(0, y), dem.get(4, y));
+    }
+    EXPECT_NE(before, dem.get(4, 0));
+    EXPECT_FALSE(left.getBucket()->isPrepared());
+}
@@ -40,9 +40,18 @@ public:
 
     void setData(const std::shared_ptr<const std::string>&) override {}
 
+    std::size_t getMemoryUsage() const override { return memoryUsage; }
+
     util::SimpleIdentity uniqueId;
+    std::size_t memoryUsage = 0;
 };
 
+std::unique_ptr<VectorTileMock> makeTile(VectorTileTest& test, const OverscaledTileID& id, std::size_t memoryUsage) {
+    auto tile = std::make_unique<VectorTileMock>(id, "source", test.tileParameters, test.tileset);
+    tile->memoryUsage = memoryUsage;
+    return tile;
+}
+
 } // namespace
 
 TEST(TileCache, Smoke) {
@@ -96,3 +105,91 @@ TEST(TileCache, Issue15926) {
         EXPECT_FALSE(cache.has(id1));
     }
 }
+
+TEST(TileCache, MemoryBudget) {
+    VectorTileTest test;
+    {
+        auto budget = std::make_shared<TileCacheBudget>(1000);
+        TileCache cache(test.threadPool, 10, budget);
+        const OverscaledTileID id0(1, 0, 0);
+        const OverscaledTileID id1(1, 1, 0);
+        const OverscaledTileID id2(1, 0, 1);
+        const OverscaledTileID id3(1, 1, 1);
+
+        cache.add(id0, makeTile(test, id0, 100));
+        cache.add(id1, makeTile(test, id1, 600));
+        cache.add(id2, makeTile(test, id2, 200));
+        EXPECT_EQ(900u, cache.getStats().bytes);
+        EXPECT_EQ(900u, budget->getBytes());
+
+        // The heaviest of the least recently used tiles goes first
+        cache.add(id3, makeTile(test, id3, 300));
+        EXPECT_TRUE(cache.has(id0));
+        EXPECT_FALSE(cache.has(id1));
+        EXPECT_TRUE(cache.has(id2));
+        EXPECT_TRUE(cache.has(id3));
+        EXPECT_EQ(600u, budget->getBytes());
+
+        EXPECT_TRUE(cache.pop(id0));
+        EXPECT_FALSE(cache.pop(id1));
+        EXPECT_EQ(500u, budget->getBytes());
+
+        const auto stats = cache.getStats();
+        EXPECT_EQ(1u, stats.hits);
+        EXPECT_EQ(1u, stats.misses);
+        EXPECT_EQ(1u, stats.evictions);
+        EXPECT_EQ(2u, stats.tiles);
+        EXPECT_EQ(500u, stats.bytes);
+
+        cache.clear();
+        EXPECT_EQ(0u, budget->getBytes());
+    }
+}
+
+TEST(TileCache, SharedMemoryBudget) {
+    VectorTileTest test;
+    {
+        auto budget = std::make_shared<TileCacheBudget>(1000);
+        TileCache first(test.threadPool, 10, budget);
+        TileCache second(test.threadPool, 10, budget);
+        const OverscaledTileID id0(1, 0, 0);
+        const OverscaledTileID id1(1, 1, 0);
+        const OverscaledTileID id2(1, 0, 1);
+
+        first.add(id0, makeTile(test, id0, 400));
+        first.add(id1, makeTile(test, id1, 400));
+        EXPECT_EQ(2u, first.getStats().tiles);
+
+        // Over budget, but the second cache holds less than its share and keeps its tile
+        second.add(id2, makeTile(test, id2, 300));
+        EXPECT_TRUE(second.has(id2));
+        EXPECT_EQ(1100u, budget->getBytes());
+
+        // The first cache gives up tiles on its next update
+        first.setSize(10);
+        EXPECT_EQ(1u, first.getStats().tiles);
+        EXPECT_EQ(700u, budget->getBytes());
+    }
+}
+
+TEST(TileCache, SharedMemoryBudgetWithEmptyCache) {
+    VectorTileTest test;
+    {
+        auto budget = std::make_shared<TileCacheBudget>(1000);
+        TileCache first(test.threadPool, 10, budget);
+        TileCache second(test.threadPool, 10, budget);
+        const OverscaledTileID id0(1, 0, 0);
+        const OverscaledTileID id1(1, 1, 0);
+        const OverscaledTileID id2(1, 0, 1);
+
+        // The second cache holds nothing, so the first one gets the whole budget
+        first.add(id0, makeTile(test, id0, 400));
+        first.add(id1, makeTile(test, id1, 400));
+        first.add(id2, makeTile(test, id2, 400));
+        EXPECT_FALSE(first.has(id0));
+        EXPECT_TRUE(first.has(id1));
+        EXPECT_TRUE(first.has(id2));
+        EXPECT_EQ(800u, budget->getBytes());
+        EXPECT_EQ(0u, second.getStats().tiles);
+    }
+}
@@ -0,0 +1,54 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+std::string makeData() {
+    std::string data;
+    for (int i = 0; i < 10000; ++i) {
+        data += "feature " + std::to_string(i % 97) + ";";
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(Compression, RoundTrip) {
+    const std::string data = makeData();
+
+    for (const auto type :
+         {util::CodecType::Zlib, util::CodecType::Gzip, util::CodecType::Zstd, util::CodecType::Brotli}) {
+        SCOPED_TRACE(static_cast<int>(type));
+        const auto* codec = util::getCodec(type);
+        if (!codec) {
+            // Zstd and brotli are optional
+            EXPECT_TRUE(type == util::CodecType::Zstd || type == util::CodecType::Brotli);
+            continue;
+        }
+        EXPECT_EQ(type, codec->type());
+
+        const std::string compressed = codec->compress(data);
+        EXPECT_LT(compressed.size(), data.size());
+        EXPECT_EQ(data, codec->decompress(compressed));
+
+        EXPECT_THROW(codec->decompress(compressed.substr(0, compressed.size() / 2)), std::runtime_error);
+
+        if (codec->matches(compressed)) {
+            EXPECT_EQ(codec, util::detectCodec(compressed));
+        }
+    }
+}
+
+TEST(Compression, Detect) {
+    const std::string data = makeData();
+    EXPECT_EQ(nullptr, util::detectCodec(data));
+    EXPECT_EQ(util::getCodec(util::CodecType::Zlib), util::detectCodec(util::compress(data)));
+    EXPECT_EQ(util::getCodec(util::CodecType::Gzip),
+              util::detectCodec(util::compress(data, util::CompressionFormat::GZIP)));
+}
@@ -2,6 +2,8 @@
 
 #include <mbgl/test/util.hpp>
 
+#include <vector>
+
 using namespace mbgl;
 
 TEST(GridIndex, IndexesFeatures) {
@@ -55,3 +57,46 @@ TEST(GridIndex, IndexesFeaturesOverflow) {
     grid.insert(0, {{4500, 4500}, {4900, 4900}});
     EXPECT_EQ(grid.query({{4000, 4000}, {5000, 5000}}), (std::vector<int16_t>{0}));
 }
+
+TEST(GridIndex, HitTestPredicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+    grid.insert(1, {{50, 50}, 10});
+
+    EXPECT_TRUE(grid.hitTest({{0, 0}, {10, 20}}, [](int16_t key) { return key == 0; }));
+    EXPECT_FALSE(grid.hitTest({{0, 0}, {10, 20}}, [](int16_t key) { return key == 1; }));
+    EXPECT_TRUE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 1; }));
+    EXPECT_FALSE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 0; }));
+}
+
+TEST(GridIndex, HitTestAny) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+    grid.insert(1, {{60, 60}, 15});
+
+    using Circles = std::vector<GridIndex<int16_t>::BCircle>;
+    EXPECT_FALSE(grid.hitTestAny(Circles{}));
+    EXPECT_FALSE(grid.hitTestAny(Circles{{{20, 20}, 5}, {{30, 25}, 5}, {{40, 30}, 5}}));
+    EXPECT_TRUE(grid.hitTestAny(Circles{{{20, 20}, 5}, {{30, 30}, 5}, {{40, 40}, 5}, {{50, 50}, 5}}));
+    EXPECT_TRUE(grid.hitTestAny(Circles{{{20, 40}, 5}, {{10, 30}, 5}}));
+    EXPECT_FALSE(grid.hitTestAny(Circles{{{-50, -50}, 5}, {{150, 150}, 5}}));
+
+    // Circles outside of the grid don't hit elements overlapping its edges
+    grid.insert(2, {{90, 90}, {120, 120}});
+    EXPECT_FALSE(grid.hitTestAny(Circles{{{110, 110}, 5}}));
+    EXPECT_TRUE(grid.hitTestAny(Circles{{{110, 110}, 5}, {{95, 95}, 2}}));
+
+    // A circle covering the whole grid hits everything
+    EXPECT_TRUE(grid.hitTestAny(Circles{{{50, 50}, 200}}));
+
+    // Longer than fits on the stack
+    Circles line;
+    for (int i = 0; i < 100; ++i) {
+        line.push_back({{i * 0.5f + 10, 80}, 1});
+    }
+    EXPECT_FALSE(grid.hitTestAny(line));
+    line.push_back({{60, 60}, 1});
+    EXPECT_TRUE(grid.hitTestAny(line));
+    EXPECT_TRUE(grid.hitTestAny(line, [](int16_t key) { return key == 1; }));
+    EXPECT_FALSE(grid.hitTestAny(line, [](int16_t key) { return key == 0; }));
+}
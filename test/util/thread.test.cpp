@@ -5,6 +5,7 @@
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/timer.hpp>
 
 #include <atomic>
@@ -477,3 +478,65 @@ TEST(Thread, TaggedPools) {
     // Same for queue 2
     ASSERT_TRUE(totalRuns2 == runCount2);
 }
+
+TEST(Thread, WorkStealingPoolWaitRecursiveAdd) {
+    auto pool = std::make_shared<ThreadPool>(SchedulerStrategy::WorkStealing);
+    EXPECT_EQ(SchedulerStrategy::WorkStealing, pool->getStrategy());
+
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 100; ++i) {
+        pool->schedule([&] {
+            // Tasks scheduled from a worker land in its own deque and may be stolen by the others
+            for (int j = 0; j < 10; ++j) {
+                pool->schedule([&] { executed++; });
+            }
+            executed++;
+        });
+    }
+
+    pool->waitForEmpty();
+    EXPECT_EQ(1100, executed);
+}
+
+TEST(Thread, WorkStealingTaggedWait) {
+    auto pool = std::make_shared<ThreadPool>(SchedulerStrategy::WorkStealing);
+    TaggedScheduler poolTag1{pool, {}};
+    TaggedScheduler poolTag2{pool, {}};
+
+    std::atomic<bool> stopTasks1{false};
+    std::atomic<bool> stopTasks2{false};
+    std::atomic<size_t> runCount1{0};
+    std::atomic<size_t> runCount2{0};
+
+    for (auto i = 0; i < 50; i++) {
+        poolTag1.schedule(makeCounterThread(poolTag1, &stopTasks1, &runCount1));
+        poolTag2.schedule(makeCounterThread(poolTag2, &stopTasks2, &runCount2));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Waiting on one tag must not wait for the other one
+    stopTasks1 = true;
+    poolTag1.waitForEmpty();
+    const auto totalRuns1 = runCount1.load();
+    EXPECT_LT(0u, runCount2.load());
+
+    stopTasks2 = true;
+    poolTag2.waitForEmpty();
+    ASSERT_EQ(totalRuns1, runCount1);
+}
+
+TEST(Thread, WorkStealingPoolWaitException) {
+    const auto id = util::SimpleIdentity{};
+    auto pool = std::make_shared<ThreadPool>(SchedulerStrategy::WorkStealing);
+
+    std::atomic<int> caught{0};
+    pool->setExceptionHandler([&](const auto) { caught++; });
+
+    constexpr int threadCount = 3;
+    for (int i = 0; i < threadCount; ++i) {
+        pool->schedule(id, [=] { throw std::runtime_error("test"); });
+    }
+
+    pool->waitForEmpty(id);
+    EXPECT_EQ(threadCount, caught);
+}
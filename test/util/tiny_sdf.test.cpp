@@ -0,0 +1,85 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+constexpr double radius = 8;
+constexpr double cutoff = 0.25;
+
+// A raster with solid, empty and partially covered pixels, like the edges of a glyph
+AlphaImage makeRaster(Size size) {
+    AlphaImage raster(size);
+    for (std::size_t i = 0; i < raster.bytes(); ++i) {
+        raster.data[i] = i % 3 == 0 ? 255 : i % 5 == 0 ? static_cast<uint8_t>(i * 37) : 0;
+    }
+    return raster;
+}
+
+void expectSameSDF(const AlphaImage& raster) {
+    const AlphaImage expected = util::transformRasterToSDFScalar(raster, radius, cutoff);
+    const AlphaImage actual = util::transformRasterToSDF(raster, radius, cutoff);
+    ASSERT_EQ(expected.size, actual.size);
+    EXPECT_EQ(expected, actual) << raster.size.width << "x" << raster.size.height;
+}
+
+} // namespace
+
+TEST(TinySDF, Empty) {
+    expectSameSDF(AlphaImage({0, 0}));
+    expectSameSDF(AlphaImage({0, 8}));
+    expectSameSDF(AlphaImage({8, 0}));
+}
+
+TEST(TinySDF, SingleRowOrColumn) {
+    for (const uint32_t length : {1u, 2u, 3u, 4u, 5u, 17u, 64u, 65u}) {
+        expectSameSDF(makeRaster({1, length}));
+        expectSameSDF(makeRaster({length, 1}));
+    }
+}
+
+TEST(TinySDF, Solid) {
+    AlphaImage raster({24, 24});
+    raster.fill(255);
+    expectSameSDF(raster);
+    raster.fill(0);
+    expectSameSDF(raster);
+}
+
+TEST(TinySDF, Uneven) {
+    // The float transform computes four rows at a time, and falls back beyond 64 pixels
+    for (const Size size : {Size{5, 7}, Size{7, 5}, Size{30, 30}, Size{63, 64}, Size{64, 64}, Size{65, 20}}) {
+        expectSameSDF(makeRaster(size));
+    }
+}
+
+TEST(TinySDF, Glyphs) {
+    // Real glyph shapes, transformed in one batch so that the temporary buffers are reused
+    // across rasters of different sizes
+    const std::vector<Glyph> glyphs = parseGlyphPBF(GlyphRange{0, 255, GlyphIDType::FontPBF},
+                                                    util::read_file("test/fixtures/resources/glyphs.pbf"));
+    ASSERT_FALSE(glyphs.empty());
+
+    std::vector<AlphaImage> sdfs;
+    sdfs.reserve(glyphs.size());
+    for (const Glyph& glyph : glyphs) {
+        sdfs.push_back(glyph.bitmap.clone());
+    }
+    std::vector<AlphaImage*> rasters;
+    for (AlphaImage& sdf : sdfs) {
+        rasters.push_back(&sdf);
+    }
+    util::transformRastersToSDF(rasters, radius, cutoff);
+
+    for (std::size_t i = 0; i < glyphs.size(); ++i) {
+        const AlphaImage expected = util::transformRasterToSDFScalar(glyphs[i].bitmap, radius, cutoff);
+        ASSERT_EQ(expected.size, sdfs[i].size);
+        EXPECT_EQ(expected, sdfs[i]) << "glyph " << glyphs[i].id.complex.code;
+    }
+}